@@ -1,5 +1,5 @@
 // ===================================================================================
-// Basic BME280 Temperature, Pressure and Humidity Sensor Functions           * v1.0 *
+// Basic BME280 Temperature, Pressure and Humidity Sensor Functions           * v1.1 *
 // ===================================================================================
 //
 // Functions available:
@@ -11,6 +11,24 @@
 // BME_getHumidity()        Read humidity (value "4697" means 46.97 %RH)
 // BME_adjustTemp(a)        Set user temperature adjustment ("-127" means -1.27 °C)
 //
+// BME_readAll(d)           Read temperature, pressure and humidity at once into data (*d)
+// BME_trigger()            Start single measurement (forced mode), returns immediately
+// BME_busy()               Check if measurement is still running (0: finished)
+// BME_wait()               Wait for measurement to finish
+// BME_sample(d)            Trigger single measurement, wait and read all values into (*d)
+//
+// Notes:
+// ------
+// - BME_readAll() reads all data registers (0xF7..0xFE) in one I2C transaction and
+//   compensates temperature, pressure and humidity with one fresh fine temperature.
+//   The single BME_get...() functions read their register only, pressure and humidity
+//   use the fine temperature of the last temperature reading.
+// - In normal mode (BME_FORCED = 0) the sensor measures continuously. In forced mode
+//   the sensor sleeps and makes a single measurement after each BME_trigger(). The
+//   results are ready after max. BME_MEAS_TIME microseconds; the MCU can sleep in the
+//   meantime, e.g.:  BME_trigger(); <sleep for BME_MEAS_TIME>; BME_readAll(&data);
+// - Oversampling, IIR filter and standby time are set with BME_init() (see below).
+//
 // References:
 // -----------
 // Adafruit:                https://github.com/adafruit/Adafruit_BME280_Library
@@ -34,6 +52,24 @@ extern "C" {
 #define BME_BOOT_TIME         0       // BME280 boot up time in milliseconds
 #define BME_ADDR              0x76    // BME280 I2C device address (0x76 or 0x77)
 
+// BME280 Measurement Settings
+#define BME_FORCED            0       // 0: normal mode (continuous), 1: forced mode (single)
+#define BME_OSRS_T            4       // temperature oversampling (0: skip, 1..5: 1x..16x)
+#define BME_OSRS_P            4       // pressure oversampling    (0: skip, 1..5: 1x..16x)
+#define BME_OSRS_H            4       // humidity oversampling    (0: skip, 1..5: 1x..16x)
+#define BME_FILTER            0       // IIR filter coefficient   (0: off,  1..4: 2..16)
+#define BME_STANDBY           0       // normal mode standby (0: 0.5ms, 1: 62.5ms, 2: 125ms,
+                                      // 3: 250ms, 4: 500ms, 5: 1s, 6: 10ms, 7: 20ms)
+
+// BME280 Register Values and Max Measurement Time in Microseconds (from settings)
+#define BME_CTRL_HUM          (BME_OSRS_H)
+#define BME_CTRL_MEAS         ((BME_OSRS_T << 5) | (BME_OSRS_P << 2) | (BME_FORCED ? 0 : 3))
+#define BME_CONFIG            ((BME_STANDBY << 5) | (BME_FILTER << 2))
+#define BME_OS(n)             ((n) ? 1 << ((n) - 1) : 0)
+#define BME_MEAS_TIME         (1250 + 2300 * BME_OS(BME_OSRS_T) \
+                              + (BME_OSRS_P ? 2300 * BME_OS(BME_OSRS_P) + 575 : 0) \
+                              + (BME_OSRS_H ? 2300 * BME_OS(BME_OSRS_H) + 575 : 0))
+
 // BME280 Calibration Data Registers
 #define BME_REG_CALIB_T1      0x88    // temperature
 #define BME_REG_CALIB_T2      0x8A
@@ -95,6 +131,12 @@ typedef struct {
   int16_t  H5;
 } BME_CALIB_TYPE;
 
+typedef struct {
+  int32_t  temp;                      // temperature ("2391" means 23.91 °C)
+  uint32_t pressure;                  // pressure ("101945" means 1019.45 hPa)
+  uint32_t humidity;                  // humidity ("4697" means 46.97 %RH)
+} BME_DATA_TYPE;
+
 // BME280 Functions
 void BME_init(void);
 void BME_sleep(uint8_t slp);
@@ -102,6 +144,11 @@ int32_t BME_getTemp(void);
 uint32_t BME_getPressure(void);
 uint32_t BME_getHumidity(void);
 void BME_adjustTemp(int32_t adjust);
+void BME_readAll(BME_DATA_TYPE* data);
+void BME_trigger(void);
+uint8_t BME_busy(void);
+void BME_wait(void);
+void BME_sample(BME_DATA_TYPE* data);
 
 #ifdef __cplusplus
 };
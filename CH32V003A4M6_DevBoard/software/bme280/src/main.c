@@ -1,6 +1,6 @@
 // ===================================================================================
 // Project:   Example for CH32V003
-// Version:   v1.0
+// Version:   v1.2
 // Year:      2023
 // Author:    Stefan Wagner
 // Github:    https://github.com/wagiminator
@@ -31,6 +31,7 @@
 // ===================================================================================
 #include <bme280.h>                 // BME280 sensor functions
 #include <debug_serial.h>           // serial debug functions
+#include <print.h>                  // print functions (fixed-point printf)
 
 
 // ===================================================================================
@@ -43,12 +44,14 @@ int main(void) {
 
   // Loop
   while(1) {
-    int32_t  temp  = BME_getTemp();
-    uint32_t press = BME_getPressure();
-    uint32_t humid = BME_getHumidity();
-    DEBUG_printf("Temperature: %d.%02d DegC\n", temp / 100, temp % 100);
-    DEBUG_printf("Pressure:    %d.%02d hPa\n", press / 100, press % 100);
-    DEBUG_printf("Humidity:    %d.%02d %%RH\n", humid / 100, humid % 100);
+    BME_DATA_TYPE data;
+    BME_readAll(&data);             // read all values in one transaction
+    int32_t  temp  = data.temp;
+    uint32_t press = data.pressure;
+    uint32_t humid = data.humidity;
+    printF(DEBUG_write, "Temperature: %.2d DegC\n", temp);
+    printF(DEBUG_write, "Pressure:    %.2d hPa\n", press);
+    printF(DEBUG_write, "Humidity:    %.2d %%RH\n", humid);
     DLY_ms(1000);
   }
 }
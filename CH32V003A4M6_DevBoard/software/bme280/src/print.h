@@ -0,0 +1,78 @@
+// ===================================================================================
+// Basic PRINT Functions                                                      * v1.2 *
+// ===================================================================================
+//
+// Functions available:
+// --------------------
+// printF(putchar, f, ...)  Uses printf (supports %s, %c, %d, %u, %x, %b, %02d, %.2d, %%)
+// printD(putchar, n)       Print decimal value as string via putchar function
+// printFix(putchar, n, d)  Print fixed-point value n/10^d with d decimals via putchar
+// printW(putchar, n)       Print 32-bit hex word value as string via putchar function
+// printH(putchar, n)       Print 16-bit hex half-word value as string via putchar function
+// printB(putchar, n)       Print  8-bit hex byte value as string via putchar function
+// printS(putchar, s)       Print string via putchar function
+// println(putchar, s)      Print string with newline via putchar function
+//
+// printBufF(putbuf, f, ...) Uses printf, output is passed to putbuf function at once
+// printBufD(putbuf, n)     Print decimal value as string via putbuf function
+// printBufS(putbuf, s)     Print string via putbuf function
+//
+// sprintF(buf, f, ...)     Uses printf, output is written into buffer, returns length
+// sprintD(buf, n)          Write unsigned decimal value into buffer, returns length
+// sprintI(buf, n)          Write signed decimal value into buffer, returns length
+// sprintX(buf, n, d)       Write value as hex with d digits into buffer, returns length
+// sprintFix(buf, n, d)     Write fixed-point value n/10^d into buffer (d <= 9, max 12 chars)
+//
+// Notes:
+// ------
+// - putchar is a function that outputs a single character: void putchar(char c),
+//   putbuf is a function that outputs a number of bytes at once:
+//   void putbuf(const uint8_t* buf, uint16_t len).
+// - The sprint functions (except sprintF) don't terminate the string.
+// - %.2d prints a fixed-point value with two decimal places, e.g. 2345 -> "23.45",
+//   -5 -> "-0.05". This replaces the usual "%d.%02d" with separate division and
+//   modulo. Field width and zero padding can be combined, e.g. %07.3d.
+// - Decimal conversion uses a two-digit lookup table with reciprocal multiplication
+//   on cores with hardware multiplier, and a division by 10 by shifts and additions
+//   otherwise. No hardware divider is needed.
+// - The field width includes the sign as in C: %05d prints -12 as "-0012". v1.1
+//   padded the digits only and printed "-00012".
+// - A host-side test (output compared with the C library's printf) and benchmark
+//   is in CH32V003F4P6_DevBoard/software/oled_terminal/test.
+//
+// 2023 by Stefan Wagner:   https://github.com/wagiminator
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+// Print Parameters
+#define PRINT_BUF_SIZE  32        // buffer size of printBufF on stack
+
+// Print Functions
+void printF(void (*putchar) (char c), const char *format, ...);
+void printD(void (*putchar) (char c), uint32_t value);
+void printFix(void (*putchar) (char c), int32_t value, uint8_t dec);
+void printB(void (*putchar) (char c), uint8_t value);
+void printH(void (*putchar) (char c), uint16_t value);
+void printW(void (*putchar) (char c), uint32_t value);
+void printS(void (*putchar) (char c), const char* str);
+void println(void (*putchar) (char c), const char* str);
+
+void printBufF(void (*putbuf) (const uint8_t* buf, uint16_t len), const char *format, ...);
+void printBufD(void (*putbuf) (const uint8_t* buf, uint16_t len), uint32_t value);
+void printBufS(void (*putbuf) (const uint8_t* buf, uint16_t len), const char* str);
+
+uint16_t sprintF(char* buf, const char *format, ...);
+uint8_t sprintD(char* buf, uint32_t value);
+uint8_t sprintI(char* buf, int32_t value);
+uint8_t sprintX(char* buf, uint32_t value, uint8_t digits);
+uint8_t sprintFix(char* buf, int32_t value, uint8_t dec);
+
+#ifdef __cplusplus
+};
+#endif
@@ -1,5 +1,5 @@
 // ===================================================================================
-// Basic FLASH Functions for CH32V003                                         * v1.2 *
+// Basic FLASH Functions for CH32V003                                         * v1.3 *
 // ===================================================================================
 //
 // Functions available:
@@ -11,6 +11,9 @@
 // FLASH_read(a)            Read 16-bit data from FLASH address (a)
 // FLASH_write(a, d)        Write 16-bit data (d) to FLASH address (a)
 // FLASH_PAGE_erase(p)      Erase CODE FLASH page (0..255, 64 bytes each)
+// FLASH_PAGE_write(p, b)   Write buffer (b, 16 words) to erased CODE FLASH page (p)
+// FLASH_PAGE_update(p, b)  Erase CODE FLASH page (p) and write buffer (b, 16 words)
+// FLASH_writeBuffer(a,b,n) Write (n) bytes from buffer (b) to CODE FLASH address (a)
 //
 // FLASH_END_erase()        Erase last page of CODE FLASH (64 bytes)
 // FLASH_END_read(a)        Read 16-bit data from CODE FLASH END address (a)
@@ -49,6 +52,14 @@
 //   FLASH_OB_protect(), FLASH_OB_unprotect(), FLASH_OB_RESET2GPIO() and 
 //   FLASH_OB_DEFAULT().
 // - FLASH areas must be erased before being overwritten.
+// - FLASH_PAGE_write(p, b) and FLASH_PAGE_update(p, b) program a whole page in one
+//   burst using the fast page programming mode, which takes about as long as
+//   programming a single half-word with FLASH_write(a, d). The buffer must be 32-bit
+//   aligned (e.g. uint32_t buf[16]).
+// - FLASH_writeBuffer(a, b, n) writes any number of bytes at any address. Every
+//   affected page is read into a 64-byte page buffer on the stack, merged with the new
+//   data, erased and written back in one burst. Pages whose content doesn't change are
+//   not touched at all, which saves time and erase cycles.
 // - The addresses (a) in FLASH_END_read(a) and FLASH_END_write(a, d) are counted
 //   from the end of the CODE FLASH area meaning these functions can be used to store
 //   user data without affecting the firmware code (if there's enough space left).
@@ -64,7 +75,10 @@ extern "C" {
 #include "ch32v003.h"
 
 void FLASH_write(uint32_t addr, uint16_t data);
-void FLASH_PAGE_erase(uint8_t page);
+void FLASH_PAGE_erase(uint16_t page);
+void FLASH_PAGE_write(uint16_t page, const uint32_t* buf);
+void FLASH_PAGE_update(uint16_t page, const uint32_t* buf);
+void FLASH_writeBuffer(uint32_t addr, const uint8_t* buf, uint16_t len);
 void FLASH_OB_write(uint32_t addr, uint8_t data);
 void FLASH_OB_protect(void);
 void FLASH_OB_unprotect(void);
@@ -76,6 +90,7 @@ void FLASH_OB_DATA_write(uint16_t data);
 #define FLASH_BOOT_BASE         0x1FFFF000
 #define FLASH_CODE_BASE         FLASH_BASE
 #define FLASH_PAGE_BASE(p)      (FLASH_BASE + ((uint16_t)(p) << 6))
+#define FLASH_PAGE_SIZE         64
 
 #define FLASH_read(a)           (*(__IO uint16_t *)(a))
 #define FLASH_END_erase()       FLASH_PAGE_erase(255)
@@ -0,0 +1,226 @@
+// ===================================================================================
+// Key/Value Store in CODE FLASH for CH32V003                                 * v1.1 *
+// ===================================================================================
+// 2024 by Stefan Wagner:   https://github.com/wagiminator
+
+#include "flash_kv.h"
+
+#define KV_ERASED       0xE339              // value of erased FLASH half-word
+#define KV_PHDR         4                   // page header: sequence number, complement
+#define KV_SIZE(len)    (4 + (((len) + 1) & ~1)) // record: header, value, CRC-16
+#define KV_NONE         0xFF                // no record at this offset
+
+#define KV_page(p)      FLASH_PAGE_BASE(KV_FIRST + (p))
+#define KV_hw(a)        (*(const uint16_t*)(a))
+#define KV_next(p)      (((p) + 1 < KV_PAGES) ? (p) + 1 : 0)
+
+// Page states
+#define KV_EMPTY        0                   // erased
+#define KV_USED         1                   // valid page header
+#define KV_BAD          2                   // interrupted erase or header write
+
+static uint8_t  KV_head;                    // page with the latest records
+static uint16_t KV_hseq;                    // sequence number of head page
+static uint8_t  KV_hofs;                    // offset of free space in head page
+
+// Calculate CRC-16 (CCITT) of (n) bytes at (ptr)
+static uint16_t KV_crc(const uint8_t* ptr, uint8_t n) {
+  uint16_t crc = 0xFFFF;
+  while(n--) {
+    crc ^= (uint16_t)*ptr++ << 8;
+    for(uint8_t j=8; j; j--) crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : (crc << 1);
+  }
+  return crc;
+}
+
+// Get state of page (p)
+static uint8_t KV_state(uint8_t p) {
+  uint16_t seq = KV_hw(KV_page(p));
+  uint16_t inv = KV_hw(KV_page(p) + 2);
+  if((seq == KV_ERASED) && (inv == KV_ERASED)) return KV_EMPTY;
+  return ((uint16_t)(seq ^ inv) == 0xFFFF) ? KV_USED : KV_BAD;
+}
+
+// Check if page (p) is completely erased
+static uint8_t KV_blank(uint8_t p) {
+  const uint32_t* ptr = (const uint32_t*)KV_page(p);
+  for(uint8_t i=FLASH_PAGE_SIZE/4; i; i--)
+    if(*ptr++ != (((uint32_t)KV_ERASED << 16) | KV_ERASED)) return 0;
+  return 1;
+}
+
+// Erase page (p)
+static void KV_erase(uint8_t p) {
+  FLASH_unlock();
+  FLASH_PAGE_erase(KV_FIRST + p);
+  FLASH_lock();
+}
+
+// Get value length of record at offset (ofs) in page at (base), KV_NONE if no record
+static uint8_t KV_len(uint32_t base, uint8_t ofs) {
+  uint16_t hdr;
+  if(ofs > FLASH_PAGE_SIZE - KV_SIZE(0)) return KV_NONE;  // no room for a record
+  hdr = KV_hw(base + ofs);
+  if((hdr == KV_ERASED) || ((hdr >> 8) > KV_VALUE_MAX)
+    || (ofs + KV_SIZE(hdr >> 8) > FLASH_PAGE_SIZE)) return KV_NONE;
+  return hdr >> 8;
+}
+
+// Check CRC of record at (a) with value length (len)
+static uint8_t KV_check(uint32_t a, uint8_t len) {
+  uint8_t n = KV_SIZE(len) - 2;
+  return(KV_hw(a + n) == KV_crc((const uint8_t*)a, n));
+}
+
+// Find latest valid record of key, returns its address (0 if not found)
+static uint32_t KV_find(uint8_t key) {
+  uint8_t p = KV_head;
+  for(uint8_t n=KV_PAGES; n; n--) {                       // newest to oldest page
+    if(KV_state(p) == KV_USED) {
+      uint32_t base  = KV_page(p);
+      uint32_t found = 0;
+      uint8_t  ofs, len;
+      for(ofs=KV_PHDR; (len = KV_len(base, ofs)) != KV_NONE; ofs += KV_SIZE(len)) {
+        if(((uint8_t)KV_hw(base + ofs) == key) && KV_check(base + ofs, len))
+          found = base + ofs;                             // later record in page wins
+      }
+      if(found) return found;
+    }
+    p = p ? p - 1 : KV_PAGES - 1;
+  }
+  return 0;
+}
+
+// Append record to head page
+static uint8_t KV_append(uint8_t key, const uint8_t* buf, uint8_t len) {
+  uint16_t rec[KV_SIZE(KV_VALUE_MAX) / 2];
+  uint32_t a = KV_page(KV_head) + KV_hofs;
+  uint8_t  n = KV_SIZE(len) / 2 - 1;                      // half-words before CRC
+  uint8_t  i;
+
+  if(KV_hofs + KV_SIZE(len) > FLASH_PAGE_SIZE) return 0;  // doesn't fit
+  rec[0]   = key | ((uint16_t)len << 8);                  // assemble record
+  for(i=0; i<len; i++) ((uint8_t*)&rec[1])[i] = buf[i];
+  if(len & 1) ((uint8_t*)&rec[1])[len] = 0;               // padding byte
+  rec[n]   = KV_crc((const uint8_t*)rec, n << 1);
+  KV_hofs += KV_SIZE(len);
+
+  FLASH_unlock();                                         // write header first,
+  for(i=0; i<=n; i++) FLASH_write(a + (i << 1), rec[i]);  // CRC last
+  FLASH_lock();
+  for(i=0; i<=n; i++) if(KV_hw(a + (i << 1)) != rec[i]) return 0; // verify
+  return 1;
+}
+
+// Continue with next page (must not hold records)
+static uint8_t KV_open(void) {
+  uint8_t p = KV_next(KV_head);
+  if(KV_state(p) == KV_USED) return 0;                    // no free page
+  if(!KV_blank(p)) KV_erase(p);
+  KV_hseq++;
+  FLASH_unlock();
+  FLASH_write(KV_page(p), KV_hseq);                       // write page header
+  FLASH_write(KV_page(p) + 2, ~KV_hseq);
+  FLASH_lock();
+  KV_head = p;
+  KV_hofs = KV_PHDR;
+  return 1;
+}
+
+// Keep two free pages ahead of the head page by moving the current records of the
+// oldest page to the head page and erasing it (the second free page takes the
+// records if the head page overflows after an interrupted compaction)
+static uint8_t KV_reserve(void) {
+  for(uint8_t n=KV_PAGES; n; n--) {
+    uint8_t  p = KV_next(KV_head);
+    uint8_t  o = KV_next(p);
+    uint32_t base;
+    uint8_t  ofs, len;
+    if(KV_state(p) == KV_USED) o = p;                     // oldest page right ahead
+    else if((o == KV_head) || (KV_state(o) != KV_USED)) return 1; // enough free pages
+    base = KV_page(o);
+    for(ofs=KV_PHDR; (len = KV_len(base, ofs)) != KV_NONE; ofs += KV_SIZE(len)) {
+      uint32_t a = base + ofs;
+      if(!len || (KV_find((uint8_t)KV_hw(a)) != a)) continue; // outdated or deleted
+      if((KV_hofs + KV_SIZE(len) > FLASH_PAGE_SIZE) && !KV_open()) return 0;
+      if(!KV_append((uint8_t)KV_hw(a), (const uint8_t*)(a + 2), len)) return 0;
+    }
+    KV_erase(o);                                          // all records moved
+  }
+  return 0;
+}
+
+// Scan store
+void KV_init(void) {
+  uint32_t base;
+  uint8_t  p, ofs, len, found = 0;
+  KV_head = KV_PAGES - 1;
+  KV_hseq = 0;
+  KV_hofs = FLASH_PAGE_SIZE;                              // first write opens page 0
+  for(p=0; p<KV_PAGES; p++) {
+    uint8_t state = KV_state(p);
+    if(state == KV_BAD) KV_erase(p);                      // interrupted erase/open
+    else if(state == KV_USED) {
+      uint16_t seq = KV_hw(KV_page(p));
+      if(!found || ((int16_t)(seq - KV_hseq) > 0)) {      // find latest page
+        KV_head = p;
+        KV_hseq = seq;
+        found   = 1;
+      }
+    }
+  }
+  if(!found) return;
+
+  // Find free space in head page
+  base = KV_page(KV_head);
+  for(ofs=KV_PHDR; (len = KV_len(base, ofs)) != KV_NONE; ofs += KV_SIZE(len));
+  KV_hofs = ((ofs <= FLASH_PAGE_SIZE - 2) && (KV_hw(base + ofs) != KV_ERASED))
+          ? FLASH_PAGE_SIZE : ofs;                        // damaged record: page full
+  KV_reserve();                                           // finish interrupted compaction
+}
+
+// Read value of key into buffer, returns length of value
+uint8_t KV_read(uint8_t key, void* buf, uint8_t len) {
+  uint32_t a = KV_find(key);
+  uint8_t  n;
+  if(!a) return 0;
+  n = KV_hw(a) >> 8;
+  if(len > n) len = n;
+  for(uint8_t i=0; i<len; i++) ((uint8_t*)buf)[i] = ((const uint8_t*)a)[i + 2];
+  return n;
+}
+
+// Write value of key from buffer
+uint8_t KV_write(uint8_t key, const void* buf, uint8_t len) {
+  uint32_t a;
+  uint8_t  i;
+
+  // Skip if the value didn't change
+  if(len > KV_VALUE_MAX) return 0;
+  a = KV_find(key);
+  if(a) {
+    if((KV_hw(a) >> 8) == len) {
+      for(i=0; (i < len) && (((const uint8_t*)a)[i + 2] == ((const uint8_t*)buf)[i]); i++);
+      if(i == len) return 1;
+    }
+  }
+  else if(!len) return 1;                                 // delete non-existing key
+
+  // Append record, continue with next page if head page is full
+  for(i=KV_PAGES; i; i--) {
+    if(KV_hofs + KV_SIZE(len) <= FLASH_PAGE_SIZE) return KV_append(key, buf, len);
+    if(!KV_open() || !KV_reserve()) return 0;
+  }
+  return 0;                                               // store is full
+}
+
+// Delete key
+uint8_t KV_delete(uint8_t key) {
+  return KV_write(key, 0, 0);
+}
+
+// Erase all pages of the store
+void KV_format(void) {
+  for(uint8_t i=0; i<KV_PAGES; i++) KV_erase(i);
+  KV_init();
+}
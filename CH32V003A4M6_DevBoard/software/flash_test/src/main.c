@@ -1,6 +1,6 @@
 // ===================================================================================
 // Project:   FLASH Demo for CH32V003
-// Version:   v1.1
+// Version:   v1.2
 // Year:      2023
 // Author:    Stefan Wagner
 // Github:    https://github.com/wagiminator
@@ -10,7 +10,8 @@
 //
 // Description:
 // ------------
-// FLASH, Option Bytes (OB) and Electronic Signature (ESIG) demo.
+// FLASH, Option Bytes (OB) and Electronic Signature (ESIG) demo. A reset counter is
+// kept in the key/value store in CODE FLASH, the time of each write is measured.
 //
 // References:
 // -----------
@@ -32,8 +33,11 @@
 #include <system.h>                           // system functions
 #include <gpio.h>                             // GPIO functions
 #include <flash.h>                            // FLASH functions
+#include <flash_kv.h>                         // key/value store in FLASH
 #include <debug_serial.h>                     // serial DEBUG functions
 
+#define KEY_RESETS    1                       // key of reset counter in store
+
 // ===================================================================================
 // Main Function
 // ===================================================================================
@@ -53,6 +57,16 @@ int main(void) {
   FLASH_END_write(2, 0xFACE);                 // ...this data remains after reset
   FLASH_lock();                               // lock flash
 
+  // Count resets in key/value store
+  uint32_t resets = 0;
+  uint32_t ticks;
+  KV_init();                                  // scan key/value store
+  KV_read(KEY_RESETS, &resets, sizeof(resets)); // read reset counter
+  resets++;                                   // increase it...
+  ticks = STK->CNT;
+  KV_write(KEY_RESETS, &resets, sizeof(resets)); // ...and write it back
+  ticks = STK->CNT - ticks;                   // time of write in system ticks
+
   // Loop
   while(1) {
     DLY_ms(1000);
@@ -77,6 +91,14 @@ int main(void) {
     DEBUG_printH(FLASH_END_read(2));
     DEBUG_newline();
 
+    DEBUG_print("RESET COUNTER (KV):  ");     // print reset counter from store
+    DEBUG_printD(resets);
+    DEBUG_newline();
+
+    DEBUG_print("KV WRITE TIME:       ");     // print time of one store write
+    DEBUG_printD(ticks / DLY_US_TIME);
+    DEBUG_println(" us");
+
     DEBUG_print("FLASH CAPACITY:      ");     // print flash capacity
     DEBUG_printD(ESIG->ESIG_FLACAP);
     DEBUG_println(" KB");
@@ -1,5 +1,5 @@
 // ===================================================================================
-// Basic I2C Master Functions for CH32V003                                    * v1.1 *
+// Basic I2C Master Functions for CH32V003                                    * v1.2 *
 // ===================================================================================
 //
 // Functions available:
@@ -9,9 +9,17 @@
 // I2C_write(b)             I2C transmit one data byte via I2C
 // I2C_read(ack)            I2C receive one data byte (set ack=0 for last byte)
 // I2C_stop()               I2C stop transmission
+// I2C_poll(addr)           Address slave and stop, returns 1 if slave acknowledged
 //
 // I2C_writeBuffer(buf,len) Send buffer (*buf) with length (len) via I2C and stop
 // I2C_readBuffer(buf,len)  Read buffer (*buf) with length (len) via I2C and stop
+// I2C_readDMA(a,buf,len)   Start read from slave address (a) and receive (len) bytes
+//                          to buffer (*buf) via DMA and stop
+//
+// I2C_poll() always addresses the slave in write direction. It can be used to check
+// if a device is present or, for EEPROMs, if an internal write cycle is finished
+// (ACK polling). I2C_readDMA() uses DMA channel 7 and waits until all bytes are
+// received.
 //
 // I2C pin mapping (set below in I2C parameters):
 // ----------------------------------------------
@@ -40,9 +48,11 @@ void I2C_start(uint8_t addr);   // I2C start transmission, addr must contain R/W
 void I2C_stop(void);            // I2C stop transmission
 void I2C_write(uint8_t data);   // I2C transmit one data byte via I2C
 uint8_t I2C_read(uint8_t ack);  // I2C receive one data byte from the slave
+uint8_t I2C_poll(uint8_t addr); // I2C address slave and stop, returns 1 on ACK
 
 void I2C_writeBuffer(uint8_t* buf, uint16_t len);
 void I2C_readBuffer(uint8_t* buf, uint16_t len);
+void I2C_readDMA(uint8_t addr, uint8_t* buf, uint16_t len);
 
 #ifdef __cplusplus
 };
@@ -4,7 +4,7 @@
 //
 // Description:
 // ------------
-// Blink built-in LED using millis counter.
+// Blink built-in LED using a periodic software timer of the tickless millis functions.
 
 #pragma once
 
@@ -43,7 +43,7 @@ void I2C_init(void) {
   #endif
   I2C1->CTLR1   = I2C_CTLR1_PE;                   // enable I2C
 
-  // Setup DMA Channel 5
+  // Setup DMA Channel 6
   RCC->AHBPCENR |= RCC_DMA1EN;                    // enable DMA module clock
   DMA1_Channel6->PADDR = (uint32_t)&I2C1->DATAR;  // peripheral address
   DMA1_Channel6->CFGR  = DMA_CFG6_MINC            // increment memory address
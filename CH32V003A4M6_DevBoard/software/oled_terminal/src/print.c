@@ -1,30 +1,235 @@
 // ===================================================================================
-// Basic PRINT Functions                                                      * v1.1 *
+// Basic PRINT Functions                                                      * v1.2 *
 // ===================================================================================
 // 2023 by Stefan Wagner:   https://github.com/wagiminator
 
 #include <stdarg.h>
 #include "print.h"
 
-// For BCD conversion
-const uint32_t DIVIDER[] = {1, 10, 100, 1000, 10000, 100000, 1000000,
-                            10000000, 100000000, 1000000000};
+// ===================================================================================
+// Number Formatting Core
+// ===================================================================================
 
-// Print decimal value (BCD conversion by substraction method)
-void printD(void (*putchar) (char c), uint32_t value) {
-  uint8_t digits   = 10;                    // print 10 digits
-  uint8_t leadflag = 0;                     // flag for leading spaces
-  while(digits--) {                         // for all digits
-    uint8_t digitval = 0;                   // start with digit value 0
-    uint32_t divider = DIVIDER[digits];     // read current divider
-    while(value >= divider) {               // if current divider fits into the value
-      leadflag = 1;                         // end of leading spaces
-      digitval++;                           // increase digit value
-      value -= divider;                     // decrease value by divider
+// For digit counting
+static const uint32_t DIVIDER[] = {1, 10, 100, 1000, 10000, 100000, 1000000,
+                                   10000000, 100000000, 1000000000};
+
+#if defined(__riscv_mul)
+// Two-digit lookup table (division by 100 is done by reciprocal multiplication)
+static const char DIGITS[] =
+  "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+  "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+  "8081828384858687888990919293949596979899";
+#endif
+
+// Convert unsigned value into decimal string (not terminated), returns length
+uint8_t sprintD(char* buf, uint32_t value) {
+  uint8_t len = 1;
+  while((len < 10) && (value >= DIVIDER[len])) len++;  // count digits
+  buf += len;                                     // digits are written backwards
+  #if defined(__riscv_mul)
+  while(value >= 100) {                           // two digits at once
+    uint32_t q = value / 100;
+    const char* d = DIGITS + ((value - q * 100) << 1);
+    *--buf = d[1];
+    *--buf = d[0];
+    value  = q;
+  }
+  if(value >= 10) {
+    const char* d = DIGITS + (value << 1);
+    *--buf = d[1];
+    *--buf = d[0];
+  }
+  else *--buf = value + '0';
+  #else
+  do {                                            // division by 10 by shift and add
+    uint32_t q = (value >> 1) + (value >> 2);     // q = value * 0.75
+    q += q >> 4;                                  // q = value * 0.797
+    q += q >> 8;                                  // q = value * 0.799997
+    q += q >> 16;                                 // q = value * 0.8
+    q >>= 3;                                      // q = value / 10 (or 1 less)
+    uint32_t r = value - ((q << 3) + (q << 1));   // remainder
+    if(r > 9) {                                   // correct estimation
+      q++;
+      r -= 10;
     }
-    if(!digits)  leadflag++;                // least digit has to be printed
-    if(leadflag) putchar(digitval + '0');   // print the digit
+    *--buf = r + '0';
+    value  = q;
+  } while(value);
+  #endif
+  return len;
+}
+
+// Convert signed value into decimal string (not terminated), returns length
+uint8_t sprintI(char* buf, int32_t value) {
+  if(value >= 0) return sprintD(buf, value);
+  *buf = '-';
+  return sprintD(buf + 1, -(uint32_t)value) + 1;
+}
+
+// Convert value into hex string with (digits) digits (not terminated), returns length
+uint8_t sprintX(char* buf, uint32_t value, uint8_t digits) {
+  uint8_t i = digits;
+  while(i--) {
+    uint8_t nibble = value & 0x0f;
+    buf[i] = (nibble <= 9) ? ('0' + nibble) : ('A' - 10 + nibble);
+    value >>= 4;
   }
+  return digits;
+}
+
+// Convert fixed-point value (value / 10^dec) into decimal string with (dec) decimal
+// places (not terminated), e.g. sprintFix(buf, -1234, 2) -> "-12.34", returns length
+// (dec is limited to 9, so the result never exceeds 12 characters)
+uint8_t sprintFix(char* buf, int32_t value, uint8_t dec) {
+  char digits[10];
+  char* ptr = buf;
+  uint8_t i = 0, len;
+  if(dec > 9) dec = 9;
+  if(value < 0) *ptr++ = '-';
+  len = sprintD(digits, (value < 0) ? -(uint32_t)value : (uint32_t)value);
+  if(len <= dec) {                                // value < 1: leading zeros
+    *ptr++ = '0';
+    *ptr++ = '.';
+    for(uint8_t z=dec-len; z; z--) *ptr++ = '0';
+  }
+  else {                                          // integer part
+    while(len - i > dec) *ptr++ = digits[i++];
+    if(dec) *ptr++ = '.';
+  }
+  while(i < len) *ptr++ = digits[i++];            // fractional part
+  return ptr - buf;
+}
+
+// ===================================================================================
+// Printf Core
+// ===================================================================================
+
+// Output of the printf core: characters are either passed to a putchar function or
+// collected in a buffer, which is passed to a putbuf function when it is full
+typedef struct {
+  char*    buf;                                   // output buffer
+  uint16_t len;                                   // number of characters in buffer
+  uint16_t size;                                  // size of buffer
+  void (*putchar) (char c);                       // character sink
+  void (*putbuf) (const uint8_t* buf, uint16_t len); // buffer sink
+} PRINT_OUT;
+
+// Pass collected characters to buffer sink
+static void _flush(PRINT_OUT* out) {
+  if(!out->putbuf || !out->len) return;
+  out->putbuf((const uint8_t*)out->buf, out->len);
+  out->len = 0;
+}
+
+// Output a single character
+static void _put(PRINT_OUT* out, char c) {
+  if(out->putchar) {
+    out->putchar(c);
+    return;
+  }
+  if(out->len >= out->size) {
+    _flush(out);
+    if(out->len >= out->size) return;             // buffer full: truncate
+  }
+  out->buf[out->len++] = c;
+}
+
+// Format string and output it
+static void _vfprintf(PRINT_OUT* out, const char* str, va_list arp) {
+  char     num[32];                               // formatted number
+  char     c, pad;
+  uint8_t  len, width, dec, i;
+  uint32_t val;
+
+  while((c = *str++) != 0) {
+    if(c != '%') {
+      _put(out, c);
+      continue;
+    }
+    c = *str++;
+    pad = ' '; width = 0; dec = 0xFF;
+    if(c == '0') {                                // zero padding
+      pad = '0';
+      c = *str++;
+    }
+    while((c >= '0') && (c <= '9')) {             // field width
+      width = (width << 3) + (width << 1) + (c - '0');
+      c = *str++;
+    }
+    if(c == '.') {                                // decimal places (fixed-point)
+      dec = 0;
+      c = *str++;
+      while((c >= '0') && (c <= '9')) {
+        dec = (dec << 3) + (dec << 1) + (c - '0');
+        c = *str++;
+      }
+    }
+    switch(c) {
+      case 0:                                     // end of format string
+        return;
+      case 's':
+        for(const char* s = va_arg(arp, char*); *s; s++) _put(out, *s);
+        continue;
+      case 'c':
+        _put(out, (char)va_arg(arp, int));
+        continue;
+      case 'd':
+        if(dec > 9) len = sprintI(num, va_arg(arp, int32_t));
+        else        len = sprintFix(num, va_arg(arp, int32_t), dec);
+        break;
+      case 'u':
+        len = sprintD(num, va_arg(arp, uint32_t));
+        break;
+      case 'x':
+        val = va_arg(arp, uint32_t);
+        for(len=1; (len < 8) && (val >> (len << 2)); len++);
+        sprintX(num, val, len);
+        break;
+      case 'b':
+        val = va_arg(arp, uint32_t);
+        for(len=1; (len < 32) && (val >> len); len++);
+        for(i=len; i; i--, val >>= 1) num[i - 1] = '0' + (val & 1);
+        break;
+      default:                                    // '%' or unknown
+        _put(out, c);
+        continue;
+    }
+    i = 0;
+    if((pad == '0') && (num[0] == '-')) _put(out, num[i++]); // sign before zeros
+    while(width > len) {
+      _put(out, pad);
+      width--;
+    }
+    while(i < len) _put(out, num[i++]);
+  }
+}
+
+// ===================================================================================
+// Print Functions via Putchar
+// ===================================================================================
+
+// Printf via putchar
+void printF(void (*putchar) (char c), const char* format, ...) {
+  PRINT_OUT out = {0, 0, 0, putchar, 0};
+  va_list arg;
+  va_start(arg, format);
+  _vfprintf(&out, format, arg);
+  va_end(arg);
+}
+
+// Print decimal value via putchar
+void printD(void (*putchar) (char c), uint32_t value) {
+  char num[10];
+  uint8_t len = sprintD(num, value);
+  for(uint8_t i=0; i<len; i++) putchar(num[i]);
+}
+
+// Print fixed-point value (value / 10^dec) with (dec) decimal places via putchar
+void printFix(void (*putchar) (char c), int32_t value, uint8_t dec) {
+  char num[12];
+  uint8_t len = sprintFix(num, value, dec);
+  for(uint8_t i=0; i<len; i++) putchar(num[i]);
 }
 
 // Convert 4-bit byte nibble into hex character and print it via putchar
@@ -61,89 +266,41 @@ void println(void (*putchar) (char c), const char* str) {
   putchar('\n');
 }
 
-// printf, supports %s, %c, %d, %u, %x, %b, %02d, %%
-void _itoa(void (*putchar) (char c), int32_t, int8_t, int8_t);
-static void _vfprintf(void (*putchar) (char c), const char *format, va_list arg);
+// ===================================================================================
+// Print Functions via Putbuf and into Buffer
+// ===================================================================================
 
-void printF(void (*putchar) (char c), const char *format, ...) {
+// Printf via putbuf (output is passed in parts of up to PRINT_BUF_SIZE characters)
+void printBufF(void (*putbuf) (const uint8_t* buf, uint16_t len), const char* format, ...) {
+  char buf[PRINT_BUF_SIZE];
+  PRINT_OUT out = {buf, 0, PRINT_BUF_SIZE, 0, putbuf};
   va_list arg;
   va_start(arg, format);
-  _vfprintf(putchar, format, arg);
+  _vfprintf(&out, format, arg);
   va_end(arg);
+  _flush(&out);
 }
 
-static void _vfprintf(void (*putchar) (char c), const char* str,  va_list arp) {
-  int32_t d, r, w, s;
-  char *c;
-
-  while((d = *str++) != 0) {
-    if(d != '%') {
-      putchar(d);
-      continue;
-    }
-    d = *str++;
-    w = r = s = 0;
-    if(d == '%') {
-      putchar(d);
-      d = *str++;
-    }
-    if(d == '0') {
-      d = *str++;
-      s = 1;
-    }
-    while((d >= '0') && (d <= '9')) {
-      w += w * 10 + (d - '0');
-      d = *str++;
-    }
-    if(s) w = -w;
-    if(d == 's') {
-      c = va_arg(arp, char*);
-      while(*c) putchar(*(c++));
-      continue;
-    }
-    if(d == 'c') {
-      putchar((char)va_arg(arp, int));
-      continue;
-    }
-    if(d =='\0') break;
-    else if(d == 'u') r = 10;
-    else if(d == 'd') r = -10;
-    else if(d == 'x') r = 16;
-    else if(d == 'b') r = 2;
-    else str--;
-    if(r == 0) continue;
-    if(r > 0) _itoa(putchar, (uint32_t)va_arg(arp, int32_t), r, w);
-    else _itoa(putchar, (int32_t)va_arg(arp, int32_t), r, w);
-  }
+// Print decimal value via putbuf
+void printBufD(void (*putbuf) (const uint8_t* buf, uint16_t len), uint32_t value) {
+  char num[10];
+  putbuf((const uint8_t*)num, sprintD(num, value));
 }
 
-void _itoa(void (*putchar) (char c), int32_t val, int8_t rad, int8_t len) {
-  char c, sgn = 0, pad = ' ';
-  char s[20];
-  uint8_t i = 0;
+// Print string via putbuf
+void printBufS(void (*putbuf) (const uint8_t* buf, uint16_t len), const char* str) {
+  uint16_t len = 0;
+  while(str[len]) len++;
+  putbuf((const uint8_t*)str, len);
+}
 
-  if(rad < 0) {
-    rad = -rad;
-    if(val < 0) {
-      val = -val;
-      sgn = '-';
-    }
-  }
-  if(len < 0) {
-    len = -len;
-    pad = '0';
-  }
-  if(len > 20) return;
-  do {
-    c = (char)((uint32_t)val % rad);
-    if (c >= 10) c += ('A' - 10);
-    else c += '0';
-    s[i++] = c;
-    val = (uint32_t)val / rad;
-  } while(val);
-  if((sgn != 0) && (pad != '0')) s[i++] = sgn;
-  while(i < len) s[i++] = pad;
-  if((sgn != 0) && (pad == '0')) s[i++] = sgn;
-  do putchar(s[--i]);
-  while(i);
+// Printf into buffer (must be large enough), string is terminated, returns length
+uint16_t sprintF(char* buf, const char* format, ...) {
+  PRINT_OUT out = {buf, 0, 0xFFFF, 0, 0};
+  va_list arg;
+  va_start(arg, format);
+  _vfprintf(&out, format, arg);
+  va_end(arg);
+  buf[out.len] = 0;
+  return out.len;
 }
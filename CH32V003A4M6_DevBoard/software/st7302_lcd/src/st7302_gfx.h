@@ -1,5 +1,5 @@
 // ===================================================================================
-// ST7302 250x122 Pixels Monochrome Low-Power LCD Graphics Functions          * v1.1 *
+// ST7302 250x122 Pixels Monochrome Low-Power LCD Graphics Functions          * v1.3 *
 // ===================================================================================
 //
 // Functions available:
@@ -8,8 +8,10 @@
 // LCD_sleep(v)                   Set display sleep mode (0: sleep off, 1: sleep on)
 // LCD_invert(v)                  Invert display (0: inverse off, 1: inverse on)
 //
-// LCD_clear()                    Clear LCD screen
-// LCD_flush()                    Flush LCD output buffer (call at the end of all drawings)
+// LCD_clear()                    Clear screen buffer (current band)
+// LCD_flush()                    Send changed parts of screen buffer to the LCD
+// LCD_firstBand()                Select first band of the screen and clear it
+// LCD_nextBand()                 Flush band, select and clear next one, returns 0 when done
 // LCD_getPixel(x,y)              Get pixel color at (x,y) (0: pixel cleared, 1: pixel set)
 // LCD_setPixel(x,y,c)            Set pixel color (c) at position (x,y)
 //
@@ -48,7 +50,25 @@
 //
 // Notes:
 // ------
-// - This library utilizes the integrated software-SPI and works without a screen buffer.
+// - This library uses hardware SPI with DMA (SCL: PC5, SDA: PC6, see spi_dma.h) and draws
+//   into a shadow framebuffer in RAM. LCD_flush() only sends the rectangle of changed
+//   12x2-pixel blocks to the display. The LCD is never read back.
+// - The complete framebuffer needs LCD_ROWS * LCD_COLUMNS * 3 = 4125 bytes. With less
+//   RAM, set LCD_BAND_ROWS below to keep only a band of display RAM rows (2 pixel
+//   columns each) in RAM and draw the screen band by band in a picture loop:
+//     LCD_firstBand();
+//     do {
+//       ... draw the complete screen content ...
+//     } while(LCD_nextBand());
+//   Drawing outside the current band is clipped. The loop also works with the full
+//   framebuffer, where it runs only once.
+// - With LCD_BAND_ROWS < LCD_ROWS, draw only inside such a loop. After the loop the
+//   first band is selected with an empty and clean buffer: drawing then only reaches
+//   the first band and overwrites the drawn blocks there with the empty background.
+// - Since v1.2 the library always draws into the buffer, nothing reaches the display
+//   before LCD_flush() or LCD_nextBand(). The direct drawing without a buffer of
+//   v1.1 is gone, and LCD_clear() clears the buffer (current band) only and doesn't
+//   touch the display anymore.
 // - color: 0: clear pixel (black), 1: set pixel (white), 2: invert pixel
 // - size:  1: normal 6x8 pixels, 2: double size (12x16), ... , 8: 8 times (48x64)
 //          9: smoothed double size (12x16), 10: v-stretched (6x16)
@@ -68,10 +88,9 @@ extern "C" {
 
 #include "config.h"
 #include "gpio.h"
+#include "spi_dma.h"
 
 // LCD Pins
-//#define LCD_PIN_SCL       PC5       // pin connected to SCL (clock) of LCD
-//#define LCD_PIN_SDA       PC6       // pin connected to SDA (data) of LCD
 //#define LCD_PIN_DC        PC3       // pin connected to DC (data/command) of LCD
 //#define LCD_PIN_CS        PC4       // pin connected to CS (select) of LCD
 
@@ -81,6 +100,7 @@ extern "C" {
 #define LCD_XOFF          0         // offset in X-direction
 #define LCD_YOFF          25        // offset in Y-direction
 #define LCD_INVERT        1         // 1: invert display
+#define LCD_BAND_ROWS     25        // display RAM rows in RAM (1..125, 125: full framebuffer)
 
 #define LCD_BOOT_TIME     0         // LCD boot up time in milliseconds
 #define LCD_RST_TIME      250       // time to wait after reset in milliseconds
@@ -111,6 +131,13 @@ extern "C" {
 #define LCD_RAMRD         0x2E      // Memory Read
 #define LCD_MADCTL        0x36      // Memory Data Access Control
 
+#define LCD_ROWS          ((LCD_WIDTH + 1) / 2)   // display RAM rows (2 pixel columns each)
+#define LCD_COLUMNS       ((LCD_HEIGHT + 11) / 12) // display RAM columns (12 pixel lines each)
+
+#if LCD_BAND_ROWS < 1 || LCD_BAND_ROWS > LCD_ROWS
+  #error LCD_BAND_ROWS must be within 1..125!
+#endif
+
 #define LCD_abs(n)        (((n)>=0)?(n):(-(n))) // returns positive value of n
 
 // LCD Control Functions
@@ -121,6 +148,8 @@ void LCD_sleep(uint8_t yes);
 // LCD Graphics Functions
 void LCD_clear(void);
 void LCD_flush(void);
+void LCD_firstBand(void);
+uint8_t LCD_nextBand(void);
 
 uint8_t LCD_getPixel(int16_t x, int16_t y);
 void LCD_setPixel(int16_t x, int16_t y, uint8_t color);
@@ -1,5 +1,5 @@
 // ===================================================================================
-// Basic BME280 Temperature, Pressure and Humidity Sensor Functions           * v1.0 *
+// Basic BME280 Temperature, Pressure and Humidity Sensor Functions           * v1.1 *
 // ===================================================================================
 // 2024 by Stefan Wagner:   https://github.com/wagiminator
 
@@ -41,10 +41,14 @@ void BME_init(void) {
   #endif
 
   I2C_start((BME_ADDR << 1) | 0);
+  I2C_write(BME_REG_CONTROL);
+  I2C_write(0);                                   // sleep mode (config is ignored otherwise)
+  I2C_write(BME_REG_CONFIG);
+  I2C_write(BME_CONFIG);                          // standby time and IIR filter
   I2C_write(BME_REG_CONTROLHUMID);
-  I2C_write(0b00000100);                          // humidity: 8x oversampling
+  I2C_write(BME_CTRL_HUM);                        // humidity oversampling
   I2C_write(BME_REG_CONTROL);
-  I2C_write(0b10010011);                          // pressure/temp: 8x oversampling, normal mode
+  I2C_write(BME_CTRL_MEAS);                       // pressure/temp oversampling and mode
   I2C_write(BME_REG_CALIB_T1);
   I2C_stop();
 
@@ -65,20 +69,29 @@ void BME_init(void) {
   BME_calib_data.H5 = ((int16_t)BME_calib_data.H453 << 4) | (BME_calib_data.H452 >> 4);
 
   #if BME_INIT_TEMP > 0
+  #if BME_FORCED > 0
+  BME_trigger();                                  // no data before first measurement
+  BME_wait();
+  #endif
   BME_getTemp();
   #endif
 }
 
-// Returns temperature in DegC, resolution is 0.01 DegC.
-// Output value of “5123” equals 51.23 DegC.
-int32_t BME_getTemp(void) {
+// Read (len) bytes starting at register (reg) into buffer (*buf) in one transaction
+static void BME_readRegs(uint8_t reg, uint8_t* buf, uint8_t len) {
   I2C_start((BME_ADDR << 1) | 0);
-  I2C_write(BME_REG_TEMPDATA);
+  I2C_write(reg);
   I2C_stop();
   I2C_start((BME_ADDR << 1) | 1);
-  int32_t adc_T = ((uint32_t)I2C_read(2) << 12) | ((uint32_t)I2C_read(1) << 4) | (I2C_read(0) >> 4);
+  I2C_readBuffer(buf, len);
   I2C_stop();
+}
 
+// Convert 20-bit raw value (msb, lsb, xlsb) of temperature or pressure
+#define BME_raw20(r)  ((int32_t)((uint32_t)(r)[0] << 12 | (uint32_t)(r)[1] << 4 | (r)[2] >> 4))
+
+// Compensate raw temperature (adc_T), update fine temperature, return 0.01 DegC
+static int32_t BME_compTemp(int32_t adc_T) {
   int32_t var1, var2;
   var1 = (int32_t)((adc_T >> 3) - ((int32_t)BME_calib_data.T1 << 1));
   var1 = (var1 * ((int32_t)BME_calib_data.T2)) >> 11;
@@ -88,17 +101,16 @@ int32_t BME_getTemp(void) {
   return(BME_t_fine * 5 + 128) >> 8;
 }
 
-// Returns pressure in Pa as unsigned 32 bit integer.
-// Output value of “96386” equals 96386 Pa = 963.86 hPa.
-uint32_t BME_getPressure(void) {
-  I2C_start((BME_ADDR << 1) | 0);
-  I2C_write(BME_REG_PRESSUREDATA);
-  I2C_stop();
-  I2C_start((BME_ADDR << 1) | 1);
-  int32_t adc_P = ((uint32_t)I2C_read(3) << 24) | ((uint32_t)I2C_read(2) << 16) 
-                | ((uint32_t)I2C_read(1) <<  8) | ((uint32_t)I2C_read(0));
-  I2C_stop();
+// Returns temperature in DegC, resolution is 0.01 DegC.
+// Output value of “5123” equals 51.23 DegC.
+int32_t BME_getTemp(void) {
+  uint8_t raw[3];
+  BME_readRegs(BME_REG_TEMPDATA, raw, 3);
+  return BME_compTemp(BME_raw20(raw));
+}
 
+// Compensate raw pressure (adc_P) with fine temperature, return Pa
+static uint32_t BME_compPressure(int32_t adc_P) {
   int32_t var1, var2;
   uint32_t p;
   var1 = (BME_t_fine >> 1) - 64000;
@@ -118,16 +130,16 @@ uint32_t BME_getPressure(void) {
   return p;
 }
 
-// Humidity in %RH, resolution is 0.01%RH.
-// Output value of “4653” represents 46.53 %RH.
-uint32_t BME_getHumidity(void) {
-  I2C_start((BME_ADDR << 1) | 0);
-  I2C_write(BME_REG_HUMIDDATA);
-  I2C_stop();
-  I2C_start((BME_ADDR << 1) | 1);
-  int32_t adc_H = ((uint16_t)I2C_read(1) << 8) | I2C_read(0);
-  I2C_stop();
+// Returns pressure in Pa as unsigned 32 bit integer.
+// Output value of “96386” equals 96386 Pa = 963.86 hPa.
+uint32_t BME_getPressure(void) {
+  uint8_t raw[3];
+  BME_readRegs(BME_REG_PRESSUREDATA, raw, 3);
+  return BME_compPressure(BME_raw20(raw));
+}
 
+// Compensate raw humidity (adc_H) with fine temperature, return 0.01 %RH
+static uint32_t BME_compHumidity(int32_t adc_H) {
   int32_t var1; 
   var1 = BME_t_fine - 76800;
   var1 = (((((adc_H << 14) - (((int32_t)BME_calib_data.H4) << 20) - (((int32_t)BME_calib_data.H5) * var1))
@@ -140,11 +152,19 @@ uint32_t BME_getHumidity(void) {
   return((var1 >> 12) * 25) >> 8;
 }
 
+// Humidity in %RH, resolution is 0.01%RH.
+// Output value of “4653” represents 46.53 %RH.
+uint32_t BME_getHumidity(void) {
+  uint8_t raw[2];
+  BME_readRegs(BME_REG_HUMIDDATA, raw, 2);
+  return BME_compHumidity((uint16_t)raw[0] << 8 | raw[1]);
+}
+
 // Put device into sleep mode (1: sleep, 0: wake up)
 void BME_sleep(uint8_t slp) {
   I2C_start((BME_ADDR << 1) | 0);
   I2C_write(BME_REG_CONTROL);
-  I2C_write(slp ? 0 : 0b10010011);
+  I2C_write(slp ? 0 : BME_CTRL_MEAS);
   I2C_stop();
 }
 
@@ -152,3 +172,40 @@ void BME_sleep(uint8_t slp) {
 void BME_adjustTemp(int32_t adjust) {
   BME_t_fine_adjust = (adjust << 8) / 5;
 };
+
+// Read all data registers (0xF7..0xFE) at once and compensate all values
+void BME_readAll(BME_DATA_TYPE* data) {
+  uint8_t raw[8];
+  BME_readRegs(BME_REG_PRESSUREDATA, raw, 8);     // pressure, temperature, humidity
+  data->temp     = BME_compTemp(BME_raw20(raw + 3));  // temperature first for t_fine
+  data->pressure = BME_compPressure(BME_raw20(raw));
+  data->humidity = BME_compHumidity((uint16_t)raw[6] << 8 | raw[7]);
+}
+
+// Start single measurement (forced mode), sensor returns to sleep mode afterwards
+void BME_trigger(void) {
+  I2C_start((BME_ADDR << 1) | 0);
+  I2C_write(BME_REG_CONTROL);
+  I2C_write((BME_CTRL_MEAS & 0xFC) | 1);
+  I2C_stop();
+}
+
+// Check if measurement is still running (0: finished)
+uint8_t BME_busy(void) {
+  uint8_t status;
+  BME_readRegs(BME_REG_STATUS, &status, 1);
+  return(status & 0x08);
+}
+
+// Wait for measurement to finish
+void BME_wait(void) {
+  DLY_ms((BME_MEAS_TIME + 999) / 1000);           // max measurement time
+  while(BME_busy());
+}
+
+// Trigger single measurement, wait and read all values
+void BME_sample(BME_DATA_TYPE* data) {
+  BME_trigger();
+  BME_wait();
+  BME_readAll(data);
+}
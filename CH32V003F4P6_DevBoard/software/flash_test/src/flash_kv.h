@@ -0,0 +1,67 @@
+// ===================================================================================
+// Key/Value Store in CODE FLASH for CH32V003                                 * v1.1 *
+// ===================================================================================
+//
+// Functions available:
+// --------------------
+// KV_init()                Scan store, must be called once before any other function
+// KV_read(k, b, n)         Read value of key (k) into buffer (b) with max (n) bytes,
+//                          returns length of value (0 if key doesn't exist)
+// KV_write(k, b, n)        Write value of key (k) from buffer (b) with (n) bytes,
+//                          returns 1 if successful, 0 if store is full or write failed
+// KV_delete(k)             Delete key (k), returns 1 if successful
+// KV_format()              Erase all pages of the store
+//
+// Notes:
+// ------
+// - The store is an append-only log across the last KV_PAGES pages of CODE FLASH
+//   (below the page used by FLASH_END_xxx functions). These pages must not be used
+//   by the firmware, the linker script of this project reserves them.
+// - Each page starts with a 16-bit sequence number and its complement, followed by
+//   packed records: header (key, length), value (up to KV_VALUE_MAX bytes, padded to
+//   half-words) and CRC-16. A write appends a record to the free half-words of the
+//   current page (erased FLASH reads 0xE339). A page is only erased when the log
+//   wraps around: the current values of the oldest page are moved to the current page
+//   first. Two erased pages are always kept ahead of the current page.
+// - Wear levelling: a 4-byte value takes 8 bytes, 7 updates fit into one page, and
+//   the pages are used in a circular order. Updating a single 4-byte value erases each
+//   page about 100 times less often than rewriting it in a fixed page. Writing the same
+//   value again doesn't touch the FLASH at all.
+// - Power-fail safety: a record is only valid if its CRC matches and the latest valid
+//   record of a key wins. An interrupted write leaves an invalid record and the
+//   previous value of the key remains. Interrupted page erases and compactions are
+//   completed by KV_init().
+// - The store can hold up to (KV_PAGES - 3) pages of current values. KV_write()
+//   returns 0 if the value doesn't fit.
+// - Store format v1.1 (packed records) is not compatible with v1.0 (one record per
+//   page), KV_init() erases v1.0 pages.
+//
+// 2024 by Stefan Wagner:   https://github.com/wagiminator
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "flash.h"
+
+// Key/value store parameters
+#define KV_PAGES          16        // number of CODE FLASH pages used by the store (4..32)
+#define KV_FIRST          (255 - KV_PAGES) // first page of the store (last page is spared)
+#define KV_VALUE_MAX      56        // max length of a value in bytes
+
+#if KV_PAGES < 4 || KV_PAGES > 32
+  #error KV_PAGES must be within 4..32!
+#endif
+
+// Key/value store functions
+void KV_init(void);
+uint8_t KV_read(uint8_t key, void* buf, uint8_t len);
+uint8_t KV_write(uint8_t key, const void* buf, uint8_t len);
+uint8_t KV_delete(uint8_t key);
+void KV_format(void);
+
+#ifdef __cplusplus
+};
+#endif
@@ -5,8 +5,14 @@
 // Description:
 // ------------
 // Transfers content of 24Cxx I2C EEPROM via UART (UART BAUD: 115200, 8N1, TX: PD5).
+// In benchmark mode, the speed of sequential writes and reads is measured first.
 
 #pragma once
 
 // Pin defines
 #define PIN_LED   PC0       // define LED pin
+
+// Benchmark mode (overwrites EEPROM content!)
+#define BENCHMARK   0       // 1: measure write/read speed at startup, 0: no benchmark
+#define BENCH_SIZE  256     // number of bytes to write/read (max EEPROM size)
+#define BENCH_BUF   64      // size of data buffer in RAM
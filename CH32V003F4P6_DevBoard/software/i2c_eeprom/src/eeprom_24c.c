@@ -1,5 +1,5 @@
 // ===================================================================================
-// 24Cxx I2C EEPROM Functions                                                 * v1.0 *
+// 24Cxx I2C EEPROM Functions                                                 * v1.2 *
 // ===================================================================================
 //
 // Simple 24Cxx I2C EEPROM functions.
@@ -8,48 +8,90 @@
 
 #include "eeprom_24c.h"
 
-// Write single byte to EEPROM
-void EEPROM_write(uint16_t addr, uint8_t value) {
-  I2C_start(EEPROM_ADDR | ((addr >> 7) & 0x0e));
+// Device address including block select bits of memory address
+#if EEPROM_ADDR16 > 0
+  #define EEPROM_DEV(a)     (EEPROM_ADDR | (((a) >> 15) & 0x0e))
+#else
+  #define EEPROM_DEV(a)     (EEPROM_ADDR | (((a) >> 7) & 0x0e))
+#endif
+
+// Max number of bytes per DMA read
+#define EEPROM_DMA_MAX      0xFFFF
+
+// Write cycle in progress flag
+static uint8_t EEPROM_busy;
+
+// Init EEPROM driver state (BSS may not be cleared at startup)
+void EEPROM_init(void) {
+  EEPROM_busy = 0;
+}
+
+// Wait until internal write cycle is finished (ACK polling)
+void EEPROM_wait(void) {
+  if(!EEPROM_busy) return;
+  while(!I2C_poll(EEPROM_ADDR));
+  EEPROM_busy = 0;
+}
+
+// Start write transmission and send memory address
+static void EEPROM_start(uint32_t addr) {
+  EEPROM_wait();
+  I2C_start(EEPROM_DEV(addr));
+  #if EEPROM_ADDR16 > 0
+  I2C_write(addr >> 8);
+  #endif
   I2C_write(addr);
+}
+
+// Write single byte to EEPROM
+void EEPROM_write(uint32_t addr, uint8_t value) {
+  EEPROM_start(addr);
   I2C_write(value);
   I2C_stop();
-  DLY_ms(5);
+  EEPROM_busy = 1;
 }
 
 // Read single byte from EEPROM
-uint8_t EEPROM_read(uint16_t addr) {
+uint8_t EEPROM_read(uint32_t addr) {
   uint8_t result;
-  I2C_start(EEPROM_ADDR | ((addr >> 7) & 0x0e));
-  I2C_write(addr);
+  EEPROM_start(addr);
   I2C_stop();
-  I2C_start(EEPROM_ADDR | ((addr >> 7) & 0x0e) | 1);
+  I2C_start(EEPROM_DEV(addr) | 1);
   result = I2C_read(0);
   I2C_stop();
   return result;
 }
 
 // Write single byte to data flash if changed (this reduces write cycles)
-void EEPROM_update(uint16_t addr, uint8_t value) {
+void EEPROM_update(uint32_t addr, uint8_t value) {
   if(EEPROM_read(addr) != value) EEPROM_write(addr, value);
 }
 
-// Write byte stream to page
-void EEPROM_writeStream(uint16_t addr, uint8_t* ptr, uint8_t len) {
-  if(len > EEPROM_PAGESIZE) len = EEPROM_PAGESIZE;
-  I2C_start(EEPROM_ADDR | ((addr >> 7) & 0x0e));
-  I2C_write(addr);
-  while(len--) I2C_write(*ptr++);
-  I2C_stop();
-  DLY_ms(5);
+// Write byte stream to EEPROM, split at page boundaries
+void EEPROM_writeStream(uint32_t addr, const uint8_t* ptr, uint32_t len) {
+  uint8_t cnt;
+  while(len) {
+    cnt = EEPROM_PAGESIZE - (addr & (EEPROM_PAGESIZE - 1)); // bytes left in page
+    if(cnt > len) cnt = len;
+    EEPROM_start(addr);
+    addr += cnt;
+    len  -= cnt;
+    while(cnt--) I2C_write(*ptr++);
+    I2C_stop();
+    EEPROM_busy = 1;
+  }
 }
 
-// Read byte stream from EEPROM
-void EEPROM_readStream(uint16_t addr, uint8_t* ptr, uint8_t len) {
-  I2C_start(EEPROM_ADDR | ((addr >> 7) & 0x0e));
-  I2C_write(addr);
-  I2C_stop();
-  I2C_start(EEPROM_ADDR | ((addr >> 7) & 0x0e) | 1);
-  while(len--) *ptr++ = I2C_read(len);
-  I2C_stop();
+// Read byte stream from EEPROM via DMA
+void EEPROM_readStream(uint32_t addr, uint8_t* ptr, uint32_t len) {
+  uint16_t cnt;
+  while(len) {
+    cnt = (len > EEPROM_DMA_MAX) ? EEPROM_DMA_MAX : len;
+    EEPROM_start(addr);
+    I2C_stop();
+    I2C_readDMA(EEPROM_DEV(addr) | 1, ptr, cnt);
+    addr += cnt;
+    ptr  += cnt;
+    len  -= cnt;
+  }
 }
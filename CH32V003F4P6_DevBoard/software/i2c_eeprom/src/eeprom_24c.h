@@ -1,16 +1,29 @@
 // ===================================================================================
-// 24Cxx I2C EEPROM Functions                                                 * v1.0 *
+// 24Cxx I2C EEPROM Functions                                                 * v1.2 *
 // ===================================================================================
 //
 // Simple 24Cxx I2C EEPROM functions.
 //
 // Functions available:
 // --------------------
+// EEPROM_init()              init driver state (call once after I2C_init())
 // EEPROM_read(a)             read single byte from EEPROM address (a)
 // EEPROM_write(a,v)          write single byte (v) to EEPROM address (a)
 // EEPROM_update(a,v)         write if changed (reduces write cycles)
 // EEPROM_writeStream(a,p,l)  write (l) number of bytes starting at address (a) from pointer (p)
 // EEPROM_readStream(a,p,l)   read (l) number of bytes starting at address (a) to pointer (p)
+// EEPROM_wait()              wait until internal write cycle is finished
+//
+// Notes:
+// ------
+// - EEPROM_writeStream() splits the data at the page boundaries of the EEPROM and
+//   writes each part as a page write. Set EEPROM_PAGESIZE below according to the
+//   datasheet (e.g. 24C02: 8, 24C04/08/16: 16, 24C32/64: 32, 24C128/256: 64,
+//   24C512: 128).
+// - Write functions return right after the data was transferred. Before the next
+//   access, the EEPROM is polled until it acknowledges its address again (ACK polling),
+//   so the actual write cycle time is used instead of a fixed worst-case delay.
+// - EEPROM_readStream() uses sequential reads via DMA, the length can exceed 64KB.
 //
 // 2024 by Stefan Wagner:     https://github.com/wagiminator
 
@@ -25,14 +38,21 @@ extern "C" {
 
 // EEPROM definitions
 #define EEPROM_ADDR       0xa0      // EEPROM I2C device address including write bit
-#define EEPROM_PAGESIZE   8         // page size of EEPROM
+#define EEPROM_PAGESIZE   8         // page size of EEPROM (8, 16, 32, 64 or 128 bytes)
+#define EEPROM_ADDR16     0         // 0: 8-bit word address (24C01..24C16), 1: 16-bit (24C32..)
+
+#if (EEPROM_PAGESIZE & (EEPROM_PAGESIZE - 1)) || EEPROM_PAGESIZE < 8 || EEPROM_PAGESIZE > 128
+  #error EEPROM_PAGESIZE must be 8, 16, 32, 64 or 128!
+#endif
 
 // EEPROM functions
-uint8_t EEPROM_read(uint16_t addr);                 // read single byte from EEPROM
-void EEPROM_write(uint16_t addr, uint8_t value);    // write single byte to EEPROM
-void EEPROM_update(uint16_t addr, uint8_t value);   // write if changed (reduces write cycles)
-void EEPROM_writeStream(uint16_t addr, uint8_t* ptr, uint8_t len);
-void EEPROM_readStream(uint16_t addr, uint8_t* ptr, uint8_t len);
+void EEPROM_init(void);                             // init driver state
+uint8_t EEPROM_read(uint32_t addr);                 // read single byte from EEPROM
+void EEPROM_write(uint32_t addr, uint8_t value);    // write single byte to EEPROM
+void EEPROM_update(uint32_t addr, uint8_t value);   // write if changed (reduces write cycles)
+void EEPROM_writeStream(uint32_t addr, const uint8_t* ptr, uint32_t len);
+void EEPROM_readStream(uint32_t addr, uint8_t* ptr, uint32_t len);
+void EEPROM_wait(void);                             // wait until write cycle is finished
 
 #ifdef __cplusplus
 };
@@ -1,5 +1,5 @@
 // ===================================================================================
-// Basic I2C Master Functions for CH32V003                                    * v1.1 *
+// Basic I2C Master Functions for CH32V003                                    * v1.2 *
 // ===================================================================================
 // 2023 by Stefan Wagner:   https://github.com/wagiminator
 
@@ -42,6 +42,10 @@ void I2C_init(void) {
     I2C1->CKCFGR  = (F_CPU / (2 * I2C_CLKRATE));  // -> set clock division factor 1:1
   #endif
   I2C1->CTLR1   = I2C_CTLR1_PE;                   // enable I2C
+
+  // Setup DMA Channel 7 (used by I2C_readDMA)
+  RCC->AHBPCENR |= RCC_DMA1EN;                    // enable DMA module clock
+  DMA1_Channel7->PADDR = (uint32_t)&I2C1->DATAR;  // peripheral address
 }
 
 // Start I2C transmission (addr must contain R/W bit)
@@ -83,6 +87,21 @@ void I2C_stop(void) {
   }
 }
 
+// Address slave and stop, returns 1 if slave acknowledged (ACK polling)
+uint8_t I2C_poll(uint8_t addr) {
+  uint8_t ack;
+  while(I2C1->STAR2 & I2C_STAR2_BUSY);            // wait until bus ready
+  I2C1->CTLR1 |= I2C_CTLR1_START;                 // set START condition
+  while(!(I2C1->STAR1 & I2C_STAR1_SB));           // wait for START generated
+  I2C1->DATAR = addr & 0xFE;                      // send slave address + write bit
+  while(!(I2C1->STAR1 & (I2C_STAR1_ADDR | I2C_STAR1_AF))); // wait for ACK or NAK
+  ack = !(I2C1->STAR1 & I2C_STAR1_AF);            // slave acknowledged?
+  I2C1->STAR1 = ~I2C_STAR1_AF;                    // clear acknowledge failure flag
+  (void)I2C1->STAR2;                              // clear ADDR flag
+  I2C1->CTLR1 |= I2C_CTLR1_STOP;                  // set STOP condition
+  return ack;
+}
+
 // Send data buffer via I2C bus and stop
 void I2C_writeBuffer(uint8_t* buf, uint16_t len) {
   while(len--) I2C_write(*buf++);           // write buffer
@@ -93,3 +112,25 @@ void I2C_writeBuffer(uint8_t* buf, uint16_t len) {
 void I2C_readBuffer(uint8_t* buf, uint16_t len) {
   while(len--) *buf++ = I2C_read(len > 0);
 }
+
+// Start read from slave, receive data via DMA to buffer and stop
+void I2C_readDMA(uint8_t addr, uint8_t* buf, uint16_t len) {
+  if(len < 2) {                                   // single byte (or none)?
+    if(!len) return;
+    I2C_start(addr | 1);                          // -> start read transmission
+    *buf = I2C_read(0);                           // -> read byte, NAK and stop
+    return;
+  }
+  DMA1_Channel7->CNTR  = len;                     // number of bytes to be transfered
+  DMA1_Channel7->MADDR = (uint32_t)buf;           // memory address
+  DMA1_Channel7->CFGR  = DMA_CFG7_MINC            // increment memory address
+                       | DMA_CFG7_EN;             // enable DMA channel
+  I2C1->CTLR2 |= I2C_CTLR2_DMAEN                  // enable DMA request
+               | I2C_CTLR2_LAST;                  // NAK after last byte
+  I2C_start(addr | 1);                            // start read transmission
+  while(!(DMA1->INTFR & DMA_TCIF7));              // wait for all bytes received
+  DMA1->INTFCR         = DMA_CGIF7;               // clear interrupt flags
+  DMA1_Channel7->CFGR  = 0;                       // disable DMA channel
+  I2C1->CTLR2 &= ~(I2C_CTLR2_DMAEN | I2C_CTLR2_LAST); // disable DMA request
+  I2C1->CTLR1 |= I2C_CTLR1_STOP;                  // set STOP condition
+}
@@ -1,6 +1,6 @@
 // ===================================================================================
 // Project:   Example for CH32V003
-// Version:   v1.0
+// Version:   v1.1
 // Year:      2023
 // Author:    Stefan Wagner
 // Github:    https://github.com/wagiminator
@@ -10,7 +10,9 @@
 //
 // Description:
 // ------------
-// Transfers content of 24Cxx I2C EEPROM via UART.
+// Transfers content of 24Cxx I2C EEPROM via UART. If BENCHMARK is enabled in
+// config.h, the speed of sequential writes and reads is measured first and reported
+// in KB/s. Write time includes the internal write cycles of the EEPROM.
 //
 // References:
 // -----------
@@ -28,11 +30,47 @@
 // ===================================================================================
 // Libraries, Definitions and Macros
 // ===================================================================================
+#include <config.h>                               // user configurations
 #include <system.h>                               // system functions
 #include <debug_serial.h>                         // serial debug functions
 #include <i2c.h>                                  // I2C functions
 #include <eeprom_24c.h>                           // 24Cxx I2C EEPROM functions
 
+#if BENCHMARK > 0
+// ===================================================================================
+// Benchmark
+// ===================================================================================
+uint8_t buffer[BENCH_BUF];                        // data buffer
+
+// Print transfer rate in KB/s with one decimal from number of bytes and system ticks
+void printRate(uint32_t bytes, uint32_t ticks) {
+  uint32_t rate = bytes * 9766 / (ticks / DLY_US_TIME); // 0.1KB/s = bytes * 10^7/1024 / us
+  DEBUG_printD(rate / 10); DEBUG_write('.'); DEBUG_printD(rate % 10);
+  DEBUG_println(" KB/s");
+}
+
+// Measure sequential write and read speed
+void benchmark(void) {
+  uint32_t addr, start;
+  uint16_t i;
+  for(i=0; i<BENCH_BUF; i++) buffer[i] = i;
+
+  start = STK->CNT;
+  for(addr=0; addr<BENCH_SIZE; addr+=BENCH_BUF)
+    EEPROM_writeStream(addr, buffer, BENCH_BUF);
+  EEPROM_wait();
+  DEBUG_print("Sequential write: ");
+  printRate(BENCH_SIZE, STK->CNT - start);
+
+  start = STK->CNT;
+  for(addr=0; addr<BENCH_SIZE; addr+=BENCH_BUF)
+    EEPROM_readStream(addr, buffer, BENCH_BUF);
+  DEBUG_print("Sequential read:  ");
+  printRate(BENCH_SIZE, STK->CNT - start);
+  DEBUG_println("");
+}
+#endif
+
 // ===================================================================================
 // Main Function
 // ===================================================================================
@@ -40,6 +78,10 @@ int main(void) {
   // Setup
   DEBUG_init();                                   // init serial debug
   I2C_init();                                     // init I2C
+  EEPROM_init();                                  // init EEPROM driver
+  #if BENCHMARK > 0
+  benchmark();                                    // measure write/read speed
+  #endif
   EEPROM_update(0, 0x55);                         // write value to address 0
   
   // Loop
@@ -1,6 +1,6 @@
 // ===================================================================================
 // Project:   Millis Demo for CH32V003
-// Version:   v1.0
+// Version:   v1.1
 // Year:      2023
 // Author:    Stefan Wagner
 // Github:    https://github.com/wagiminator
@@ -10,7 +10,8 @@
 //
 // Description:
 // ------------
-// Blink built-in LED using millis counter.
+// Blink built-in LED using a periodic software timer of the tickless millis functions.
+// The MCU sleeps in between.
 //
 // References:
 // -----------
@@ -31,21 +32,26 @@
 #include <config.h>                 // user configurations
 #include <system.h>                 // system functions
 #include <gpio.h>                   // GPIO functions
-#include <millis.h>                 // GPIO functions
+#include <millis.h>                 // millis functions
+
+// ===================================================================================
+// Timer Callback Function
+// ===================================================================================
+void blink(void) {
+  PIN_toggle(PIN_LED);              // toggle LED on/off
+}
 
 // ===================================================================================
 // Main Function
 // ===================================================================================
 int main(void) {
   // Setup
-  uint32_t nexttime = 0;            // next time variable
   PIN_output(PIN_LED);              // set LED pin as output
   MIL_init();                       // init millis counter
+  MIL_timerStart(0, 100, 1, blink); // toggle LED every 100 milliseconds
   
   // Loop
   while(1) {
-    PIN_toggle(PIN_LED);            // toggle LED on/off
-    while(MIL_read() < nexttime);   // wait for next time
-    nexttime += 100;                // increase next timeby 100 milliseconds
+    SLEEP_WFI_now();                // sleep until next interrupt
   }
 }
@@ -1,37 +1,158 @@
 // ===================================================================================
-// Millis Functions for CH32V003                                              * v1.0 *
+// Millis Functions for CH32V003                                              * v1.1 *
 // ===================================================================================
 // 2023 by Stefan Wagner:   https://github.com/wagiminator
 
 #include "millis.h"
 
+#define MIL_HORIZON       ((uint32_t)1 << 30)   // max SysTick counts between interrupts
+#define MIL_HORIZON_MS    (MIL_HORIZON / DLY_MS_TIME)
+
 volatile uint32_t MIL_millis = 0;   // millis counter
+volatile uint32_t MIL_tick;         // SysTick count at the start of current millisecond
+
+volatile uint32_t MIL_timerDue[MIL_TIMERS];         // millis value at which timer expires
+volatile uint32_t MIL_timerPeriod[MIL_TIMERS];      // period in ms (0: one-shot)
+void (* volatile MIL_timerCallback[MIL_TIMERS])(void); // callback function (0: stopped)
+
+volatile uint32_t MIL_wakeEnd;      // SysTick count at which sleeping delay ends
+volatile uint8_t  MIL_waking = 0;   // 1: sleeping delay is waiting for MIL_wakeEnd
+volatile uint8_t  MIL_inISR  = 0;   // 1: timer callbacks are running
+
+// Bring millis counter up to date (interrupts must be disabled)
+static void MIL_update(void) {
+  uint32_t elapsed = STK->CNT - MIL_tick;
+  if(elapsed >= DLY_MS_TIME) {
+    uint32_t ms = elapsed / DLY_MS_TIME;
+    MIL_millis += ms;
+    MIL_tick   += ms * DLY_MS_TIME;
+  }
+}
+
+// Set SysTick compare for the next event (interrupts must be disabled)
+static void MIL_schedule(void) {
+  uint32_t now  = STK->CNT;
+  int32_t  dist = MIL_HORIZON - (now - MIL_tick);   // keep millis counter up to date
+  for(uint8_t i=0; i<MIL_TIMERS; i++) {
+    if(!MIL_timerCallback[i]) continue;
+    uint32_t ms = MIL_timerDue[i] - MIL_millis;
+    if((int32_t)ms <= 0) dist = 0;                  // timer already expired
+    else if(ms < MIL_HORIZON_MS) {
+      int32_t d = MIL_tick + ms * DLY_MS_TIME - now;
+      if(d < dist) dist = d;
+    }
+  }
+  if(MIL_waking) {
+    int32_t d = MIL_wakeEnd - now;
+    if(d < dist) dist = d;
+  }
+  STK->CMP = now + dist;
+  if((int32_t)(STK->CNT - (now + dist)) >= 0)       // already passed?
+    NVIC_SetPendingIRQ(SysTicK_IRQn);               // -> handle it right now
+}
 
 // Init millis counter
 void MIL_init(void) {
-  STK->CTLR = 0;                    // disable SysTick
-  NVIC_EnableIRQ(SysTicK_IRQn);     // enable the SysTick IRQ
-  STK->CMP = DLY_MS_TIME - 1;       // set interval to 1ms
-  STK->CNT = 0;                     // start at zero
-  STK->CTLR = STK_CTLR_STE          // enable SysTick
-            | STK_CTLR_STIE         // enable SysTick compare match interrupt
+  STK->CTLR = STK_CTLR_STE          // enable SysTick (free-running)
             | STK_CTLR_STCLK;       // set SysTick clock to F_CPU
+  MIL_tick   = STK->CNT;            // start at zero
+  MIL_millis = 0;
+  MIL_schedule();                   // set first compare value
+  STK->SR    = 0;                   // clear interrupt flag
+  NVIC_EnableIRQ(SysTicK_IRQn);     // enable the SysTick IRQ
+  STK->CTLR |= STK_CTLR_STIE;       // enable SysTick compare match interrupt
 }
 
 // Read millis counter value
 uint32_t MIL_read(void) {
-  return MIL_millis;
+  uint32_t result;
+  INT_ATOMIC_BLOCK {
+    MIL_update();
+    result = MIL_millis;
+  }
+  return result;
 }
 
-// Reset millis counter value
+// Read micros counter value
+uint32_t MIL_readMicros(void) {
+  uint32_t result;
+  INT_ATOMIC_BLOCK {
+    MIL_update();
+    result = MIL_millis * 1000 + (STK->CNT - MIL_tick) / DLY_US_TIME;
+  }
+  return result;
+}
+
+// Reset millis counter value (running timers keep their remaining time)
 void MIL_reset(void) {
-  MIL_millis = 0;
+  INT_ATOMIC_BLOCK {
+    MIL_update();
+    for(uint8_t i=0; i<MIL_TIMERS; i++) MIL_timerDue[i] -= MIL_millis;
+    MIL_millis = 0;
+  }
+}
+
+// Start software timer (n) calling function (callback) after (ms) milliseconds
+// (periodic: 0: one-shot, 1: every (ms) milliseconds)
+void MIL_timerStart(uint8_t n, uint32_t ms, uint8_t periodic, void (*callback)(void)) {
+  if(n >= MIL_TIMERS) return;
+  INT_ATOMIC_BLOCK {
+    MIL_update();
+    MIL_timerDue[n]      = MIL_millis + ms;
+    MIL_timerPeriod[n]   = periodic ? ms : 0;
+    MIL_timerCallback[n] = callback;
+    if(!MIL_inISR) MIL_schedule();  // ISR schedules after all callbacks
+  }
+}
+
+// Stop software timer (n)
+void MIL_timerStop(uint8_t n) {
+  if(n < MIL_TIMERS) MIL_timerCallback[n] = 0;
+}
+
+// Check if software timer (n) is running
+uint8_t MIL_timerActive(uint8_t n) {
+  return((n < MIL_TIMERS) && MIL_timerCallback[n]);
+}
+
+// Delay n SysTick counts, sleep (WFI) until SysTick compare if possible
+void MIL_sleepTicks(uint32_t n) {
+  uint32_t end = STK->CNT + n;
+  if((n >= MIL_SLEEP_MIN) && !MIL_inISR && (STK->CTLR & STK_CTLR_STIE)
+    && (__get_MSTATUS() & 0x08)) {   // not before MIL_init() and not inside interrupts
+    INT_disable();                  // no interrupt between check and WFI
+    MIL_wakeEnd = end;
+    MIL_waking  = 1;
+    MIL_schedule();
+    while(((int32_t)(STK->CNT - end)) < 0) {
+      SLEEP_WFI_now();              // wakes up on pending interrupt
+      INT_enable();                 // serve interrupt
+      INT_disable();
+    }
+    MIL_waking = 0;
+    INT_enable();
+  }
+  while(((int32_t)(STK->CNT - end)) < 0);
 }
 
 // Interrupt service routine
 void SysTick_Handler(void) __attribute__((interrupt));
 void SysTick_Handler(void) {
-  MIL_millis++;                     // increase millis counter
-  STK->CMP += DLY_MS_TIME;          // next interrupt 1ms later
-  STK->SR   = 0;                    // clear interrupt flag
+  STK->SR = 0;                      // clear interrupt flag
+  MIL_update();                     // update millis counter
+  if(MIL_waking && ((int32_t)(STK->CNT - MIL_wakeEnd) >= 0)) MIL_waking = 0;
+  MIL_inISR = 1;
+  for(uint8_t i=0; i<MIL_TIMERS; i++) {
+    void (*callback)(void) = MIL_timerCallback[i];
+    if(!callback || ((int32_t)(MIL_millis - MIL_timerDue[i]) < 0)) continue;
+    if(MIL_timerPeriod[i]) {        // periodic timer -> next period, skip missed ones
+      MIL_timerDue[i] += MIL_timerPeriod[i];
+      if((int32_t)(MIL_millis - MIL_timerDue[i]) >= 0)
+        MIL_timerDue[i] = MIL_millis + MIL_timerPeriod[i];
+    }
+    else MIL_timerCallback[i] = 0;  // one-shot timer -> stop
+    callback();
+  }
+  MIL_inISR = 0;
+  MIL_schedule();                   // set compare for next event
 }
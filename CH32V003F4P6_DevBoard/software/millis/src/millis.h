@@ -1,17 +1,32 @@
 // ===================================================================================
-// Millis Functions for CH32V003                                              * v1.0 *
+// Millis Functions for CH32V003                                              * v1.1 *
 // ===================================================================================
 //
 // Functions available:
 // --------------------
 // MIL_init()               init and start millis counter at zero
 // MIL_read()               read current millis counter value (32-bit)
+// MIL_readMicros()         read current micros counter value (32-bit, 1us resolution)
 // MIL_reset()              reset millis counter to zero
 //
+// MIL_timerStart(n,ms,p,f) start software timer (n) calling function (f) after (ms)
+//                          milliseconds, (p) 0: one-shot, 1: periodic
+// MIL_timerStop(n)         stop software timer (n)
+// MIL_timerActive(n)       check if software timer (n) is running
+//
+// MIL_sleepTicks(n)        delay n SysTick counts, sleeping (WFI) instead of spinning
+//
 // Notes:
 // ------
-// The millis (MIL) functions use the SysTick timer and interrupt. The delay (DLY) 
-// functions continue to work properly.
+// The millis (MIL) functions are tickless: the time is derived from the free-running
+// SysTick counter and the SysTick compare interrupt is only set for the next expiring
+// software timer or sleeping delay (or at the latest every 2^30 counts to keep track
+// of the counter). The delay (DLY) functions continue to work properly. With
+// MIL_DLY_SLEEP the DLY functions of all files that include millis.h sleep (WFI) until
+// the delay has expired. Delays shorter than MIL_SLEEP_MIN counts, delays inside
+// interrupt service routines and timer callbacks still spin. SysTick does not run in
+// standby mode, use AWU for deep sleep.
+// Timer callbacks are called inside the SysTick interrupt, keep them short.
 //
 // 2023 by Stefan Wagner:   https://github.com/wagiminator
 
@@ -27,9 +42,25 @@ extern "C" {
   #error Interrupt vector table must be enabled (SYS_USE_VECTORS in system.h)!
 #endif
 
+// Millis Parameters
+#define MIL_TIMERS        4                     // number of software timers
+#define MIL_DLY_SLEEP     1                     // 1: DLY functions sleep instead of spinning
+#define MIL_SLEEP_MIN     (20 * DLY_US_TIME)    // shortest delay for sleeping (SysTick counts)
+
 void MIL_init(void);
 void MIL_reset(void);
 uint32_t MIL_read(void);
+uint32_t MIL_readMicros(void);
+
+void MIL_timerStart(uint8_t n, uint32_t ms, uint8_t periodic, void (*callback)(void));
+void MIL_timerStop(uint8_t n);
+uint8_t MIL_timerActive(uint8_t n);
+
+void MIL_sleepTicks(uint32_t n);
+
+#if MIL_DLY_SLEEP > 0
+  #define DLY_ticks(n)    MIL_sleepTicks(n)     // DLY_us() and DLY_ms() sleep as well
+#endif
 
 #ifdef __cplusplus
 };
@@ -11,3 +11,8 @@
 
 // NeoPixel defines
 #define NEO_COUNT       8     // total number of pixels in the string
+#define NEO_STREAM      0     // 1: streaming mode for long strings (3 bytes per pixel)
+#define NEO_LUT         1     // encoder - 0: bit loop, 1: nibble table, 2: byte table
+
+// Benchmark
+#define NEO_BENCH       0     // 1: print encoder timing via serial debug on PD5
@@ -12,6 +12,8 @@
 // ------------
 // Shows a colorful animation on a string of 8 NeoPixels. The number of pixels can be
 // changed in config.h. Connect pin PC6 (MOSI) to DIN of the pixels string.
+// If NEO_BENCH is enabled in config.h, the system clock cycles needed to encode one
+// frame are printed once at startup via serial debug on pin PD5 (115200 BAUD).
 //
 // References:
 // -----------
@@ -29,17 +31,48 @@
 // ===================================================================================
 // Libraries, Definitions and Macros
 // ===================================================================================
+#include <config.h>                               // user configurations
 #include <system.h>                               // system functions
 #include <neo_dma.h>                              // NeoPixel functions
+#include <debug_serial.h>                         // serial debug functions
+
+// ===================================================================================
+// Encoder Benchmark (system clock cycles per frame)
+// ===================================================================================
+#if NEO_BENCH > 0
+uint8_t BENCH_frame[3 * NEO_COUNT];
+
+void BENCH_run(void) {
+  uint16_t i;
+  uint32_t t1, t2;
+  for(i=0; i<sizeof(BENCH_frame); i++) BENCH_frame[i] = i;
+  t1 = STK->CNT;
+  for(i=0; i<NEO_COUNT; i++) NEO_writeColor(i, i, i << 1, i << 2);
+  t1 = STK->CNT - t1;
+  t2 = STK->CNT;
+  NEO_writeBuffer(BENCH_frame, 0, NEO_COUNT);
+  t2 = STK->CNT - t2;
+  DEBUG_init();
+  DEBUG_print("NEO_LUT=");            DEBUG_printD(NEO_LUT);
+  DEBUG_print(", pixels=");           DEBUG_printD(NEO_COUNT);
+  DEBUG_print(", writeColor cycles=");  DEBUG_printD(t1);
+  DEBUG_print(", writeBuffer cycles="); DEBUG_printD(t2);
+  DEBUG_newline();
+}
+#endif
 
 // ===================================================================================
 // Main Function
 // ===================================================================================
 int main(void) {
   // Setup
-  uint8_t i, j;
+  uint16_t i;
+  uint8_t j;
   uint8_t nst = 0;
   NEO_init();
+  #if NEO_BENCH > 0
+  BENCH_run();
+  #endif
   
   // Loop
   while(1) {
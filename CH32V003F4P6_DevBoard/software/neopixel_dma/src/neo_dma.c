@@ -1,5 +1,5 @@
 // ===================================================================================
-// Basic NeoPixel Functions using Hardware-SPI and DMA for CH32V003           * v1.0 *
+// Basic NeoPixel Functions using Hardware-SPI and DMA for CH32V003           * v1.3 *
 // ===================================================================================
 // 2023 by Stefan Wagner:   https://github.com/wagiminator
 
@@ -22,10 +22,70 @@
 #error Unsupported system frequency for NeoPixels!
 #endif
 
-uint32_t NEO_buffer[3 * NEO_COUNT];           // pixel buffer
+#if NEO_STREAM == 0
+uint32_t NEO_buffer[3 * NEO_COUNT];           // pixel buffer (SPI bit patterns)
+#define  NEO_DMA_BUF    NEO_buffer            // DMA reads directly from pixel buffer
+#else
+uint8_t  NEO_buffer[3 * NEO_COUNT];           // pixel buffer (color bytes)
+uint32_t NEO_ring[2 * 3 * NEO_CHUNK];         // circular DMA buffer (two halves)
+const uint8_t* NEO_sptr;                      // next color byte to be streamed
+uint8_t  NEO_tail;                            // number of halves filled after data end
+#define  NEO_DMA_BUF    NEO_ring              // DMA reads from ring buffer
+#endif
+
 uint8_t  NEO_TX_flag = 0;                     // transfer running flag
 volatile uint32_t NEO_latch_end;              // latch timer
 
+// ===================================================================================
+// Convert a Color Byte into a SPI Bit Mask
+// ===================================================================================
+// Each pair of color bits becomes one SPI byte (MSB first): 0x44, 0x46, 0x64, 0x66.
+#define NEO_P(x)      (0x44 | (((x) & 1) ? 0x02 : 0) | (((x) & 2) ? 0x20 : 0))
+#define NEO_N(n)      ((uint16_t)(NEO_P((n) >> 2) | (NEO_P((n) & 3) << 8)))
+#define NEO_B(b)      ((uint32_t)NEO_N((b) >> 4) | ((uint32_t)NEO_N((b) & 15) << 16))
+
+#if NEO_LUT == 0
+// Bit loop, no table
+uint32_t NEO_SPI_mask(uint8_t data) {
+  uint8_t i;
+  uint32_t result = 0;                        // bit mask for SPI transmission
+  for(i=4; i; i--, data>>=2) {
+    result <<= 8;
+    if(data & 0x01) result |= 0x06;           // 667us high for "1"-bit
+    else            result |= 0x04;           // 333us high for "0"-bit
+    if(data & 0x02) result |= 0x60;           // 667us high for "1"-bit
+    else            result |= 0x40;           // 333us high for "0"-bit
+  }  
+  return result;
+}
+
+#elif NEO_LUT == 1
+// Nibble lookup table (32 bytes flash)
+const uint16_t NEO_LUT_N[16] = {
+  NEO_N( 0), NEO_N( 1), NEO_N( 2), NEO_N( 3), NEO_N( 4), NEO_N( 5), NEO_N( 6), NEO_N( 7),
+  NEO_N( 8), NEO_N( 9), NEO_N(10), NEO_N(11), NEO_N(12), NEO_N(13), NEO_N(14), NEO_N(15)
+};
+
+static inline uint32_t NEO_SPI_mask(uint8_t data) {
+  return (uint32_t)NEO_LUT_N[data >> 4] | ((uint32_t)NEO_LUT_N[data & 15] << 16);
+}
+
+#elif NEO_LUT == 2
+// Byte lookup table (1024 bytes flash)
+#define NEO_B4(b)     NEO_B(b), NEO_B((b)+1), NEO_B((b)+2), NEO_B((b)+3)
+#define NEO_B16(b)    NEO_B4(b), NEO_B4((b)+4), NEO_B4((b)+8), NEO_B4((b)+12)
+#define NEO_B64(b)    NEO_B16(b), NEO_B16((b)+16), NEO_B16((b)+32), NEO_B16((b)+48)
+
+const uint32_t NEO_LUT_B[256] = {
+  NEO_B64(0), NEO_B64(64), NEO_B64(128), NEO_B64(192)
+};
+
+#define NEO_SPI_mask(data)  NEO_LUT_B[(uint8_t)(data)]
+
+#else
+#error Wrong NEO_LUT setting!
+#endif
+
 // ===================================================================================
 // Init SPI with DMA for Neopixels
 // ===================================================================================
@@ -48,9 +108,13 @@ void NEO_init(void) {
   // Setup DMA Channel 3
   RCC->AHBPCENR |= RCC_DMA1EN;                    // enable DMA module clock
   DMA1_Channel3->PADDR = (uint32_t)&SPI1->DATAR;  // peripheral address
-  DMA1_Channel3->MADDR = (uint32_t)NEO_buffer;    // memory address
+  DMA1_Channel3->MADDR = (uint32_t)NEO_DMA_BUF;   // memory address
   DMA1_Channel3->CFGR  = DMA_CFGR3_MINC           // increment memory address
-                       | DMA_CFGR3_DIR            // memory to I2C
+                       | DMA_CFGR3_DIR            // memory to SPI
+                       #if NEO_STREAM > 0
+                       | DMA_CFGR3_CIRC           // circular mode
+                       | DMA_CFGR3_HTIE           // half transfer interrupt enable
+                       #endif
                        | DMA_CFGR3_TCIE;          // transfer complete interrupt enable
   DMA1->INTFCR         = DMA_CGIF3;               // clear interrupt flags
   NVIC_EnableIRQ(DMA1_Channel3_IRQn);             // enable the DMA IRQ
@@ -61,6 +125,7 @@ void NEO_init(void) {
 // ===================================================================================
 void NEO_latch(void) {
   if(NEO_TX_flag) {
+    while(DMA1_Channel3->CFGR & DMA_CFGR3_EN);// wait until ISR has stopped DMA
     while(SPI1->STATR & SPI_STATR_BSY);       // wait for end of last transmission
     while(((int32_t)(STK->CNT - NEO_latch_end)) < 0); // wait for end of latch
     NEO_TX_flag = 0;                          // clear transmission flag
@@ -71,6 +136,7 @@ void NEO_latch(void) {
 // ===================================================================================
 // Start writing Buffer to Pixels via DMA
 // ===================================================================================
+#if NEO_STREAM == 0
 void NEO_update(void) {
   NEO_latch();                                // make sure last data was latched
   DMA1_Channel3->CNTR  = 12 * NEO_COUNT;      // number of bytes to be transfered
@@ -94,52 +160,122 @@ void DMA1_Channel3_IRQHandler(void) {
 // Clear all Pixels
 // ===================================================================================
 void NEO_clearAll(void) {
-  uint8_t i;
+  uint16_t i;
   uint32_t *ptr;
   ptr = NEO_buffer;
   for(i=3*NEO_COUNT; i; i--) *ptr++ = 0x44444444;
   NEO_update();
 }
 
+#else
+
 // ===================================================================================
-// Convert a Color Byte into a SPI Bit Mask
+// Fill one Half of the Ring Buffer with the next Bit Patterns (zeros after end)
 // ===================================================================================
-uint32_t NEO_SPI_mask(uint8_t data) {
+static void NEO_fill(uint32_t* ptr) {
   uint8_t i;
-  uint32_t result = 0;                        // bit mask for SPI transmission
-  for(i=4; i; i--, data>>=2) {
-    result <<= 8;
-    if(data & 0x01) result |= 0x06;           // 667us high for "1"-bit
-    else            result |= 0x04;           // 333us high for "0"-bit
-    if(data & 0x02) result |= 0x60;           // 667us high for "1"-bit
-    else            result |= 0x40;           // 333us high for "0"-bit
-  }  
-  return result;
+  for(i=3*NEO_CHUNK; i; i--) {
+    if(NEO_sptr < NEO_buffer + sizeof(NEO_buffer)) *ptr++ = NEO_SPI_mask(*NEO_sptr++);
+    else *ptr++ = 0;                          // keep line low after last pixel
+  }
+}
+
+void NEO_update(void) {
+  NEO_latch();                                // make sure last data was latched
+  NEO_sptr = NEO_buffer;                      // start with first color byte
+  NEO_tail = 0;
+  NEO_fill(NEO_ring);                         // fill both halves of ring buffer
+  NEO_fill(NEO_ring + 3 * NEO_CHUNK);
+  DMA1_Channel3->CNTR  = sizeof(NEO_ring);    // number of bytes in ring buffer
+  DMA1_Channel3->CFGR |= DMA_CFGR3_EN;        // enable DMA channel
+  SPI1->CTLR2         |= SPI_CTLR2_TXDMAEN;   // enable DMA request
+  NEO_TX_flag = 1;                            // set transmission flag
+}
+
+// ===================================================================================
+// Interrupt Service Routine (refill the half that has just been transmitted)
+// ===================================================================================
+void DMA1_Channel3_IRQHandler(void) __attribute__((interrupt));
+void DMA1_Channel3_IRQHandler(void) {
+  uint32_t* ptr = (DMA1->INTFR & DMA_HTIF3) ? NEO_ring : NEO_ring + 3 * NEO_CHUNK;
+  DMA1->INTFCR = DMA_CGIF3;                   // clear interrupt flags
+  if((NEO_sptr >= NEO_buffer + sizeof(NEO_buffer)) && NEO_tail++) {
+    SPI1->CTLR2         &= ~SPI_CTLR2_TXDMAEN;// half with last pixel sent -> stop DMA
+    DMA1_Channel3->CFGR &= ~DMA_CFGR3_EN;
+    NEO_latch_end = STK->CNT + ((NEO_LATCH_TIME + 5) * DLY_US_TIME);  // end of latch
+    return;
+  }
+  NEO_fill(ptr);
+}
+
+// ===================================================================================
+// Clear all Pixels
+// ===================================================================================
+void NEO_clearAll(void) {
+  uint16_t i;
+  uint8_t *ptr;
+  ptr = NEO_buffer;
+  for(i=3*NEO_COUNT; i; i--) *ptr++ = 0;
+  NEO_update();
 }
+#endif
 
 // ===================================================================================
 // Write Color to a Single Pixel in Buffer
 // ===================================================================================
-void NEO_writeColor(uint8_t pixel, uint8_t r, uint8_t g, uint8_t b) {
+#if NEO_STREAM == 0
+  #define NEO_encode(c)   NEO_SPI_mask(c)
+#else
+  #define NEO_encode(c)   (c)
+#endif
+
+void NEO_writeColor(uint16_t pixel, uint8_t r, uint8_t g, uint8_t b) {
+  #if NEO_STREAM == 0
   uint32_t *ptr;
+  #else
+  uint8_t  *ptr;
+  #endif
   ptr = NEO_buffer + (3 * pixel);
   #if defined (NEO_GRB)
-    *ptr++ = NEO_SPI_mask(g);
-    *ptr++ = NEO_SPI_mask(r);
-    *ptr   = NEO_SPI_mask(b);
+    *ptr++ = NEO_encode(g);
+    *ptr++ = NEO_encode(r);
+    *ptr   = NEO_encode(b);
   #elif defined (NEO_RGB)
-    *ptr++ = NEO_SPI_mask(r);
-    *ptr++ = NEO_SPI_mask(g);
-    *ptr   = NEO_SPI_mask(b);
+    *ptr++ = NEO_encode(r);
+    *ptr++ = NEO_encode(g);
+    *ptr   = NEO_encode(b);
   #else
     #error Wrong or missing NeoPixel type definition!
   #endif
 }
 
+// ===================================================================================
+// Write RGB Color Buffer (r,g,b,r,g,b,...) of (count) Pixels starting at (first)
+// ===================================================================================
+void NEO_writeBuffer(const uint8_t* rgb, uint16_t first, uint16_t count) {
+  #if NEO_STREAM == 0
+  uint32_t *ptr;
+  #else
+  uint8_t  *ptr;
+  #endif
+  ptr = NEO_buffer + (3 * first);
+  while(count--) {
+    #if defined (NEO_GRB)
+    ptr[0] = NEO_encode(rgb[1]);
+    ptr[1] = NEO_encode(rgb[0]);
+    #else
+    ptr[0] = NEO_encode(rgb[0]);
+    ptr[1] = NEO_encode(rgb[1]);
+    #endif
+    ptr[2] = NEO_encode(rgb[2]);
+    ptr += 3; rgb += 3;
+  }
+}
+
 // ===================================================================================
 // Write Hue Value (0..191) and Brightness (0..2) to a Single Pixel in Buffer
 // ===================================================================================
-void NEO_writeHue(uint8_t pixel, uint8_t hue, uint8_t bright) {
+void NEO_writeHue(uint16_t pixel, uint8_t hue, uint8_t bright) {
   uint8_t phase = hue >> 6;
   uint8_t step  = (hue & 63) << bright;
   uint8_t nstep = (63 << bright) - step;
@@ -154,6 +290,6 @@ void NEO_writeHue(uint8_t pixel, uint8_t hue, uint8_t bright) {
 // ===================================================================================
 // Clear Single Pixel in Buffer
 // ===================================================================================
-void NEO_clearPixel(uint8_t pixel) {
+void NEO_clearPixel(uint16_t pixel) {
   NEO_writeColor(pixel, 0, 0, 0);
 }
@@ -1,5 +1,5 @@
 // ===================================================================================
-// Basic NeoPixel Functions using Hardware-SPI and DMA for CH32V003           * v1.0 *
+// Basic NeoPixel Functions using Hardware-SPI and DMA for CH32V003           * v1.3 *
 // ===================================================================================
 //
 // Functions available:
@@ -9,6 +9,7 @@
 // NEO_clearPixel(p)        clear pixel p
 // NEO_writeColor(p,r,g,b)  write RGB color to pixel p
 // NEO_writeHue(p,h,b)      write hue (h=0..191) and brightness (b=0..2) to pixel p
+// NEO_writeBuffer(*c,p,n)  write n pixels from RGB buffer *c (r,g,b,r,...) from pixel p
 // NEO_update()             update pixels string (write buffer to pixels)
 // NEO_latch()              latch the data sent
 //
@@ -18,6 +19,17 @@
 // - Works with most 800kHz addressable LEDs (NeoPixels).
 // - Set number of pixels and pixel type in the parameters below!
 // - System clock frequency must be 48MHz, 24MHz, 12MHz, or 6MHz.
+// - Buffer modes (NEO_STREAM):
+//   0: every pixel is stored as its 12-byte SPI bit pattern and sent by one DMA
+//      transfer. Fastest update start, but limits the string to about 100 pixels.
+//   1: every pixel is stored as 3 color bytes. The bit patterns are generated on the
+//      fly into a small circular DMA buffer (NEO_CHUNK pixels per half) using the
+//      half- and full-transfer interrupts. Allows strings with 500+ pixels.
+//      Each half lasts NEO_CHUNK * 32us, the interrupt has to refill it within that
+//      time. This requires F_CPU >= 24MHz. Increase NEO_CHUNK if other interrupts
+//      delay the refill.
+// - Color to SPI bit pattern encoder (NEO_LUT):
+//   0: bit loop (no table), 1: nibble table (32 bytes), 2: byte table (1 KB flash).
 //
 // 2023 by Stefan Wagner:   https://github.com/wagiminator
 
@@ -37,6 +49,18 @@ extern "C" {
 #define NEO_COUNT       8     // total number of pixels in the string
 #endif
 
+#ifndef NEO_STREAM
+#define NEO_STREAM      0     // 0: expanded SPI buffer, 1: 3 bytes/pixel streaming mode
+#endif
+
+#ifndef NEO_LUT
+#define NEO_LUT         1     // encoder - 0: bit loop, 1: nibble table, 2: byte table
+#endif
+
+#ifndef NEO_CHUNK
+#define NEO_CHUNK       4     // pixels per half of DMA ring buffer in streaming mode
+#endif
+
 #define NEO_GRB               // type of pixels: NEO_GRB or NEO_RGB
 #define NEO_LATCH_TIME  281   // latch time in microseconds
 
@@ -47,15 +71,21 @@ extern "C" {
   #error Interrupt vector table must be enabled (SYS_USE_VECTORS in system.h)!
 #endif
 
+#if NEO_STREAM > 0 && F_CPU < 24000000
+  #error NeoPixel streaming mode requires F_CPU >= 24MHz (use NEO_STREAM 0)!
+#endif
+
 // ===================================================================================
 // NeoPixel Functions and Macros
 // ===================================================================================
 void NEO_init(void);
 void NEO_update(void);
 void NEO_clearAll(void);
-void NEO_writeColor(uint8_t pixel, uint8_t r, uint8_t g, uint8_t b);
-void NEO_writeHue(uint8_t pixel, uint8_t hue, uint8_t bright);
-void NEO_clearPixel(uint8_t pixel);
+void NEO_latch(void);
+void NEO_writeColor(uint16_t pixel, uint8_t r, uint8_t g, uint8_t b);
+void NEO_writeBuffer(const uint8_t* rgb, uint16_t first, uint16_t count);
+void NEO_writeHue(uint16_t pixel, uint8_t hue, uint8_t bright);
+void NEO_clearPixel(uint16_t pixel);
 
 #ifdef __cplusplus
 };
@@ -21,7 +21,9 @@
 //
 // Connect an SSD1306 128x64 Pixels I2C OLED to PC1 (SDA) and PC2 (SCL). 
 // The implementation utilizes DMA for data transfer to the OLED while simultaneously 
-// computing the next game step.
+// computing the next game step. The game step is computed bit-parallel for 32 cells
+// at once directly on the OLED page-packed buffer, two buffers are swapped for each
+// generation. The number of generations per second is shown on the title line.
 
 #pragma once
 
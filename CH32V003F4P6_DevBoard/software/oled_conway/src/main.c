@@ -1,6 +1,6 @@
 // ===================================================================================
 // Project:   Conway's Game of Life for CH32V003 and SSD1306 128x64 Pixels I2C OLED
-// Version:   v1.0
+// Version:   v1.1
 // Year:      2023
 // Author:    Stefan Wagner
 // Github:    https://github.com/wagiminator
@@ -27,7 +27,9 @@
 //
 // Connect an SSD1306 128x64 Pixels I2C OLED to PC1 (SDA) and PC2 (SCL). 
 // The implementation utilizes DMA for data transfer to the OLED while simultaneously 
-// computing the next game step.
+// computing the next game step. The game step is computed bit-parallel for 32 cells
+// at once directly on the OLED page-packed buffer, two buffers are swapped for each
+// generation. The number of generations per second is shown on the title line.
 //
 // References:
 // -----------
@@ -49,20 +51,35 @@
 #include "system.h"               // system functions
 #include "i2c_dma.h"              // I2C functions with DMA
 
-uint8_t __attribute__ ((aligned(4))) page1[1024], page2[896];  // double screen buffer
+// Game field: 128 x 56 cells on OLED pages 1..7 (OLED page-packed, 4 columns per word)
+#define GAME_PAGES        7       // number of OLED pages of game field
+#define GAME_WORDS        32      // number of 32-bit words per page (128 columns)
+uint32_t GAME_field[2][GAME_PAGES * GAME_WORDS];    // double screen buffer
 
+// Title line (page 0) with space for generations per second counter
+#define GAME_GPS_COL      74      // first column of generations per second counter
+#define GAME_GPS_DIGITS   3       // number of digits of counter
 const uint8_t GAME_TEXT[] = {
-  0x00, 0x3E, 0x41, 0x41, 0x41, 0x22, 0x00, 0x3E, 0x41, 0x41, 0x41, 0x3E,
-  0x00, 0x7F, 0x04, 0x08, 0x10, 0x7F, 0x00, 0x3F, 0x40, 0x38, 0x40, 0x3F,
-  0x00, 0x7C, 0x12, 0x11, 0x12, 0x7C, 0x00, 0x07, 0x08, 0x70, 0x08, 0x07,
-  0x00, 0x00, 0x05, 0x03, 0x00, 0x00, 0x00, 0x46, 0x49, 0x49, 0x49, 0x31,
-  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x3E, 0x41, 0x49, 0x49, 0x7A,
-  0x00, 0x7C, 0x12, 0x11, 0x12, 0x7C, 0x00, 0x7F, 0x02, 0x0C, 0x02, 0x7F,
-  0x00, 0x7F, 0x49, 0x49, 0x49, 0x41, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-  0x00, 0x3E, 0x41, 0x41, 0x41, 0x3E, 0x00, 0x7F, 0x09, 0x09, 0x09, 0x01,
-  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x7F, 0x40, 0x40, 0x40, 0x40,
-  0x00, 0x00, 0x41, 0x7F, 0x41, 0x00, 0x00, 0x7F, 0x09, 0x09, 0x09, 0x01,
-  0x00, 0x7F, 0x49, 0x49, 0x49, 0x41
+  0x00, 0x3E, 0x41, 0x49, 0x49, 0x7A, 0x00, 0x7C, 0x12, 0x11, 0x12, 0x7C,
+  0x00, 0x7F, 0x02, 0x0C, 0x02, 0x7F, 0x00, 0x7F, 0x49, 0x49, 0x49, 0x41,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x3E, 0x41, 0x41, 0x41, 0x3E,
+  0x00, 0x7F, 0x09, 0x09, 0x09, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x7F, 0x40, 0x40, 0x40, 0x40, 0x00, 0x00, 0x41, 0x7F, 0x41, 0x00,
+  0x00, 0x7F, 0x09, 0x09, 0x09, 0x01, 0x00, 0x7F, 0x49, 0x49, 0x49, 0x41,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x3E, 0x41, 0x49, 0x49, 0x7A, 0x00, 0x7F, 0x49, 0x49,
+  0x49, 0x41, 0x00, 0x7F, 0x04, 0x08, 0x10, 0x7F, 0x00, 0x20, 0x10, 0x08,
+  0x04, 0x02, 0x00, 0x46, 0x49, 0x49, 0x49, 0x31
+};
+
+// Digits 0..9 (6 columns each) for generations per second counter
+const uint8_t GAME_DIGITS[] = {
+  0x00, 0x3E, 0x51, 0x49, 0x45, 0x3E, 0x00, 0x00, 0x42, 0x7F, 0x40, 0x00,
+  0x00, 0x42, 0x61, 0x51, 0x49, 0x46, 0x00, 0x21, 0x41, 0x45, 0x4B, 0x31,
+  0x00, 0x18, 0x14, 0x12, 0x7F, 0x10, 0x00, 0x27, 0x45, 0x45, 0x45, 0x39,
+  0x00, 0x3C, 0x4A, 0x49, 0x49, 0x30, 0x00, 0x01, 0x71, 0x09, 0x05, 0x03,
+  0x00, 0x36, 0x49, 0x49, 0x49, 0x36, 0x00, 0x06, 0x49, 0x49, 0x29, 0x1E
 };
 
 // ===================================================================================
@@ -99,47 +116,105 @@ uint32_t random(uint32_t max) {
 // Conway's Game of Life
 // ===================================================================================
 
-// Get pixel from source screen buffer
-uint8_t getpixel(uint8_t xpos, uint8_t ypos) {
-  xpos &= 127;
-  if(ypos == 56)  ypos = 0;
-  if(ypos == 255) ypos = 55;
-  return((page1[((uint16_t)ypos >> 3) * 128 + 128 + xpos] >> (ypos & 7)) & 1);
+// Set pixel on game field
+void setpixel(uint32_t* field, uint8_t xpos, uint8_t ypos) {
+  ((uint8_t*)field)[((uint16_t)ypos >> 3) * 128 + xpos] |= ((uint8_t)1 << (ypos & 7));
 }
 
-// Set pixel on destination screen buffer
-void setpixel(uint8_t xpos, uint8_t ypos) {
-  page2[((uint16_t)ypos >> 3) * 128 + xpos] |= ((uint8_t)1 << (ypos & 7));
-}
+// Calculate next game step (bit-parallel, 32 cells per word, toroidal field)
+// Each word holds 8 rows (bits) of 4 columns (bytes). Vertical neighbors are found
+// by shifting each byte by one bit, horizontal neighbors by shifting the word by
+// one byte. The neighbor counts of all 32 cells are then summed up using word-wide
+// full adders.
+void calculate(const uint32_t* src, uint32_t* dst) {
+  for(uint8_t p = 0; p < GAME_PAGES; p++) {
+    const uint32_t* cur = src + p * GAME_WORDS;
+    const uint32_t* up  = src + (p ? p - 1 : GAME_PAGES - 1) * GAME_WORDS;
+    const uint32_t* dn  = src + (p < GAME_PAGES - 1 ? p + 1 : 0) * GAME_WORDS;
+    uint32_t c[3], lo[3], hi[3], v2lo, v2hi;
+
+    // Vertical sums (lo: bit 0, hi: bit 1) of a column word: v2 excludes the cell
+    // itself (used for the cell's own column), v3 includes it (neighbor columns)
+    #define GAME_VSUM(k, i) {                                               \
+      uint32_t w = cur[i];                                                  \
+      uint32_t n = ((w << 1) & 0xFEFEFEFE) | ((up[i] >> 7) & 0x01010101);   \
+      uint32_t s = ((w >> 1) & 0x7F7F7F7F) | ((dn[i] << 7) & 0x80808080);   \
+      c[k] = w; v2lo = n ^ s; v2hi = n & s;                                 \
+      lo[k] = v2lo ^ w; hi[k] = v2hi | (v2lo & w);                          \
+    }
+
+    GAME_VSUM(0, GAME_WORDS - 1);                 // left  word (wraps around)
+    GAME_VSUM(1, 0);                              // center word
+    for(uint8_t i = 0; i < GAME_WORDS; i++) {
+      uint32_t cvlo = v2lo, cvhi = v2hi;          // vertical pair sum of center word
+      GAME_VSUM(2, (i + 1) & (GAME_WORDS - 1));   // right word
+
+      // Column sums of left and right neighbor columns
+      uint32_t llo = (lo[1] << 8) | (lo[0] >> 24);
+      uint32_t lhi = (hi[1] << 8) | (hi[0] >> 24);
+      uint32_t rlo = (lo[1] >> 8) | (lo[2] << 24);
+      uint32_t rhi = (hi[1] >> 8) | (hi[2] << 24);
 
-// Calculate next game step
-void calculate(void) {
-  for(uint16_t i=0; i<896; i++) page2[i] = 0;
-  for(uint8_t y=0; y<56; y++) {
-    for(uint8_t x=0; x<128; x++) {
-      uint8_t neighbors = getpixel(x-1, y-1) \
-                        + getpixel(x  , y-1) \
-                        + getpixel(x+1, y-1) \
-                        + getpixel(x-1, y  ) \
-                        + getpixel(x+1, y  ) \
-                        + getpixel(x-1, y+1) \
-                        + getpixel(x  , y+1) \
-                        + getpixel(x+1, y+1);
-      if((getpixel(x,y) == 1) && (neighbors >= 2) && (neighbors <= 3)) setpixel(x,y);
-      if((getpixel(x,y) == 0) && (neighbors == 3)) setpixel(x,y);
+      // Add up: ones of left, right, center -> bit 0 and carry
+      uint32_t s0 = llo ^ rlo ^ cvlo;
+      uint32_t k  = (llo & rlo) | (cvlo & (llo ^ rlo));
+
+      // Add up twos: bit 1 and whether there are at least two of them (count >= 4)
+      uint32_t s1  = lhi ^ rhi ^ cvhi ^ k;
+      uint32_t ge4 = ((lhi | rhi) & (cvhi | k)) | (lhi & rhi) | (cvhi & k);
+
+      // Cell lives with 3 neighbors or with 2 neighbors if already alive
+      dst[p * GAME_WORDS + i] = s1 & ~ge4 & (s0 | c[1]);
+
+      // Slide window to the right
+      c[0] = c[1]; lo[0] = lo[1]; hi[0] = hi[1];
+      c[1] = c[2]; lo[1] = lo[2]; hi[1] = hi[2];
     }
+    #undef GAME_VSUM
+  }
+}
+
+// ===================================================================================
+// OLED Functions
+// ===================================================================================
+// Send command sequence to OLED
+void OLED_command(const uint8_t* cmd, uint8_t len) {
+  I2C_start(OLED_ADDR);                   // start transmission to OLED
+  I2C_write(OLED_CMD_MODE);               // set command mode
+  while(len--) I2C_write(*cmd++);         // send commands
+  I2C_stop();                             // stop transmission
+}
+
+// Set OLED drawing window (columns x0..x1, pages p0..p1)
+void OLED_window(uint8_t x0, uint8_t x1, uint8_t p0, uint8_t p1) {
+  uint8_t cmd[6] = {0x21, x0, x1, 0x22, p0, p1};
+  OLED_command(cmd, sizeof(cmd));
+}
+
+// Show generations per second counter on title line
+void showGPS(uint16_t gps) {
+  uint8_t buf[6 * GAME_GPS_DIGITS];
+  for(uint8_t d = GAME_GPS_DIGITS; d--; gps /= 10) {
+    for(uint8_t i = 0; i < 6; i++)
+      buf[d * 6 + i] = (gps || d == GAME_GPS_DIGITS - 1) ? GAME_DIGITS[(gps % 10) * 6 + i] : 0;
   }
-  for(uint16_t i=0; i<896; i++) page1[i + 128] = page2[i];
+  OLED_window(GAME_GPS_COL, GAME_GPS_COL + sizeof(buf) - 1, 0, 0);
+  I2C_start(OLED_ADDR);                   // start transmission to OLED
+  I2C_write(OLED_DAT_MODE);               // set data mode
+  for(uint8_t i = 0; i < sizeof(buf); i++) I2C_write(buf[i]);
+  I2C_stop();                             // stop transmission
 }
 
 // ===================================================================================
 // Main Function
 // ===================================================================================
 int main(void) {
+  uint8_t  cur = 0;                       // index of current game field
+  uint16_t gens = 0;                      // generations since last counter update
+  uint32_t time;                          // time of last counter update
+
   // Setup start screen
-  for(uint16_t i=768; i; i--) setpixel(random(128), random(56));
-  for(uint16_t i=0; i<896; i++) page1[i + 128] = page2[i];
-  for(uint16_t i=0; i<sizeof(GAME_TEXT); i++) page1[i] = GAME_TEXT[i];
+  for(uint16_t i=768; i; i--) setpixel(GAME_field[0], random(128), random(56));
   
   // Init OLED
   I2C_init();                             // initialize I2C first
@@ -148,11 +223,31 @@ int main(void) {
   I2C_write(OLED_CMD_MODE);               // set command mode
   I2C_writeBuffer((uint8_t*)OLED_INIT_CMD, sizeof(OLED_INIT_CMD)); // send init sequence
 
+  // Draw title line
+  OLED_window(0, 127, 0, 0);
+  I2C_start(OLED_ADDR);                   // start transmission to OLED
+  I2C_write(OLED_DAT_MODE);               // set data mode
+  I2C_writeBuffer((uint8_t*)GAME_TEXT, sizeof(GAME_TEXT)); // send title using DMA
+  time = STK->CNT;
+
   // Loop
   while(1) {
-    calculate();                          // calculate next game step
+    // Send current game field to OLED using DMA
+    OLED_window(0, 127, 1, GAME_PAGES);   // waits for last transfer to complete
     I2C_start(OLED_ADDR);                 // start transmission to OLED
     I2C_write(OLED_DAT_MODE);             // set data mode
-    I2C_writeBuffer(page1, 1024);         // send screen buffer using DMA
+    I2C_writeBuffer((uint8_t*)GAME_field[cur], sizeof(GAME_field[0]));
+
+    // Calculate next game step into the other buffer while the current is sent
+    calculate(GAME_field[cur], GAME_field[cur ^ 1]);
+    cur ^= 1;                             // swap buffers
+
+    // Update generations per second counter once per second
+    gens++;
+    if((STK->CNT - time) >= F_CPU) {
+      time += F_CPU;
+      showGPS(gens);
+      gens = 0;
+    }
   }
 }
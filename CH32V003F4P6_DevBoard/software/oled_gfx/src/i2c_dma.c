@@ -1,5 +1,5 @@
 // ===================================================================================
-// Basic I2C Master Functions with DMA for TX for CH32V003                    * v1.1 *
+// Basic I2C Master Functions with DMA for TX for CH32V003                    * v1.4 *
 // ===================================================================================
 // 2023 by Stefan Wagner:   https://github.com/wagiminator
 
@@ -8,6 +8,22 @@
 // Read/write flag
 uint8_t I2C_rwflag;
 
+// Transaction queue and state
+I2C_TRANS* volatile I2C_head;                     // current transaction (queue head)
+I2C_TRANS* volatile I2C_tail;                     // last transaction in queue
+volatile uint8_t I2C_dmaflag;                     // I2C_writeBuffer() DMA in progress
+volatile uint8_t I2C_deferred;                    // next START waits for pending STOP
+uint8_t I2C_qstate;                               // state of current transaction
+uint8_t I2C_hptr;                                 // header byte pointer
+
+// Transaction states
+#define I2C_Q_ADDR_W    0                         // START sent, waiting to send write address
+#define I2C_Q_ADDR_R    1                         // START sent, waiting to send read address
+#define I2C_Q_HEADER    2                         // sending header bytes
+#define I2C_Q_TX        3                         // writing data via DMA
+#define I2C_Q_LAST      4                         // waiting for last byte transmitted
+#define I2C_Q_RX        5                         // reading data via DMA or interrupt
+
 // Init I2C
 void I2C_init(void) {
   // Setup GPIO pins
@@ -43,7 +59,7 @@ void I2C_init(void) {
   #endif
   I2C1->CTLR1   = I2C_CTLR1_PE;                   // enable I2C
 
-  // Setup DMA Channel 5
+  // Setup DMA Channel 6
   RCC->AHBPCENR |= RCC_DMA1EN;                    // enable DMA module clock
   DMA1_Channel6->PADDR = (uint32_t)&I2C1->DATAR;  // peripheral address
   DMA1_Channel6->CFGR  = DMA_CFG6_MINC            // increment memory address
@@ -51,12 +67,22 @@ void I2C_init(void) {
                        | DMA_CFG6_TCIE;           // transfer complete interrupt enable
   DMA1->INTFCR         = DMA_CGIF6;               // clear interrupt flags
   NVIC_EnableIRQ(DMA1_Channel6_IRQn);             // enable the DMA IRQ
+
+  // Setup DMA Channel 7 (used by queued read transactions)
+  DMA1_Channel7->PADDR = (uint32_t)&I2C1->DATAR;  // peripheral address
+  DMA1_Channel7->CFGR  = DMA_CFG7_MINC            // increment memory address
+                       | DMA_CFG7_TCIE;           // transfer complete interrupt enable
+  DMA1->INTFCR         = DMA_CGIF7;               // clear interrupt flags
+  NVIC_EnableIRQ(DMA1_Channel7_IRQn);             // enable the DMA IRQ
+  NVIC_EnableIRQ(I2C1_EV_IRQn);                   // enable I2C event IRQ
+  NVIC_EnableIRQ(I2C1_ER_IRQn);                   // enable I2C error IRQ
 }
 
 // Start I2C transmission (addr must contain R/W bit)
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wunused-variable"
 void I2C_start(uint8_t addr) {
+  while(I2C_head || I2C_dmaflag) I2C_poll();      // wait until queue is empty
   while(I2C1->STAR2 & I2C_STAR2_BUSY);            // wait until bus ready
   I2C1->CTLR1 |= I2C_CTLR1_START                  // set START condition
                | I2C_CTLR1_ACK;                   // set ACK
@@ -94,20 +120,207 @@ void I2C_stop(void) {
 
 // Send data buffer via I2C bus using DMA
 void I2C_writeBuffer(uint8_t* buf, uint16_t len) {
+  I2C_dmaflag          = 1;                       // DMA transfer in progress
+  I2C_rwflag           = 1;                       // STOP is set by interrupt
   DMA1_Channel6->CNTR  = len;                     // number of bytes to be transfered
   DMA1_Channel6->MADDR = (uint32_t)buf;           // memory address
   DMA1_Channel6->CFGR |= DMA_CFG6_EN;             // enable DMA channel
-  I2C1->CTLR2         |= I2C_CTLR2_DMAEN;         // enable DMA request
+  I2C1->CTLR2         |= I2C_CTLR2_DMAEN          // enable DMA request
+                       | I2C_CTLR2_ITERREN;       // enable error interrupt
+}
+
+// ===================================================================================
+// Queued Transactions
+// ===================================================================================
+
+// Start current transaction at the head of the queue
+static void I2C_next(void) {
+  I2C_TRANS* t = I2C_head;
+  uint32_t   n = I2C_STOP_WAIT;
+  while((I2C1->CTLR1 & I2C_CTLR1_STOP) && --n);   // wait for previous STOP (bounded)
+  if(I2C1->CTLR1 & I2C_CTLR1_STOP) {              // still pending (SCL held low)?
+    I2C_deferred = 1;                             // -> start later by I2C_poll()
+    return;
+  }
+  I2C_deferred = 0;
+  I2C_hptr   = 0;
+  I2C_qstate = ((t->addr & 1) && !t->hlen) ? I2C_Q_ADDR_R : I2C_Q_ADDR_W;
+  I2C1->CTLR2 |= I2C_CTLR2_ITEVTEN                // enable event interrupt
+               | I2C_CTLR2_ITERREN;               // enable error interrupt
+  I2C1->CTLR1 |= I2C_CTLR1_START                  // set START condition
+               | I2C_CTLR1_ACK;                   // set ACK
+}
+
+// Finish current transaction and start the next one
+static void I2C_finish(uint8_t status) {
+  I2C_TRANS* t = I2C_head;
+  I2C1->CTLR2 &= ~(I2C_CTLR2_ITEVTEN | I2C_CTLR2_ITERREN | I2C_CTLR2_ITBUFEN
+                 | I2C_CTLR2_DMAEN   | I2C_CTLR2_LAST);
+  I2C_head  = t->next;                            // remove from queue
+  t->status = status;                             // set status
+  if(t->callback) t->callback(t);                 // call callback function
+  if(I2C_head) I2C_next();                        // start next transaction
+}
+
+// Start deferred transaction after the previous STOP condition was generated
+void I2C_poll(void) {
+  if(I2C_deferred && !(I2C1->CTLR1 & I2C_CTLR1_STOP)) {
+    INT_ATOMIC_BLOCK {
+      if(I2C_deferred && I2C_head) I2C_next();
+    }
+  }
+}
+
+// Append transaction to queue
+void I2C_submit(I2C_TRANS* t) {
+  t->status = I2C_PENDING;
+  t->next   = 0;
+  INT_ATOMIC_BLOCK {
+    if(I2C_head) I2C_tail->next = t;              // append to queue
+    else {
+      I2C_head = t;                               // queue was empty
+      if(!I2C_dmaflag) I2C_next();                // start now if bus not in use
+    }
+    I2C_tail = t;
+  }
+  I2C_poll();                                     // restart a deferred transaction
+}
+
+// Send next header byte, then continue with data phase
+static void I2C_header(I2C_TRANS* t) {
+  if(I2C_hptr < t->hlen) {
+    I2C1->DATAR = t->header[I2C_hptr++];          // send header byte
+    if(I2C_hptr < t->hlen) {
+      I2C_qstate   = I2C_Q_HEADER;                // more header bytes to follow
+      I2C1->CTLR2 |= I2C_CTLR2_ITBUFEN;           // -> interrupt on TXE
+      return;
+    }
+  }
+  I2C1->CTLR2 &= ~I2C_CTLR2_ITBUFEN;
+  if(!I2C_hptr && !t->len) {                      // nothing to write (ACK poll)?
+    I2C1->CTLR1 |= I2C_CTLR1_STOP;                // -> STOP right after address
+    I2C_finish(I2C_DONE);
+    return;
+  }
+  if(!(t->addr & 1) && t->len) {                  // data to write?
+    I2C_qstate           = I2C_Q_TX;
+    DMA1_Channel6->CNTR  = t->len;                // number of bytes to be transfered
+    DMA1_Channel6->MADDR = (uint32_t)t->buf;      // memory address
+    DMA1_Channel6->CFGR |= DMA_CFG6_EN;           // enable DMA channel
+    I2C1->CTLR2         |= I2C_CTLR2_DMAEN;       // enable DMA request
+  }
+  else I2C_qstate = I2C_Q_LAST;                   // wait for BTF (STOP or repeated START)
+}
+
+// I2C event interrupt service routine
+void I2C1_EV_IRQHandler(void) __attribute__((interrupt));
+void I2C1_EV_IRQHandler(void) {
+  uint16_t   star1 = I2C1->STAR1;
+  I2C_TRANS* t     = I2C_head;
+
+  // Last byte of I2C_writeBuffer() transmitted
+  if(I2C_dmaflag) {
+    if(star1 & I2C_STAR1_BTF) {
+      I2C1->CTLR1 |= I2C_CTLR1_STOP;              // set STOP condition
+      I2C1->CTLR2 &= ~(I2C_CTLR2_ITEVTEN | I2C_CTLR2_ITERREN); // disable interrupts
+      I2C_dmaflag  = 0;
+      if(I2C_head) I2C_next();                    // start queued transactions
+    }
+    return;
+  }
+  if(!t) return;
+
+  // START condition generated -> send slave address
+  if(star1 & I2C_STAR1_SB) {
+    I2C1->DATAR = (I2C_qstate == I2C_Q_ADDR_R) ? (t->addr | 1) : (t->addr & 0xFE);
+    return;
+  }
+
+  // Slave address acknowledged
+  if(star1 & I2C_STAR1_ADDR) {
+    if(I2C_qstate == I2C_Q_ADDR_R) {
+      I2C_qstate = I2C_Q_RX;
+      if(t->len > 1) {                            // read via DMA
+        DMA1_Channel7->CNTR  = t->len;
+        DMA1_Channel7->MADDR = (uint32_t)t->buf;
+        DMA1_Channel7->CFGR |= DMA_CFG7_EN;
+        I2C1->CTLR2 |= I2C_CTLR2_DMAEN | I2C_CTLR2_LAST; // NAK after last byte
+        (void)I2C1->STAR2;                        // clear ADDR flag
+      }
+      else {                                      // read single byte (or none)
+        I2C1->CTLR1 &= ~I2C_CTLR1_ACK;            // set NAK before ADDR is cleared
+        (void)I2C1->STAR2;                        // clear ADDR flag
+        I2C1->CTLR1 |= I2C_CTLR1_STOP;            // set STOP condition
+        if(!t->len) I2C_finish(I2C_DONE);
+        else I2C1->CTLR2 |= I2C_CTLR2_ITBUFEN;    // -> interrupt on RXNE
+      }
+      return;
+    }
+    (void)I2C1->STAR2;                            // clear ADDR flag
+    I2C_header(t);
+    return;
+  }
+
+  // Receive single byte
+  if((I2C_qstate == I2C_Q_RX) && (star1 & I2C_STAR1_RXNE)) {
+    *t->buf = I2C1->DATAR;
+    I2C_finish(I2C_DONE);
+    return;
+  }
+
+  // Transmit next header byte
+  if((I2C_qstate == I2C_Q_HEADER) && (star1 & I2C_STAR1_TXE)) {
+    I2C_header(t);
+    return;
+  }
+
+  // Last byte transmitted -> STOP or repeated START for reading
+  if((I2C_qstate == I2C_Q_LAST) && (star1 & I2C_STAR1_BTF)) {
+    if(t->addr & 1) {
+      I2C_qstate   = I2C_Q_ADDR_R;
+      I2C1->CTLR1 |= I2C_CTLR1_START;             // set repeated START condition
+      return;
+    }
+    I2C1->CTLR1 |= I2C_CTLR1_STOP;                // set STOP condition
+    I2C_finish(I2C_DONE);
+  }
 }
 
-// Interrupt service routine
+// I2C error interrupt service routine
+void I2C1_ER_IRQHandler(void) __attribute__((interrupt));
+void I2C1_ER_IRQHandler(void) {
+  uint16_t star1 = I2C1->STAR1;
+  I2C1->STAR1 = ~(I2C_STAR1_AF | I2C_STAR1_ARLO | I2C_STAR1_BERR | I2C_STAR1_OVR);
+  DMA1_Channel6->CFGR &= ~DMA_CFG6_EN;            // stop DMA channels
+  DMA1_Channel7->CFGR &= ~DMA_CFG7_EN;
+  if(!(star1 & I2C_STAR1_ARLO)) I2C1->CTLR1 |= I2C_CTLR1_STOP; // release bus
+  if(I2C_dmaflag) {                               // I2C_writeBuffer() failed?
+    I2C1->CTLR2 &= ~(I2C_CTLR2_ITEVTEN | I2C_CTLR2_ITERREN | I2C_CTLR2_DMAEN);
+    DMA1->INTFCR = DMA_CGIF6;                     // -> clear DMA interrupt flags
+    I2C_dmaflag  = 0;                             // -> release bus for the queue
+    if(I2C_head) I2C_next();                      // -> start queued transactions
+    return;
+  }
+  if(I2C_head) I2C_finish((star1 & I2C_STAR1_AF) ? I2C_NACK : I2C_ERROR);
+}
+
+// DMA channel 6 (TX) interrupt service routine
 void DMA1_Channel6_IRQHandler(void) __attribute__((interrupt));
 void DMA1_Channel6_IRQHandler(void) {
   I2C1->CTLR2         &= ~I2C_CTLR2_DMAEN;        // disable DMA request
   DMA1_Channel6->CFGR &= ~DMA_CFG6_EN;            // disable DMA channel
   DMA1->INTFCR         = DMA_CGIF6;               // clear interrupt flags
-  while(!(I2C1->STAR1 & I2C_STAR1_BTF));          // wait for last byte transmitted
+  I2C_qstate           = I2C_Q_LAST;              // wait for last byte transmitted
+  I2C1->CTLR2         |= I2C_CTLR2_ITEVTEN;       // -> interrupt on BTF
+}
+
+// DMA channel 7 (RX) interrupt service routine
+void DMA1_Channel7_IRQHandler(void) __attribute__((interrupt));
+void DMA1_Channel7_IRQHandler(void) {
+  DMA1_Channel7->CFGR &= ~DMA_CFG7_EN;            // disable DMA channel
+  DMA1->INTFCR         = DMA_CGIF7;               // clear interrupt flags
   I2C1->CTLR1         |= I2C_CTLR1_STOP;          // set STOP condition
+  I2C_finish(I2C_DONE);
 }
 
 // Read data via I2C bus to buffer and stop
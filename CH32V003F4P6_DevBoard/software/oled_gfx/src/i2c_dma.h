@@ -1,5 +1,5 @@
 // ===================================================================================
-// Basic I2C Master Functions with DMA for TX for CH32V003                    * v1.0 *
+// Basic I2C Master Functions with DMA for TX for CH32V003                    * v1.4 *
 // ===================================================================================
 //
 // Functions available:
@@ -12,6 +12,36 @@
 //
 // I2C_writeBuffer(buf,len) Send buffer (*buf) with length (len) via I2C/DMA and stop
 //
+// Queued transactions (non-blocking, interrupt/DMA-driven):
+// ---------------------------------------------------------
+// I2C_submit(*t)           Append transaction descriptor (*t) to queue and return
+// I2C_done(*t)             Check if transaction (*t) is finished (status != I2C_PENDING)
+// I2C_wait(*t)             Wait until transaction (*t) is finished
+// I2C_idle()               Check if transaction queue is empty
+// I2C_flush()              Wait until all queued transactions are finished
+// I2C_poll()               Start next transaction if it waits for the previous STOP
+//
+// Transaction descriptor (I2C_TRANS):
+// -----------------------------------
+// addr       slave address incl. R/W bit (e.g. (0x50<<1) | 1 for read)
+// hlen       number of header bytes to write first (0..I2C_HEADER_SIZE)
+// header[]   header bytes (e.g. command byte, register or memory address)
+// buf, len   data buffer and its length to write (R/W bit = 0) or read (R/W bit = 1)
+// callback   function called from the interrupt when finished (or NULL)
+// status     I2C_PENDING while queued, I2C_DONE when finished, I2C_NACK/I2C_ERROR on fail
+//
+// For reads with header bytes, the header is written first followed by a repeated
+// START and the read. A write with hlen = 0 and len = 0 just addresses the slave and
+// can be used to poll for its ACK. The descriptor and buffer must remain valid until
+// the transaction is finished. Callbacks run in interrupt context; they may submit
+// further transactions but must not use the blocking functions above.
+// Queued transactions are chained from the interrupts: the STOP condition of the
+// previous transaction takes about one SCL period, the interrupt waits for it at most
+// I2C_STOP_WAIT loops before it sets the next START. Only if the STOP is still pending
+// then (e.g. a slave holds SCL low), the START is issued later by I2C_poll(), which is
+// called by I2C_done(), I2C_wait(), I2C_idle(), I2C_flush(), I2C_submit() and
+// I2C_start().
+//
 // I2C pin mapping (set below in I2C parameters):
 // ----------------------------------------------
 // I2C_MAP    0     1     2
@@ -38,6 +68,29 @@ extern "C" {
   #error Interrupt vector table must be enabled (SYS_USE_VECTORS in system.h)!
 #endif
 
+// I2C Transaction Parameters
+#define I2C_HEADER_SIZE   4         // max number of header bytes per transaction
+#define I2C_STOP_WAIT     (2 * F_CPU / I2C_CLKRATE) // max loops waiting for STOP in ISR
+
+// I2C Transaction Status
+#define I2C_PENDING       0         // transaction queued or in progress
+#define I2C_DONE          1         // transaction finished successfully
+#define I2C_NACK          2         // slave did not acknowledge
+#define I2C_ERROR         3         // bus error or arbitration lost
+
+// I2C Transaction Descriptor
+typedef struct I2C_TRANS I2C_TRANS;
+struct I2C_TRANS {
+  uint8_t   addr;                   // slave address incl. R/W bit
+  uint8_t   hlen;                   // number of header bytes
+  uint8_t   header[I2C_HEADER_SIZE];// header bytes (written before data)
+  uint8_t*  buf;                    // pointer to data buffer
+  uint16_t  len;                    // number of data bytes
+  void    (*callback)(I2C_TRANS*);  // called when finished (or NULL)
+  volatile uint8_t status;          // transaction status (see above)
+  I2C_TRANS* volatile next;         // (internal) next transaction in queue
+};
+
 // I2C Functions
 void I2C_init(void);              // I2C init function
 void I2C_start(uint8_t addr);     // I2C start transmission, addr must contain R/W bit
@@ -48,7 +101,16 @@ uint8_t I2C_read(uint8_t ack);    // I2C receive one data byte from the slave
 void I2C_writeBuffer(uint8_t* buf, uint16_t len);
 void I2C_readBuffer(uint8_t* buf, uint16_t len);
 
+void I2C_submit(I2C_TRANS* t);    // append transaction to queue
+void I2C_poll(void);              // start deferred transaction
+
+extern I2C_TRANS* volatile I2C_head;
+
 #define I2C_busy()                (I2C1->STAR2 & I2C_STAR2_BUSY)
+#define I2C_idle()                (I2C_poll(), !I2C_head)
+#define I2C_flush()               while(!I2C_idle())
+#define I2C_done(t)               (I2C_poll(), (t)->status != I2C_PENDING)
+#define I2C_wait(t)               while(!I2C_done(t))
 
 #ifdef __cplusplus
 };
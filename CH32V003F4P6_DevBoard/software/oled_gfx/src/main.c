@@ -131,26 +131,26 @@ int main(void) {
     OLED_clear();
     for(i = 200; i; i--) {
       OLED_drawLine(random(OLED_WIDTH), random(OLED_HEIGHT), random(OLED_WIDTH), random(OLED_HEIGHT), 1);
-      OLED_refresh();
+      OLED_refreshDirty();
     }
 
     OLED_clear();
     for(i = 200; i; i--) {
       OLED_drawRect(random(OLED_WIDTH), random(OLED_HEIGHT), random(OLED_WIDTH/2), random(OLED_HEIGHT/2), 1);
-      OLED_refresh();
+      OLED_refreshDirty();
     }
 
     OLED_clear();
     for(i = 200; i; i--) {
       OLED_drawCircle(random(OLED_WIDTH), random(OLED_HEIGHT), random(16), 1);
-      OLED_refresh();
+      OLED_refreshDirty();
     }
 
     for(i = 200; i; i--) {
       OLED_cursor(random(OLED_WIDTH), random(OLED_HEIGHT));
       OLED_textinvert(random(2)); OLED_textsize(random(3) + 1);
       OLED_print("Hello");
-      OLED_refresh();
+      OLED_refreshDirty();
     }
     OLED_textinvert(0);
   }
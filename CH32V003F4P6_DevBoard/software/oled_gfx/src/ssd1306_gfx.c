@@ -1,5 +1,5 @@
 // ===================================================================================
-// SSD1306/SH1106 I2C OLED Graphics Functions                                 * v1.6 *
+// SSD1306/SH1106 I2C OLED Graphics Functions                                 * v2.0 *
 // ===================================================================================
 // 2024 by Stefan Wagner:   https://github.com/wagiminator
 
@@ -19,6 +19,40 @@ uint8_t __attribute__ ((aligned(4))) OLED_buffer[OLED_WIDTH * OLED_HEIGHT / 8];
   uint8_t* OLED_sendbuffer = OLED_buffer2;
 #endif
 
+// ===================================================================================
+// Dirty Region Tracking (column span per page)
+// ===================================================================================
+#define OLED_PAGE_NUM   (OLED_HEIGHT / 8)
+
+#if OLED_DIRTY > 0
+uint8_t OLED_dirtyX0[OLED_PAGE_NUM];                // first dirty column of each page
+uint8_t OLED_dirtyX1[OLED_PAGE_NUM];                // last dirty column of each page
+
+// Mark column (x) in page (p) as dirty
+static inline void OLED_markDirty(uint8_t p, uint8_t x) {
+  if(x < OLED_dirtyX0[p]) OLED_dirtyX0[p] = x;
+  if(x > OLED_dirtyX1[p]) OLED_dirtyX1[p] = x;
+}
+
+// Mark columns (x0..x1) in page (p) as dirty
+static inline void OLED_markSpan(uint8_t p, uint8_t x0, uint8_t x1) {
+  if(x0 < OLED_dirtyX0[p]) OLED_dirtyX0[p] = x0;
+  if(x1 > OLED_dirtyX1[p]) OLED_dirtyX1[p] = x1;
+}
+
+// Mark (all) or clean (none) the complete screen
+static void OLED_markScreen(uint8_t all) {
+  for(uint8_t p=0; p<OLED_PAGE_NUM; p++) {
+    OLED_dirtyX0[p] = all ? 0 : 0xFF;
+    OLED_dirtyX1[p] = all ? OLED_WIDTH - 1 : 0;
+  }
+}
+#else
+  #define OLED_markDirty(p, x)
+  #define OLED_markSpan(p, x0, x1)
+  #define OLED_markScreen(all)
+#endif
+
 // ===================================================================================
 // Standard ASCII 5x8 Font (chars 32 - 127)
 // ===================================================================================
@@ -173,6 +207,7 @@ void OLED_init(void) {
   I2C_write(OLED_CMD_MODE);                       // set command mode
   I2C_writeBuffer((uint8_t*)OLED_INIT_CMD, sizeof(OLED_INIT_CMD)); // send the command bytes
   I2C_stop();                                     // stop transmission
+  OLED_markScreen(1);                             // display RAM is undefined after boot
 }
 
 // Switch display on/off (0: display off, 1: display on)
@@ -228,6 +263,21 @@ void OLED_home(uint8_t x, uint8_t y) {
   I2C_stop();                                     // stop transmission
 }
 
+// Set column (x0..x1) and page (p0..p1) window for following data (SSD1306 only)
+#if OLED_DIRTY > 0 && OLED_SH1106 == 0 && OLED_WIDTH != 64
+static void OLED_window(uint8_t x0, uint8_t x1, uint8_t p0, uint8_t p1) {
+  I2C_start(OLED_ADDR << 1);                      // start transmission to OLED
+  I2C_write(OLED_CMD_MODE);                       // set command mode
+  I2C_write(OLED_COLUMNS);                        // set start and end column
+  I2C_write(OLED_XOFF + x0);
+  I2C_write(OLED_XOFF + x1);
+  I2C_write(OLED_PAGES);                          // set start and end page
+  I2C_write(OLED_YOFF + p0);
+  I2C_write(OLED_YOFF + p1);
+  I2C_stop();                                     // stop transmission
+}
+#endif
+
 // Refresh screen buffer (send buffer via I2C)
 void OLED_refresh(void) {
   #if OLED_DOUBLEBUF > 0
@@ -246,19 +296,97 @@ void OLED_refresh(void) {
     buffer += OLED_WIDTH;                         // increase buffer pointer
   }
   #else
+  #if OLED_DIRTY > 0
+  OLED_window(0, OLED_WIDTH - 1, 0, OLED_PAGE_NUM - 1); // reset window (changed by dirty refresh)
+  #else
   OLED_home(OLED_XOFF, OLED_YOFF);                // set start address
+  #endif
   I2C_start(OLED_ADDR << 1);                      // start transmission to OLED
   I2C_write(OLED_DAT_MODE);                       // set command mode
   I2C_writeBuffer(OLED_sendbuffer, sizeof(OLED_buffer)); // send screen buffer using DMA
   #endif
+  OLED_markScreen(0);                             // screen is clean now
 }
 
+// Queue command and data transaction for column span (x0..x1) of page (p) in (buffer)
+#if OLED_DIRTY > 0 && OLED_DOUBLEBUF == 0 && OLED_QUEUE > 0
+I2C_TRANS OLED_trans[2 * OLED_PAGE_NUM];            // transaction descriptors per page
+uint8_t   OLED_spancmd[OLED_PAGE_NUM][6];           // address commands per page
+
+static void OLED_queueSpan(uint8_t p, uint8_t x0, uint8_t x1, uint8_t* buffer) {
+  I2C_TRANS* t   = &OLED_trans[p << 1];
+  uint8_t*   cmd = OLED_spancmd[p];
+  #if OLED_SH1106 == 1 || OLED_WIDTH == 64
+  uint8_t x = OLED_XOFF + x0;
+  cmd[0] = OLED_PAGE | ((OLED_YOFF + (p << 3)) >> 3); // set start address
+  cmd[1] = OLED_COLUMN_LOW  | (x & 0xf);
+  cmd[2] = OLED_COLUMN_HIGH | (x >> 4);
+  t->len = 3;
+  #else
+  cmd[0] = OLED_COLUMNS;                          // set window for this page span
+  cmd[1] = OLED_XOFF + x0;
+  cmd[2] = OLED_XOFF + x1;
+  cmd[3] = OLED_PAGES;
+  cmd[4] = OLED_YOFF + p;
+  cmd[5] = OLED_YOFF + p;
+  t->len = 6;
+  #endif
+  t->addr      = OLED_ADDR << 1;                  // command transaction
+  t->hlen      = 1;
+  t->header[0] = OLED_CMD_MODE;
+  t->buf       = cmd;
+  t->callback  = 0;
+  I2C_submit(t++);
+  t->addr      = OLED_ADDR << 1;                  // data transaction
+  t->hlen      = 1;
+  t->header[0] = OLED_DAT_MODE;
+  t->buf       = buffer + x0;
+  t->len       = x1 - x0 + 1;
+  t->callback  = 0;
+  I2C_submit(t);
+}
+#endif
+
+// Refresh only the dirty parts of the screen buffer (send them via I2C)
+#if OLED_DIRTY > 0
+void OLED_refreshDirty(void) {
+  #if OLED_DOUBLEBUF > 0
+  OLED_refresh();                                 // double buffer needs full refresh
+  #else
+  uint8_t* buffer = OLED_sendbuffer;
+  #if OLED_QUEUE > 0
+  I2C_flush();                                    // descriptors of last refresh are free
+  #endif
+  for(uint8_t p=0; p<OLED_PAGE_NUM; p++, buffer+=OLED_WIDTH) {
+    uint8_t x0 = OLED_dirtyX0[p];
+    uint8_t x1 = OLED_dirtyX1[p];
+    if(x0 > x1) continue;                         // skip clean pages
+    OLED_dirtyX0[p] = 0xFF;                       // mark page as clean
+    OLED_dirtyX1[p] = 0;
+    #if OLED_QUEUE > 0
+    OLED_queueSpan(p, x0, x1, buffer);            // send span in the background
+    #else
+    #if OLED_SH1106 == 1 || OLED_WIDTH == 64
+    OLED_home(OLED_XOFF + x0, OLED_YOFF + (p << 3)); // set start address
+    #else
+    OLED_window(x0, x1, p, p);                    // set window for this page span
+    #endif
+    I2C_start(OLED_ADDR << 1);                    // start transmission to OLED
+    I2C_write(OLED_DAT_MODE);                     // set data mode
+    I2C_writeBuffer(buffer + x0, x1 - x0 + 1);    // send dirty span using DMA
+    #endif
+  }
+  #endif
+}
+#endif
+
 // ===================================================================================
 // OLED Graphics Functions
 // ===================================================================================
 
 // Clear OLED screen buffer
 void OLED_clear(void) {
+  OLED_markScreen(1);
   uint32_t* ptr = (uint32_t*)OLED_drawbuffer;
   uint32_t  cnt = sizeof(OLED_buffer) >> 2;
   while(cnt--) *ptr++ = (uint32_t)0;
@@ -266,6 +394,7 @@ void OLED_clear(void) {
 
 // Copy OLED screen buffer
 void OLED_copy(void) {
+  OLED_markScreen(1);
   uint32_t* sptr = (uint32_t*)OLED_sendbuffer;
   uint32_t* dptr = (uint32_t*)OLED_drawbuffer;
   uint32_t  cnt  = sizeof(OLED_buffer) >> 2;
@@ -288,6 +417,7 @@ uint8_t OLED_getPixel(int16_t x, int16_t y) {
 void OLED_setPixel(int16_t x, int16_t y, uint8_t color) {
   #if OLED_PORTRAIT == 0
   if((x < 0) || (x >= OLED_WIDTH) || (y < 0) || (y >= OLED_HEIGHT)) return;
+  OLED_markDirty((uint16_t)y >> 3, x);
   switch(color) {
     case 0: OLED_drawbuffer[((uint16_t)y >> 3) * OLED_WIDTH + x] &= ~((uint8_t)1 << (y & 7));
             break;
@@ -299,6 +429,7 @@ void OLED_setPixel(int16_t x, int16_t y, uint8_t color) {
   #else
   if((x < 0) || (x >= OLED_HEIGHT) || (y < 0) || (y >= OLED_WIDTH)) return;
   x = (int16_t)(OLED_HEIGHT - 1) - x;
+  OLED_markDirty((uint16_t)x >> 3, y);
   switch(color) {
     case 0: OLED_drawbuffer[((uint16_t)x >> 3) * OLED_WIDTH + y] &= ~((uint8_t)1 << (x & 7));
             break;
@@ -310,19 +441,50 @@ void OLED_setPixel(int16_t x, int16_t y, uint8_t color) {
   #endif
 }
 
+// Fill area of screen buffer from column (x0..x1) and row (y0..y1) with color
+// (coordinates must be within the buffer, one masked byte operation per page and column)
+static void OLED_fillArea(uint8_t x0, uint8_t x1, uint8_t y0, uint8_t y1, uint8_t color) {
+  uint8_t  p    = y0 >> 3;
+  uint8_t  last = y1 >> 3;
+  uint8_t  mask = 0xFF << (y0 & 7);               // mask of first page
+  uint8_t* ptr  = OLED_drawbuffer + p * OLED_WIDTH + x0;
+  for(; p<=last; p++, ptr+=OLED_WIDTH, mask=0xFF) {
+    uint8_t* dst = ptr;
+    uint8_t  cnt = x1 - x0 + 1;
+    if(p == last) mask &= 0xFF >> (7 - (y1 & 7)); // mask of last page
+    OLED_markSpan(p, x0, x1);
+    switch(color) {
+      case 0: mask = ~mask; while(cnt--) *dst++ &= mask;
+              break;
+      case 1: while(cnt--) *dst++ |= mask;
+              break;
+      case 2: while(cnt--) *dst++ ^= mask;
+              break;
+    }
+  }
+}
+
 // Draw vertical line starting from (x,y), height (h), color (0: cleared, 1: set)
 void OLED_drawVLine(int16_t x, int16_t y, int16_t h, uint8_t color) {
-  for(int16_t i=y; i<y+h; i++) OLED_setPixel(x, i, color);
+  OLED_fillRect(x, y, 1, h, color);
 }
 
 // Draw horizontal line starting from (x,y), width (w), color (0: cleared, 1: set)
 void OLED_drawHLine(int16_t x, int16_t y, int16_t w, uint8_t color) {
-  for(int16_t i=x; i<x+w; i++) OLED_setPixel(i, y, color);
+  OLED_fillRect(x, y, w, 1, color);
 }
 
 // Draw line from position (x0,y0) to (x1,y1) with color (0: cleared, 1: set)
 // (Bresenham's line algorithm)
 void OLED_drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint8_t color) {
+  if(((x0 == x1) || (y0 == y1))                   // vertical or horizontal line?
+    && (OLED_abs(x1 - x0) < 0x7FFF) && (OLED_abs(y1 - y0) < 0x7FFF)) {
+    int16_t xl = (x0 < x1) ? x0 : x1;
+    int16_t yl = (y0 < y1) ? y0 : y1;
+    OLED_fillRect(xl, yl, OLED_abs(x1 - x0) + 1, OLED_abs(y1 - y0) + 1, color);
+    return;
+  }
+
   int16_t dx = OLED_abs(x1 - x0);
   int16_t sx = x0 < x1 ? 1 : -1;
   int16_t dy = -OLED_abs(y1 - y0);
@@ -356,7 +518,21 @@ void OLED_drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint8_t color) {
 
 // Draw filled rectangle starting from (x,y), width (w), height (h), color
 void OLED_fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint8_t color) {
-  for(int16_t i=x; i<x+w; i++) OLED_drawVLine(i, y, h, color);
+  int32_t x1 = (int32_t)x + w - 1;
+  int32_t y1 = (int32_t)y + h - 1;
+  if(x < 0) x = 0;
+  if(y < 0) y = 0;
+  #if OLED_PORTRAIT == 0
+  if(x1 >= OLED_WIDTH)  x1 = OLED_WIDTH  - 1;
+  if(y1 >= OLED_HEIGHT) y1 = OLED_HEIGHT - 1;
+  if((x > x1) || (y > y1)) return;
+  OLED_fillArea(x, x1, y, y1, color);
+  #else
+  if(x1 >= OLED_HEIGHT) x1 = OLED_HEIGHT - 1;
+  if(y1 >= OLED_WIDTH)  y1 = OLED_WIDTH  - 1;
+  if((x > x1) || (y > y1)) return;
+  OLED_fillArea(y, y1, (OLED_HEIGHT - 1) - x1, (OLED_HEIGHT - 1) - x, color);
+  #endif
 }
 
 // Draw circle, center at position (x0,y0), radius (r), color (0: cleared, 1: set)
@@ -421,14 +597,53 @@ void OLED_fillCircle(int16_t x0, int16_t y0, int16_t r, uint8_t color) {
 
 // Draw a complete screen
 void OLED_drawScreen(const uint8_t* bmp) {
+  OLED_markScreen(1);
   uint32_t* ptr1 = (uint32_t*)bmp;
   uint32_t* ptr2 = (uint32_t*)OLED_buffer;
   uint32_t  cnt = sizeof(OLED_buffer) >> 2;
   while(cnt--) *ptr2++ = *ptr1++;
 }
 
+#if OLED_PORTRAIT == 0
+// Draw bitmap (sprite = 0) or sprite (sprite = 1) at position (x0,y0), width (w),
+// hight (h), clipped once and written a page byte at a time
+static void OLED_blit(int16_t x0, int16_t y0, int16_t w, int16_t h, const uint8_t* bmp,
+                      uint8_t sprite) {
+  int16_t xs = (x0 < 0) ? -x0 : 0;                // first visible column of bitmap
+  int16_t xe = (x0 + w > OLED_WIDTH) ? OLED_WIDTH - x0 : w; // end of visible columns
+  int16_t p  = y0 >> 3;                           // screen page of first bitmap row
+  uint8_t sh = y0 & 7;                            // bit shift within screen page
+  if(xs >= xe) return;
+  for(int16_t y=0; y<h; y+=8, p++, bmp+=w) {
+    if(p >= OLED_PAGE_NUM) return;
+    for(uint8_t half=0; half<2; half++) {         // bitmap row covers two screen pages
+      int16_t tp = p + half;                      // target page
+      uint8_t mask;
+      if((tp < 0) || (tp >= OLED_PAGE_NUM)) continue;
+      if(!half) mask = 0xFF << sh;
+      else if(sh) mask = 0xFF >> (8 - sh);
+      else break;
+      const uint8_t* src = bmp + xs;
+      uint8_t* dst = OLED_drawbuffer + tp * OLED_WIDTH + x0 + xs;
+      OLED_markSpan(tp, x0 + xs, x0 + xe - 1);
+      for(int16_t i=xe-xs; i; i--) {
+        uint8_t data = half ? (*src++ >> (8 - sh)) : (*src++ << sh);
+        if(sprite) *dst++ |= data;
+        else {
+          *dst = (*dst & ~mask) | data;
+          dst++;
+        }
+      }
+    }
+  }
+}
+#endif
+
 // Draw bitmap at position (x0,y0), width (w), hight (h), pointer to bitmap (*bmp)
 void OLED_drawBitmap(int16_t x0, int16_t y0, int16_t w, int16_t h, const uint8_t* bmp) {
+  #if OLED_PORTRAIT == 0
+  OLED_blit(x0, y0, w, h, bmp, 0);
+  #else
   for(int16_t y=y0; y<y0+h; y+=8) {
     for(int16_t x=x0; x<x0+w; x++) {
       uint8_t line = *bmp++;
@@ -437,10 +652,14 @@ void OLED_drawBitmap(int16_t x0, int16_t y0, int16_t w, int16_t h, const uint8_t
       }
     }
   }
+  #endif
 }
 
 // Draw sprite (bitmap with transparent background)
 void OLED_drawSprite(int16_t x0, int16_t y0, int16_t w, int16_t h, const uint8_t* bmp) {
+  #if OLED_PORTRAIT == 0
+  OLED_blit(x0, y0, w, h, bmp, 1);
+  #else
   for(int16_t y=y0; y<y0+h; y+=8) {
     for(int16_t x=x0; x<x0+w; x++) {
       uint8_t line = *bmp++;
@@ -449,6 +668,7 @@ void OLED_drawSprite(int16_t x0, int16_t y0, int16_t w, int16_t h, const uint8_t
       }
     }
   }
+  #endif
 }
 
 // ===================================================================================
@@ -474,89 +694,138 @@ void OLED_textinvert(uint8_t yes) {
   OLED_ci = yes;
 }
 
+// Nibble abcd stretched to aabbccdd (double-size and v-stretched characters)
+static const uint8_t OLED_STRETCH_LUT[] = {
+  0x00, 0x03, 0x0C, 0x0F, 0x30, 0x33, 0x3C, 0x3F,
+  0xC0, 0xC3, 0xCC, 0xCF, 0xF0, 0xF3, 0xFC, 0xFF
+};
+
 // Converts bit pattern abcdefgh into aabbccddeeffgghh
 uint16_t OLED_stretch(uint16_t x) {
-  x = (x & 0xF0)<<4 | (x & 0x0F);
-  x = (x<<2 | x) & 0x3333;
-  x = (x<<1 | x) & 0x5555;
-  return x | x<<1;
+  return OLED_STRETCH_LUT[x & 0x0F] | (uint16_t)OLED_STRETCH_LUT[(x >> 4) & 0x0F] << 8;
+}
+
+// Nibble scaled by text size (OLED_scaleSize), rebuilt when the text size changes
+uint32_t OLED_scaleLUT[16];
+uint8_t  OLED_scaleSize;
+
+// Scale font column (line) by text size into page bytes (dst), one byte per page
+static void OLED_scaleColumn(uint8_t line, uint8_t* dst) {
+  uint8_t size = OLED_cs;
+  if(OLED_scaleSize != size) {                    // text size changed -> rebuild LUT
+    uint32_t run = ((uint32_t)1 << size) - 1;     // run of pixels of one font bit
+    for(uint8_t n=0; n<16; n++) {
+      uint32_t val = 0;
+      for(uint8_t b=0; b<4; b++) if(n & (1 << b)) val |= run << (b * size);
+      OLED_scaleLUT[n] = val;
+    }
+    OLED_scaleSize = size;
+  }
+  uint64_t val = OLED_scaleLUT[line & 0x0F] | (uint64_t)OLED_scaleLUT[line >> 4] << (size << 2);
+  for(; size; size--, val>>=8) *dst++ = val;
+}
+
+// Glyph cache for enlarged characters (5 scaled font columns per entry)
+#if OLED_GLYPH_CACHE > 0
+char    OLED_cacheChar[OLED_GLYPH_CACHE];           // cached characters
+uint8_t OLED_cacheSize[OLED_GLYPH_CACHE];           // text size of cached characters
+uint8_t OLED_cacheData[OLED_GLYPH_CACHE][5 * 8];    // scaled font columns
+uint8_t OLED_cacheNext;                             // next entry to be replaced
+#else
+uint8_t OLED_glyphData[5 * 8];                      // scaled font columns
+#endif
+
+// Get scaled font columns (OLED_cs bytes each) of character (c), render if not cached
+static const uint8_t* OLED_glyph(char c) {
+  uint8_t* glyph;
+  #if OLED_GLYPH_CACHE > 0
+  for(uint8_t i=0; i<OLED_GLYPH_CACHE; i++) {
+    if((OLED_cacheChar[i] == c) && (OLED_cacheSize[i] == OLED_cs)) return OLED_cacheData[i];
+  }
+  glyph = OLED_cacheData[OLED_cacheNext];
+  OLED_cacheChar[OLED_cacheNext] = c;
+  OLED_cacheSize[OLED_cacheNext] = OLED_cs;
+  if(++OLED_cacheNext >= OLED_GLYPH_CACHE) OLED_cacheNext = 0;
+  #else
+  glyph = OLED_glyphData;
+  #endif
+  const uint8_t* font = &OLED_FONT[(uint16_t)(c - 32) * 5];
+  uint8_t* dst = glyph;
+  for(uint8_t i=5; i; i--, dst+=OLED_cs) OLED_scaleColumn(*font++, dst);
+  return glyph;
 }
 
 // Write a character
 void OLED_write(char c) {
   c &= 0x7f;
   if(c >= 32) {
-    uint16_t ptr = c - 32;
-    ptr += ptr << 2;
+    const uint8_t* font = &OLED_FONT[(uint16_t)(c - 32) * 5];
+    uint8_t inv = OLED_ci ? 0xFF : 0x00;
+
+    // Standard character (6x8), drawn as one bitmap
+    if(OLED_cs == 1) {
+      uint8_t glyph[6];
+      for(uint8_t i=0; i<5; i++) glyph[i] = font[i] ^ inv;
+      glyph[5] = inv;
+      OLED_drawBitmap(OLED_cx, OLED_cy, 6, 8, glyph);
+      OLED_cx += 6;
+      return;
+    }
 
-    // Standard character, if necessary enlarged
+    // Enlarged character, drawn as one bitmap per page row of the scaled glyph
     if(OLED_cs <= 8) {
-      for(uint8_t i=6; i; i--) {
-        uint8_t line, col;
-        int16_t y1 = OLED_cy;
-        line = OLED_FONT[ptr++];
-        if(i == 1) line = 0;
-        if(OLED_ci) line = ~line;
-        for(uint8_t j=0; j<8; j++, line>>=1) {
-          col = line & 1;
-          if(OLED_cs == 1) OLED_setPixel(OLED_cx, y1++, col);
-          else {
-            OLED_fillRect(OLED_cx, y1, OLED_cs, OLED_cs, col);
-            y1 += OLED_cs;
-          }
+      uint8_t size = OLED_cs;
+      uint8_t row[6 * 8];                         // one page row of the scaled glyph
+      const uint8_t* glyph = OLED_glyph(c);
+      for(uint8_t p=0; p<size; p++, glyph++) {
+        uint8_t* dst = row;
+        const uint8_t* src = glyph;
+        for(uint8_t i=5; i; i--, src+=size) {
+          uint8_t line = *src ^ inv;
+          for(uint8_t j=size; j; j--) *dst++ = line;
         }
-        OLED_cx += OLED_cs;
+        for(uint8_t j=size; j; j--) *dst++ = inv;
+        OLED_drawBitmap(OLED_cx, OLED_cy + (p << 3), 6 * size, 8, row);
       }
+      OLED_cx += 6 * size;
       return;
     }
 
     // Double-sized, smoothed character (10x16, David Johnson-Davies' Smooth Big Text algorithm)
+    // (diagonals of all bit pairs of two neighbouring columns are found at once)
     if(OLED_cs == OLED_SMOOTH) {
+      uint8_t  glyph[24];                         // 12 columns, 2 pages
       uint16_t col0L, col0R, col1L, col1R;
-      uint8_t col0 = OLED_FONT[ptr++];
+      uint8_t  col0 = *font++;
       col0L = OLED_stretch(col0);
       col0R = col0L;
-      for(uint8_t col=5; col; col--) {
-        uint8_t col1 = OLED_FONT[ptr++];
-        if(col == 1) col1 = 0;
-        col1L = OLED_stretch(col1);
-        col1R = col1L;    
-        for(int8_t i=6; i>=0; i--) {
-          for(int8_t j=1; j<3; j++) {
-            if(((col0>>i & 0b11) == (3 - j)) && ((col1>>i & 0b11) == j)) {
-              col0R = col0R | 1<<((i << 1) + j);
-              col1L = col1L | 1<<((i << 1) + 3 - j);
-            }
-          }
-        }
-        int16_t y1 = OLED_cy;
-        if(OLED_ci) {
-          col0L = ~col0L;
-          col0R = ~col0R;
-        }
-        for(int8_t i=16; i; i--, col0L>>=1, col0R>>=1) {
-          OLED_setPixel(OLED_cx,   y1,   col0L & 1);
-          OLED_setPixel(OLED_cx+1, y1++, col0R & 1);
-        }
-        col0 = col1; col0L = col1L; col0R = col1R; OLED_cx += 2;
+      for(uint8_t i=0; i<10; i+=2) {
+        uint8_t col1 = (i < 8) ? *font++ : 0;
+        uint16_t m1 = OLED_stretch((col0 >> 1) & ~col0 & col1 & ~(col1 >> 1) & 0x7F);
+        uint16_t m2 = OLED_stretch(col0 & ~(col0 >> 1) & (col1 >> 1) & ~col1 & 0x7F);
+        col1L  = OLED_stretch(col1);
+        col1R  = col1L;
+        col0R |= (m1 & 0xAAAA) | (m2 & 0x5555) << 2;
+        col1L |= (m2 & 0xAAAA) | (m1 & 0x5555) << 2;
+        glyph[i]      = col0L ^ inv; glyph[i + 12] = (col0L >> 8) ^ inv;
+        glyph[i + 1]  = col0R ^ inv; glyph[i + 13] = (col0R >> 8) ^ inv;
+        col0 = col1; col0L = col1L; col0R = col1R;
       }
-      OLED_fillRect(OLED_cx, OLED_cy, 2, 16, OLED_ci);
-      OLED_cx += 2;
+      glyph[10] = glyph[11] = glyph[22] = glyph[23] = inv;
+      OLED_drawBitmap(OLED_cx, OLED_cy, 12, 16, glyph);
+      OLED_cx += 12;
       return;
     }
 
     // V-stretched character (5x16)
-    for(uint8_t col=6; col; col--) {
-      uint8_t col0 = OLED_FONT[ptr++];
-      if(col == 1) col0 = 0;
-      if(OLED_ci) col0 = ~col0;
-      int16_t y1 = OLED_cy;
-      for(uint8_t i=8; i; i--, col0>>=1) {
-        OLED_setPixel(OLED_cx, y1++, col0 & 1);
-        OLED_setPixel(OLED_cx, y1++, col0 & 1);
-      }
-      OLED_cx++;
+    uint8_t glyph[12];                            // 6 columns, 2 pages
+    for(uint8_t i=0; i<6; i++) {
+      uint16_t line = OLED_stretch((i < 5) ? font[i] : 0);
+      glyph[i]     = line ^ inv;
+      glyph[i + 6] = (line >> 8) ^ inv;
     }
+    OLED_drawBitmap(OLED_cx, OLED_cy, 6, 16, glyph);
+    OLED_cx += 6;
     return;
   }
 
@@ -577,6 +846,11 @@ void OLED_print(char* str) {
   while(*str) OLED_write(*str++);
 }
 
+// Write (len) characters from buffer (buf), used as putbuf sink by the print functions
+void OLED_writeBuffer(const uint8_t* buf, uint16_t len) {
+  while(len--) OLED_write(*buf++);
+}
+
 // ===================================================================================
 // OLED 7-Segment Functions
 // ===================================================================================
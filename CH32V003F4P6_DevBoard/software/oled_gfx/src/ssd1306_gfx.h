@@ -1,5 +1,5 @@
 // ===================================================================================
-// SSD1306/SH1106 I2C OLED Graphics Functions                                 * v1.6 *
+// SSD1306/SH1106 I2C OLED Graphics Functions                                 * v2.0 *
 // ===================================================================================
 //
 // Functions available:
@@ -11,6 +11,7 @@
 // OLED_flip(xflip,yflip)         Flip display (0: flip off, 1: flip on)
 // OLED_vscroll(y)                Scroll display vertically
 // OLED_refresh()                 Refresh (flush) screen buffer (send buffer via I2C)
+// OLED_refreshDirty()            Refresh only the parts of the screen buffer that have changed
 // OLED_flush()                   Refresh (flush) screen buffer (alias)
 //
 // OLED_clear()                   Clear OLED screen buffer
@@ -36,6 +37,7 @@
 // OLED_textinvert(v)             Invert text (0: inverse off, 1: inverse on)
 // OLED_write(c)                  Write character at cursor position or handle control characters
 // OLED_print(str)                Print string (*str) at cursor position
+// OLED_writeBuffer(buf,len)      Write (len) characters from buffer (*buf) at cursor position
 // OLED_printSegment(v,d,l,dp)    Print value (v) at cursor position using defined segment font
 //                                with (d) number of digits, (l) leading (0: '0', 1: space) and 
 //                                decimal point at position (dp) counted from the right
@@ -43,7 +45,7 @@
 // If print functions are activated (see below, print.h must be included):
 // -----------------------------------------------------------------------
 // OLED_cursor(x,y,c,sz)          Set cursor at position (x,y), color (c), size (sz)
-// OLED_printf(f, ...)            printf (supports %s, %c, %d, %u, %x, %b, %02d, %%)
+// OLED_printf(f, ...)            printf (supports %s, %c, %d, %u, %x, %b, %02d, %.2d, %%)
 // OLED_printD(n)                 Print decimal value
 // OLED_printW(n)                 Print 32-bit hex word value
 // OLED_printH(n)                 Print 16-bit hex half-word value
@@ -55,6 +57,22 @@
 // Notes:
 // ------
 // - color: 0: clear pixel (black), 1: set pixel (white), 2: invert pixel
+// - OLED_refreshDirty() sends only the changed column span of each page. Drawing functions
+//   track these spans automatically. If the screen buffer is written directly, use
+//   OLED_refresh() instead. In double-buffer mode it falls back to a full refresh.
+// - With OLED_QUEUE, OLED_refreshDirty() submits a command and a data transaction for each
+//   changed page to the I2C queue (I2C_submit() of i2c_dma.h) and returns at once, the
+//   spans are sent by interrupt and DMA in the background. The next refresh waits for the
+//   queue to finish (I2C_flush()). Pixels drawn before the queue is finished may already
+//   appear on the display.
+// - Lines, rectangles and filled circles are drawn as spans: the area is clipped once and
+//   each covered page is written with one masked byte operation per column. Bitmaps and
+//   sprites are clipped once and written a column byte at a time, shifted into the two
+//   pages they cover (per-pixel in portrait mode).
+// - Characters are drawn as bitmaps. Enlarged characters (size 2..8) are scaled a font
+//   column at a time into page bytes via a lookup table (rebuilt when the size changes),
+//   the smoothed and v-stretched sizes use a nibble stretch table. With OLED_GLYPH_CACHE
+//   the scaled columns of the last used enlarged characters are kept in RAM.
 // - size:  1: normal 6x8 pixels, 2: double size (12x16), ... , 8: 8 times (48x64)
 //          9: smoothed double size (12x16), 10: v-stretched (6x16)
 //
@@ -97,6 +115,8 @@ extern "C" {
 #define OLED_INVERT       0         // 1: invert screen with OLED_init()
 #define OLED_PORTRAIT     0         // 1: use OLED in portrait mode
 #define OLED_DOUBLEBUF    0         // 1: use double buffer
+#define OLED_DIRTY        1         // 1: track changed regions for OLED_refreshDirty()
+#define OLED_QUEUE        1         // 1: OLED_refreshDirty() queues I2C transactions (i2c_dma)
 
 // OLED Text Settings
 #define OLED_PRINT        0         // 1: include print functions (needs print.h)
@@ -104,6 +124,7 @@ extern "C" {
 #define OLED_SEG_SPACE    3         // width of space between segment digits in pixels
 #define OLED_SMOOTH       9         // character size value for double-size smoothed
 #define OLED_STRETCH      10        // character size value for v-stretched
+#define OLED_GLYPH_CACHE  0         // number of cached enlarged glyphs (40 bytes RAM each)
 
 // OLED Modes
 #define OLED_CMD_MODE     0x00      // set command mode
@@ -157,6 +178,7 @@ void OLED_flip(uint8_t xflip, uint8_t yflip);
 void OLED_vscroll(uint8_t y);
 void OLED_home(uint8_t x, uint8_t y);
 void OLED_refresh(void);
+void OLED_refreshDirty(void);
 
 // OLED Graphics Functions
 void OLED_clear(void);
@@ -181,22 +203,26 @@ void OLED_textsize(uint8_t size);
 void OLED_textinvert(uint8_t yes);
 void OLED_write(char c);
 void OLED_print(char* str);
+void OLED_writeBuffer(const uint8_t* buf, uint16_t len);
 void OLED_printSegment(uint16_t value, uint8_t digits, uint8_t lead, uint8_t decimal);
 
 #define OLED_flush            OLED_refresh
+#if OLED_DIRTY == 0
+#define OLED_refreshDirty     OLED_refresh
+#endif
 #define OLED_textcolor(c)     OLED_textinvert(!(c))
 
 // Additional print functions (if activated, see above)
 #if OLED_PRINT == 1
 #include "print.h"
-#define OLED_printD(n)        printD(OLED_write, n)   // print decimal as string
-#define OLED_printW(n)        printW(OLED_write, n)   // print word as string
-#define OLED_printH(n)        printH(OLED_write, n)   // print half-word as string
-#define OLED_printB(n)        printB(OLED_write, n)   // print byte as string
-#define OLED_printS(s)        printS(OLED_write, s)   // print string
-#define OLED_println(s)       println(OLED_write, s)  // print string with newline
-#define OLED_newline()        OLED_write('\n')        // send newline
-#define OLED_printf(f, ...)   printF(OLED_write, f, ##__VA_ARGS__)
+#define OLED_printD(n)        printBufD(OLED_writeBuffer, n) // print decimal as string
+#define OLED_printW(n)        printW(OLED_write, n)          // print word as string
+#define OLED_printH(n)        printH(OLED_write, n)          // print half-word as string
+#define OLED_printB(n)        printB(OLED_write, n)          // print byte as string
+#define OLED_printS(s)        printBufS(OLED_writeBuffer, s) // print string
+#define OLED_println(s)       {printBufS(OLED_writeBuffer, s); OLED_write('\n');}
+#define OLED_newline()        OLED_write('\n')               // send newline
+#define OLED_printf(f, ...)   printBufF(OLED_writeBuffer, f, ##__VA_ARGS__)
 #endif
 
 #ifdef __cplusplus
@@ -0,0 +1,142 @@
+// ===================================================================================
+// Dirty Refresh Test for the OLED Graphics Functions (host-side)
+// ===================================================================================
+//
+// Checks that OLED_refreshDirty() transmits exactly the changed column span of each
+// page. Every frame inverts a few distinct pixels (so each touched byte changes) and
+// requires the transmitted columns of each page to be exactly the span between the
+// first and last changed column. A second part runs random drawing operations and
+// requires that all changed bytes are transmitted. After every refresh the display
+// RAM model of the I2C stub must match the screen buffer, and a second refresh must
+// not transmit anything. Prints "OK" or the first mismatch.
+
+#include <stdio.h>
+#include <string.h>
+#include "ssd1306_gfx.h"
+
+#define TEST_FRAMES 20000                         // number of frames per part
+#define XOFF        ((128 - OLED_WIDTH) / 2 + 2 * OLED_SH1106) // column offset in RAM
+#define PAGES       (OLED_HEIGHT / 8)
+
+#if OLED_PORTRAIT == 0
+  #define SCREEN_W  OLED_WIDTH                  // drawing area
+  #define SCREEN_H  OLED_HEIGHT
+#else
+  #define SCREEN_W  OLED_HEIGHT
+  #define SCREEN_H  OLED_WIDTH
+#endif
+
+// Xorshift pseudo-random number generator
+static uint32_t seed = 4711;
+static uint32_t rnd(void) {
+  seed ^= seed << 13;
+  seed ^= seed >> 17;
+  seed ^= seed << 5;
+  return seed;
+}
+
+// Random coordinate, mostly on-screen but also off the edges
+static int16_t coord(void) {
+  return (int16_t)(rnd() % 170) - 20;
+}
+
+static uint8_t prev[OLED_WIDTH * PAGES];          // screen buffer before the frame
+static long    frame;
+
+// Refresh and compare transmitted columns with the changes since the last frame
+static int check(uint8_t exact) {
+  I2C_clearSent();
+  OLED_refreshDirty();
+  for(uint8_t p=0; p<PAGES; p++) {
+    int first = -1, last = -1;
+    for(int x=0; x<OLED_WIDTH; x++) {
+      if(OLED_buffer[p * OLED_WIDTH + x] != prev[p * OLED_WIDTH + x]) {
+        if(first < 0) first = x;
+        last = x;
+      }
+    }
+    for(int c=0; c<256; c++) {
+      int     x    = c - XOFF;
+      uint8_t want = (x >= first) && (x <= last) && (first >= 0);
+      if((x < 0) || (x >= OLED_WIDTH)) {
+        if(I2C_sent[p][c]) {
+          printf("frame %ld: column %d outside the screen sent\n", frame, c);
+          return 0;
+        }
+        continue;
+      }
+      if(I2C_ram[p][c] != OLED_buffer[p * OLED_WIDTH + x]) {
+        printf("frame %ld: display RAM differs at page %d, column %d\n", frame, p, x);
+        return 0;
+      }
+      if((exact && (I2C_sent[p][c] != want)) || (want && !I2C_sent[p][c])) {
+        printf("frame %ld: page %d, column %d %s (changed %d..%d)\n", frame, p, x,
+               I2C_sent[p][c] ? "sent" : "not sent", first, last);
+        return 0;
+      }
+    }
+  }
+  I2C_clearSent();                                // nothing left to send
+  OLED_refreshDirty();
+  for(uint8_t p=0; p<8; p++) {
+    for(int c=0; c<256; c++) {
+      if(I2C_sent[p][c]) {
+        printf("frame %ld: page %d sent again\n", frame, p);
+        return 0;
+      }
+    }
+  }
+  memcpy(prev, OLED_buffer, sizeof(prev));
+  return 1;
+}
+
+int main(void) {
+  static uint8_t bitmap[2048];
+  for(int i=0; i<2048; i++) bitmap[i] = rnd();
+
+  OLED_init();                                    // RAM undefined: complete refresh
+  memset(I2C_ram, 0x55, sizeof(I2C_ram));
+  memset(prev, 0xFF, sizeof(prev));
+  OLED_clear();
+  if(!check(0)) return 1;
+
+  // Distinct inverted pixels: transmitted span must match exactly
+  for(frame=0; frame<TEST_FRAMES; frame++) {
+    int16_t px[8], py[8];
+    uint8_t n = rnd() % 9;
+    for(uint8_t i=0; i<n; i++) {
+      uint8_t dup;
+      do {
+        px[i] = rnd() % SCREEN_W;
+        py[i] = rnd() % SCREEN_H;
+        dup   = 0;
+        for(uint8_t j=0; j<i; j++) if((px[j] == px[i]) && (py[j] == py[i])) dup = 1;
+      } while(dup);
+      OLED_setPixel(px[i], py[i], 2);
+    }
+    OLED_setPixel(-1 - rnd() % 20, rnd() % SCREEN_H, 1); // off-screen: nothing to send
+    OLED_setPixel(rnd() % SCREEN_W, SCREEN_H + rnd() % 20, 1);
+    if(!check(1)) return 1;
+  }
+
+  // Random drawing operations: all changes must be transmitted
+  for(; frame<2*TEST_FRAMES; frame++) {
+    uint8_t color = rnd() % 3;
+    switch(rnd() % 8) {
+      case 0:  OLED_drawHLine(coord(), coord(), coord(), color); break;
+      case 1:  OLED_drawVLine(coord(), coord(), coord(), color); break;
+      case 2:  OLED_fillRect(coord(), coord(), rnd() % 60, rnd() % 60, color); break;
+      case 3:  OLED_drawCircle(coord(), coord(), rnd() % 40, color); break;
+      case 4:  OLED_drawLine(coord(), coord(), coord(), coord(), color); break;
+      case 5:  OLED_drawSprite(coord(), coord(), rnd() % 40, rnd() % 30,
+                               bitmap + rnd() % 1000); break;
+      case 6:  OLED_setPixel(coord(), coord(), color); break;
+      case 7:  OLED_cursor(coord(), coord());
+               OLED_textsize(rnd() % 4 + 1);
+               OLED_write(32 + rnd() % 96); break;
+    }
+    if(!check(0)) return 1;
+  }
+  printf("OK\n");
+  return 0;
+}
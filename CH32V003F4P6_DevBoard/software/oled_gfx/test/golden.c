@@ -0,0 +1,71 @@
+// ===================================================================================
+// Golden-Image Test for the OLED Graphics Functions (host-side)
+// ===================================================================================
+//
+// Runs a fixed pseudo-random sequence of drawing operations (lines, rectangles,
+// circles, bitmaps, sprites, pixels and text, many of them partly or fully off-screen)
+// and prints an FNV-1a hash over the frame buffer after every operation. The result
+// is compared with the reference hashes in golden.txt by the Makefile. Any change of
+// the rendered pixels for any display geometry changes the hash.
+
+#include <stdio.h>
+#include "ssd1306_gfx.h"
+
+#define TEST_OPS  200000                          // number of drawing operations
+
+// Xorshift pseudo-random number generator
+static uint32_t seed = 12345;
+static uint32_t rnd(void) {
+  seed ^= seed << 13;
+  seed ^= seed >> 17;
+  seed ^= seed << 5;
+  return seed;
+}
+
+// Random coordinate, mostly on-screen but also far off and just off the edges
+static int16_t coord(void) {
+  switch(rnd() % 8) {
+    case 0:  return (int16_t)(rnd() % 600) - 200;
+    case 1:  return -(int16_t)(rnd() % 40);
+    default: return rnd() % 150 - 10;
+  }
+}
+
+uint8_t bitmap[4096];
+
+int main(void) {
+  uint32_t hash = 2166136261u;
+  for(int i=0; i<4096; i++) bitmap[i] = rnd();
+
+  for(long n=0; n<TEST_OPS; n++) {
+    uint8_t color = rnd() % 4;
+    switch(rnd() % 11) {
+      case 0:  OLED_drawHLine(coord(), coord(), coord(), color); break;
+      case 1:  OLED_drawVLine(coord(), coord(), coord(), color); break;
+      case 2:  OLED_fillRect(coord(), coord(), coord() % 90, coord() % 90, color); break;
+      case 3:  OLED_fillCircle(coord(), coord(), rnd() % 40, color); break;
+      case 4:  OLED_drawRect(coord(), coord(), coord(), coord(), color); break;
+      case 5:  OLED_drawLine(coord(), coord(), coord(), coord(), color); break;
+      case 6:  {                                  // horizontal and vertical lines
+                 int16_t x = coord(), y = coord();
+                 OLED_drawLine(x, y, x, coord(), color);
+                 OLED_drawLine(x, y, coord(), y, color);
+               } break;
+      case 7:  OLED_drawBitmap(coord(), coord(), rnd() % 60 - 2, rnd() % 40 - 2,
+                               bitmap + rnd() % 1000); break;
+      case 8:  OLED_drawSprite(coord(), coord(), rnd() % 60 - 2, rnd() % 40 - 2,
+                               bitmap + rnd() % 1000); break;
+      case 9:  OLED_setPixel(coord(), coord(), color); break;
+      case 10: OLED_cursor(coord(), coord());
+               OLED_textsize(rnd() % 10 + 1);
+               OLED_textinvert(rnd() & 1);
+               OLED_write(32 + rnd() % 96); break;
+    }
+    for(unsigned k=0; k<OLED_WIDTH*OLED_HEIGHT/8; k++) {
+      hash ^= OLED_buffer[k];
+      hash *= 16777619u;
+    }
+  }
+  printf("%08x\n", hash);
+  return 0;
+}
@@ -0,0 +1,88 @@
+// ===================================================================================
+// I2C Stub for Host-Side Tests of the OLED Graphics Functions
+// ===================================================================================
+
+#include <string.h>
+#include "i2c_dma.h"
+
+uint8_t I2C_ram[8][256];
+uint8_t I2C_sent[8][256];
+
+static uint8_t state;                       // 0: idle, 1: control byte, 2: command, 3: data
+static uint8_t cmd, argn, args[2];          // command with pending argument bytes
+static uint8_t window;                      // 1: horizontal addressing within window
+static uint8_t page, col;                   // RAM pointer
+static uint8_t c0 = 0, c1 = 127, p0 = 0, p1 = 7; // window
+
+void I2C_clearSent(void) {
+  memset(I2C_sent, 0, sizeof(I2C_sent));
+}
+
+// Execute command byte or collect its arguments
+static void I2C_command(uint8_t data) {
+  if(argn) {
+    args[--argn] = data;
+    if(argn) return;
+    if(cmd == 0x21) { c0 = args[1]; c1 = args[0]; col  = c0; window = 1; }
+    if(cmd == 0x22) { p0 = args[1]; p1 = args[0]; page = p0; window = 1; }
+    return;
+  }
+  cmd = data;
+  switch(data) {
+    case 0x21: case 0x22:                   // column and page window
+      argn = 2; break;
+    case 0x20: case 0x81: case 0x8D: case 0xA8: case 0xD3:
+    case 0xD5: case 0xD9: case 0xDA: case 0xDB:
+      argn = 1; break;
+    default:
+      if((data & 0xF8) == 0xB0) { page = data & 7; window = 0; }
+      else if(data < 0x10) { col = (col & 0xF0) | data; window = 0; }
+      else if(data < 0x20) { col = (col & 0x0F) | (data << 4); window = 0; }
+      break;
+  }
+}
+
+// Write data byte to display RAM
+static void I2C_data(uint8_t data) {
+  I2C_ram[page & 7][col]  = data;
+  I2C_sent[page & 7][col] = 1;
+  if(window && (col == c1)) {
+    col  = c0;
+    page = (page == p1) ? p0 : page + 1;
+  }
+  else col++;
+}
+
+void I2C_init(void) {}
+
+void I2C_start(uint8_t addr) {
+  (void)addr;
+  state = 1;
+  argn  = 0;
+}
+
+void I2C_write(uint8_t data) {
+  switch(state) {
+    case 1:  state = (data == 0x40) ? 3 : 2; break;
+    case 2:  I2C_command(data); break;
+    case 3:  I2C_data(data); break;
+    default: break;
+  }
+}
+
+void I2C_stop(void) {
+  state = 0;
+}
+
+void I2C_writeBuffer(uint8_t* buf, uint16_t len) {
+  while(len--) I2C_write(*buf++);
+  I2C_stop();
+}
+
+void I2C_submit(I2C_TRANS* t) {
+  I2C_start(t->addr);
+  for(uint8_t i=0; i<t->hlen; i++) I2C_write(t->header[i]);
+  I2C_writeBuffer(t->buf, t->len);
+  t->status = I2C_DONE;
+  if(t->callback) t->callback(t);
+}
@@ -0,0 +1,42 @@
+// ===================================================================================
+// I2C Stub for Host-Side Tests of the OLED Graphics Functions
+// ===================================================================================
+// Everything sent to the OLED is fed into a simple model of the display RAM. Window
+// commands (OLED_COLUMNS/OLED_PAGES) select horizontal addressing within the window,
+// page and column commands select page addressing. Each written RAM byte is also
+// marked in I2C_sent[][] so that tests can check which columns were transmitted.
+
+#pragma once
+#include <stdint.h>
+
+// Display RAM model
+extern uint8_t I2C_ram[8][256];             // display RAM (page, column)
+extern uint8_t I2C_sent[8][256];            // 1: byte written since I2C_clearSent()
+void I2C_clearSent(void);
+
+// Blocking functions
+void I2C_init(void);
+void I2C_start(uint8_t addr);
+void I2C_write(uint8_t data);
+void I2C_stop(void);
+void I2C_writeBuffer(uint8_t* buf, uint16_t len);
+
+// Queued transactions are transmitted and finish at once
+#define I2C_HEADER_SIZE   4
+#define I2C_PENDING       0
+#define I2C_DONE          1
+
+typedef struct I2C_TRANS I2C_TRANS;
+struct I2C_TRANS {
+  uint8_t   addr;
+  uint8_t   hlen;
+  uint8_t   header[I2C_HEADER_SIZE];
+  uint8_t*  buf;
+  uint16_t  len;
+  void    (*callback)(I2C_TRANS*);
+  volatile uint8_t status;
+  I2C_TRANS* volatile next;
+};
+
+void I2C_submit(I2C_TRANS* t);
+#define I2C_flush()
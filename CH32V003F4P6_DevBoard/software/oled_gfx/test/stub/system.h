@@ -0,0 +1,8 @@
+// ===================================================================================
+// System Stub for Host-Side Tests of the OLED Graphics Functions
+// ===================================================================================
+
+#pragma once
+#include <stdint.h>
+
+#define DLY_ms(n)
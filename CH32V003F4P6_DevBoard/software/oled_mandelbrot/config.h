@@ -14,8 +14,17 @@
 // mathematical rules can generate incredibly complex and beautiful patterns.
 //
 // Connect an SSD1306 128x64 Pixels I2C OLED to PC1 (SDA) and PC2 (SCL).
+// Connect a rotary encoder to PC6 (ENC_A), PC7 (ENC_B) and PC3 (switch) to zoom
+// and pan. Frame time is reported via debug serial on PD5 (115200 BAUD).
 
 #pragma once
 
 // Pin defines
 #define PIN_LED   PC0       // define LED pin
+#define PIN_KEY   PC3       // define encoder switch pin
+
+// Rotary encoder
+#define ENC_DIV   2         // encoder counts per detent (2 or 4)
+
+// Rendering
+#define MANDEL_BANDS  1     // 0: escaped points set, 1: alternating escape-time bands
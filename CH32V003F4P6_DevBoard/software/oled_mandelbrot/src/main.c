@@ -1,6 +1,6 @@
 // ===================================================================================
 // Project:   OLED Mandelbrot Demo for CH32V003
-// Version:   v1.0
+// Version:   v1.1
 // Year:      2023
 // Author:    Stefan Wagner
 // Github:    https://github.com/wagiminator
@@ -21,6 +21,17 @@
 //
 // Connect an SSD1306 128x64 Pixels I2C OLED to PC1 (SDA) and PC2 (SCL).
 //
+// The set is computed with a shift-only fixed-point inner loop. Points inside the
+// main cardioid and the period-2 bulb are rejected without iterating, and orbits
+// that run into a cycle are detected early (periodicity check). Each page of 8
+// pixel rows is sent to the OLED via DMA while the next page is being computed.
+// Escaped points can be drawn in alternating bands of their escape time.
+//
+// Connect a rotary encoder to PC6 (ENC_A), PC7 (ENC_B) and PC3 (switch) to zoom
+// and pan. Pressing the switch cycles through the modes zoom, pan X and pan Y.
+// The frame time and the current view are reported via debug serial on PD5
+// (115200 BAUD).
+//
 // References:
 // -----------
 // - CNLohr ch32v003fun: https://github.com/cnlohr/ch32v003fun
@@ -37,8 +48,12 @@
 // ===================================================================================
 // Libraries, Definitions and Macros
 // ===================================================================================
+#include "config.h"               // user configurations
 #include "system.h"               // system functions
-#include "i2c_tx.h"               // I2C functions
+#include "gpio.h"                 // GPIO functions
+#include "i2c_dma.h"              // I2C functions with DMA
+#include "encoder_tim.h"          // rotary encoder functions
+#include "debug_serial.h"         // serial debug functions
 
 // ===================================================================================
 // SSD1306 128x64 Pixels OLED Definitions
@@ -62,60 +77,197 @@ const uint8_t OLED_INIT_CMD[] = {
   0xAF                            // display on
 };
 
+// OLED set cursor to home position
+const uint8_t OLED_HOME_CMD[] = {
+  OLED_CMD_MODE,                  // set commandmode
+  0x21, 0x00, 0x7F,               // set start and end column
+  0x22, 0x00, 0x3F                // set start and end page
+};
+
 // ===================================================================================
 // Mandelbrot Set Functions
 // ===================================================================================
 #define MANDEL_WIDTH      128     // display width
 #define MANDEL_HEIGHT     64      // display hight
 #define MANDEL_MAX_ITER   50      // max iterations (50 .. 65525)
-#define MANDEL_BOUND      1024    // limit for iteration termination (min 1024)
-#define MANDEL_SCALE      256     // scale factor (recommended: 2 * MANDEL_WIDTH)
+#define MANDEL_FRAC       14      // fractional bits of fixed-point numbers (max 14)
+#define MANDEL_ONE        (1 << MANDEL_FRAC)
+#define MANDEL_STEP_MAX   (MANDEL_ONE / 32) // pixel step of full view
+#define MANDEL_PERIOD     8       // initial length of periodicity check
 
-// Draw Mandelbrot on display
-void MANDEL_draw(void) {
-  I2C_start(OLED_ADDR);
-  I2C_write(OLED_DAT_MODE);
-  for(int32_t y = 0; y < MANDEL_HEIGHT; y += 8) {
-    int32_t real = (0 - 4 * MANDEL_WIDTH / 5) * MANDEL_SCALE * 3 / MANDEL_WIDTH;
-    for(int32_t x = 0; x < MANDEL_WIDTH; x++, real += MANDEL_SCALE * 3 / MANDEL_WIDTH) {
-      int32_t imag = (y - MANDEL_HEIGHT / 2) * MANDEL_SCALE * 2 / MANDEL_HEIGHT;
-      uint8_t slice = 0;
-      for(int32_t i = 8; i; i--, imag += MANDEL_SCALE * 2 / MANDEL_HEIGHT) {
-        int32_t z_real = 0;
-        int32_t z_imag = 0;
-        int32_t iter = 0;
-        slice >>= 1;
-        while(iter < MANDEL_MAX_ITER) {
-          int32_t z_real_sq = (z_real * z_real) / MANDEL_SCALE;
-          int32_t z_imag_sq = (z_imag * z_imag) / MANDEL_SCALE;
-          if(z_real_sq + z_imag_sq > MANDEL_BOUND) {
-            slice |= 0x80;
-            break;
-          }
-          int32_t z_temp = z_real_sq - z_imag_sq + real;
-          z_imag = z_real * z_imag / (MANDEL_SCALE / 2) + imag;
-          z_real = z_temp;
-          iter++;
-        }
-      }
-      I2C_write(slice);
+// Current view (fixed-point, MANDEL_FRAC fractional bits)
+int32_t MANDEL_centerX = -MANDEL_ONE / 2; // real part of center
+int32_t MANDEL_centerY = 0;               // imaginary part of center
+int32_t MANDEL_step    = MANDEL_STEP_MAX; // distance between pixels
+
+// Page buffers, one is sent via DMA while the other one is computed
+uint8_t MANDEL_page[2][MANDEL_WIDTH];
+
+// Check if point lies in the main cardioid or the period-2 bulb
+uint8_t MANDEL_inBulb(int32_t real, int32_t imag) {
+  if(real < -MANDEL_ONE * 5 / 4 || real > MANDEL_ONE * 3 / 8) return 0;
+  if(imag < -MANDEL_ONE || imag > MANDEL_ONE) return 0;
+  int32_t imag_sq = (imag * imag) >> MANDEL_FRAC;
+  int32_t x = real + MANDEL_ONE;                  // period-2 bulb: (x+1)^2 + y^2 <= 1/16
+  if(((x * x) >> MANDEL_FRAC) + imag_sq <= MANDEL_ONE / 16) return 1;
+  x = real - MANDEL_ONE / 4;                      // cardioid: q*(q+x-1/4) <= y^2/4
+  int32_t q = ((x * x) >> MANDEL_FRAC) + imag_sq; //   with q = (x-1/4)^2 + y^2
+  if(q >= MANDEL_ONE) return 0;                   // cardioid lies within q < 1
+  return(((q * (q + x)) >> MANDEL_FRAC) <= (imag_sq >> 2));
+}
+
+// Get number of iterations until the point escapes (MANDEL_MAX_ITER: inside set)
+uint16_t MANDEL_iterate(int32_t real, int32_t imag) {
+  int32_t  z_real = 0, z_imag = 0;
+  int32_t  p_real = 0, p_imag = 0;  // saved orbit point for periodicity check
+  uint16_t p_len  = MANDEL_PERIOD;  // current length of periodicity check
+  uint16_t p_cnt  = 0;
+  uint16_t iter;
+
+  if(MANDEL_inBulb(real, imag)) return MANDEL_MAX_ITER;
+  if((uint32_t)(real + 2 * MANDEL_ONE) > 4 * MANDEL_ONE) return 0; // |c| > 2
+  if((uint32_t)(imag + 2 * MANDEL_ONE) > 4 * MANDEL_ONE) return 0;
+  for(iter = 0; iter < MANDEL_MAX_ITER; iter++) {
+    // |z| > 2 in any component: escaped (also keeps the products below in range)
+    if((uint32_t)(z_real + 2 * MANDEL_ONE) > 4 * MANDEL_ONE) break;
+    if((uint32_t)(z_imag + 2 * MANDEL_ONE) > 4 * MANDEL_ONE) break;
+    int32_t z_real_sq = (z_real * z_real) >> MANDEL_FRAC;
+    int32_t z_imag_sq = (z_imag * z_imag) >> MANDEL_FRAC;
+    if(z_real_sq + z_imag_sq > 4 * MANDEL_ONE) break;
+    z_imag = ((z_real * z_imag) >> (MANDEL_FRAC - 1)) + imag;
+    z_real = z_real_sq - z_imag_sq + real;
+    if(z_real == p_real && z_imag == p_imag) return MANDEL_MAX_ITER; // orbit cycles
+    if(++p_cnt == p_len) {
+      p_cnt  = 0;
+      p_len <<= 1;
+      p_real = z_real;
+      p_imag = z_imag;
+    }
+  }
+  return iter;
+}
+
+// Compute one page (8 pixel rows) into buffer
+void MANDEL_drawPage(uint8_t* buf, uint8_t page) {
+  int32_t top  = MANDEL_centerY + (page * 8 - MANDEL_HEIGHT / 2) * MANDEL_step;
+  int32_t real = MANDEL_centerX - (MANDEL_WIDTH / 2) * MANDEL_step;
+  for(uint8_t x = 0; x < MANDEL_WIDTH; x++, real += MANDEL_step) {
+    int32_t imag  = top;
+    uint8_t slice = 0;
+    for(uint8_t i = 8; i; i--, imag += MANDEL_step) {
+      uint16_t iter = MANDEL_iterate(real, imag);
+      slice >>= 1;
+      #if MANDEL_BANDS > 0
+      if(iter < MANDEL_MAX_ITER && !(iter & 1)) slice |= 0x80;
+      #else
+      if(iter < MANDEL_MAX_ITER) slice |= 0x80;
+      #endif
+    }
+    *buf++ = slice;
+  }
+}
+
+// Draw Mandelbrot on display progressively, returns 0 if aborted by user input
+uint8_t MANDEL_draw(uint8_t (*abort)(void)) {
+  for(uint8_t page = 0; page < MANDEL_HEIGHT / 8; page++) {
+    uint8_t* buf = MANDEL_page[page & 1];
+    MANDEL_drawPage(buf, page);                 // compute while last page is sent
+    if(abort && abort()) {
+      while(I2C_busy());                        // wait for last transfer
+      return 0;
+    }
+    if(!page) {                                 // first page: set cursor home
+      I2C_start(OLED_ADDR);
+      I2C_writeBuffer((uint8_t*)OLED_HOME_CMD, sizeof(OLED_HOME_CMD));
     }
+    I2C_start(OLED_ADDR);                       // waits until last page is sent
+    I2C_write(OLED_DAT_MODE);                   // set data mode
+    I2C_writeBuffer(buf, MANDEL_WIDTH);         // send page via DMA
   }
-  I2C_stop();
+  return 1;
+}
+
+// ===================================================================================
+// User Input (Rotary Encoder)
+// ===================================================================================
+#define MODE_ZOOM         0       // encoder zooms in and out
+#define MODE_PANX         1       // encoder moves view horizontally
+#define MODE_PANY         2       // encoder moves view vertically
+
+uint8_t  INPUT_mode = MODE_ZOOM;
+uint16_t INPUT_last;              // last encoder count value
+uint8_t  INPUT_key;               // last key state
+
+// Check for input, apply it to the view, returns 1 if view was changed
+uint8_t INPUT_check(void) {
+  uint8_t  changed = 0;
+  uint8_t  key = !PIN_read(PIN_KEY);
+  int16_t  delta = (int16_t)(ENC1_get() - INPUT_last) / ENC_DIV;
+
+  if(key && !INPUT_key) {                       // key pressed -> next mode
+    if(++INPUT_mode > MODE_PANY) INPUT_mode = MODE_ZOOM;
+    DEBUG_print("Mode: ");
+    DEBUG_println(INPUT_mode == MODE_ZOOM ? "zoom" : INPUT_mode == MODE_PANX ? "pan x" : "pan y");
+  }
+  INPUT_key = key;
+  if(!delta) return 0;
+  INPUT_last += delta * ENC_DIV;
+
+  for(; delta > 0; delta--) {
+    switch(INPUT_mode) {
+      case MODE_ZOOM: if(MANDEL_step > 1) MANDEL_step -= (MANDEL_step + 3) >> 2; break;
+      case MODE_PANX: MANDEL_centerX += 8 * MANDEL_step; break;
+      case MODE_PANY: MANDEL_centerY += 8 * MANDEL_step; break;
+    }
+    changed = 1;
+  }
+  for(; delta < 0; delta++) {
+    switch(INPUT_mode) {
+      case MODE_ZOOM: MANDEL_step += (MANDEL_step + 2) / 3; break;
+      case MODE_PANX: MANDEL_centerX -= 8 * MANDEL_step; break;
+      case MODE_PANY: MANDEL_centerY -= 8 * MANDEL_step; break;
+    }
+    changed = 1;
+  }
+
+  // Keep the view within range of the fixed-point numbers
+  if(MANDEL_step > MANDEL_STEP_MAX) MANDEL_step = MANDEL_STEP_MAX;
+  if(MANDEL_centerX < -2 * MANDEL_ONE) MANDEL_centerX = -2 * MANDEL_ONE;
+  if(MANDEL_centerX >  MANDEL_ONE)     MANDEL_centerX =  MANDEL_ONE;
+  if(MANDEL_centerY < -MANDEL_ONE)     MANDEL_centerY = -MANDEL_ONE;
+  if(MANDEL_centerY >  MANDEL_ONE)     MANDEL_centerY =  MANDEL_ONE;
+  return changed;
 }
 
 // ===================================================================================
 // Main Function
 // ===================================================================================
 int main(void) {
+  uint32_t time;
+
+  // Setup
+  PIN_input_PU(PIN_KEY);                        // encoder switch
+  ENC1_init();                                  // init rotary encoder
+  INPUT_last = ENC1_get();
+  INPUT_key  = 0;
+  DEBUG_init();                                 // init debug serial (PD5, 115200 BAUD)
+
   // Init OLED
   I2C_init();
   DLY_ms(50);
-  I2C_sendBuffer(OLED_ADDR, (uint8_t*)OLED_INIT_CMD, sizeof(OLED_INIT_CMD));
-
-  // Draw Mandelbrot Set on OLED
-  MANDEL_draw();
+  I2C_start(OLED_ADDR);
+  I2C_writeBuffer((uint8_t*)OLED_INIT_CMD, sizeof(OLED_INIT_CMD));
 
   // Loop
-  while(1);
+  while(1) {
+    // Draw Mandelbrot Set on OLED, start over if view was changed while drawing
+    time = STK->CNT;
+    if(MANDEL_draw(INPUT_check)) {
+      time = (STK->CNT - time) / DLY_MS_TIME;
+      DEBUG_print("Frame: "); DEBUG_printD(time);
+      DEBUG_print(" ms, zoom: "); DEBUG_printD(MANDEL_STEP_MAX / MANDEL_step);
+      DEBUG_newline();
+      while(!INPUT_check()) DLY_ms(10);         // wait for user input
+    }
+  }
 }
@@ -49,6 +49,7 @@ int main(void) {
 
   // Loop
   while(1) {
-    OLED_write(UART_read());  // print incoming character on OLED
+    if(UART_available()) OLED_write(UART_read()); // print incoming character on OLED
+    else OLED_update();       // send pending changes to OLED
   }
 }
@@ -1,5 +1,5 @@
 // ===================================================================================
-// SSD1306 128x64 Pixels OLED Terminal Functions                              * v1.1 *
+// SSD1306 128x64 Pixels OLED Terminal Functions                              * v1.3 *
 // ===================================================================================
 //
 // Collection of the most necessary functions for controlling an SSD1306 128x64 pixels
@@ -10,6 +10,35 @@
 // OLED_init()              Init OLED display
 // OLED_clear()             Clear screen of OLED display
 // OLED_write(c)            Write a character or handle control characters
+// OLED_flush()             Send pending changes to OLED
+// OLED_update()            Send pending changes if they are older than OLED_FLUSH_MS
+//
+// Characters are written into a 21x8 text buffer. Only the changed part of each
+// changed text row is rendered and sent to the OLED as a single I2C transaction
+// (together with page, column and scroll offset). Pending changes are sent:
+// - on newline ('\n'), if the OLED is idle (no transaction in progress),
+// - by OLED_update(), once the oldest pending change is OLED_FLUSH_MS old,
+// - by OLED_flush() and OLED_clear().
+// Wrapping at the end of a line, cursor movements and erase sequences don't send
+// anything. OLED_update() should therefore be called regularly, e.g. whenever there
+// is no new character to print.
+//
+// Supported control characters and VT100/ANSI escape sequences:
+// --------------------------------------------------------------
+// \n \r \b                 New line, carriage return, backspace
+// ESC[nA ESC[nB            Cursor up/down by n rows
+// ESC[nC ESC[nD            Cursor forward/back by n columns
+// ESC[r;cH ESC[r;cf        Cursor to row r, column c (starting with 1)
+// ESC[nJ                   Erase display (0: to end, 1: to cursor, 2: all)
+// ESC[nK                   Erase line (0: to end, 1: to cursor, 2: all)
+// ESC[7m ESC[27m ESC[0m    Reverse video on/off, reset attributes
+// ESC[t;br                 Set scroll region from row t to row b
+// ESC[s ESC[u ESC7 ESC8    Save/restore cursor position
+// ESCc                     Reset terminal
+//
+// Scroll regions of five or more rows are scrolled by the display offset register of
+// the SSD1306, only the rows outside the region are redrawn. Smaller regions are
+// scrolled by redrawing the rows within the region.
 //
 // If print functions are activated (see below, print.h must be included):
 // -----------------------------------------------------------------------
@@ -40,10 +69,11 @@
 extern "C" {
 #endif
 
-#include "i2c_tx.h"
+#include "i2c_dma.h"
 
 // OLED parameters
 #define OLED_PRINT        1       // 1: include print functions (needs print.h)
+#define OLED_FLUSH_MS     10      // max time in ms before pending changes are sent
 
 // OLED definitions
 #define OLED_ADDR         0x78    // OLED write address (0x3C << 1)
@@ -76,6 +106,8 @@ extern "C" {
 void OLED_init(void);             // OLED init function
 void OLED_clear(void);            // OLED clear screen
 void OLED_write(char c);          // OLED write a character or handle control characters
+void OLED_flush(void);            // OLED send pending changes of current line
+void OLED_update(void);           // OLED send pending changes after OLED_FLUSH_MS
 
 // Additional print functions (if activated, see above)
 #if OLED_PRINT == 1
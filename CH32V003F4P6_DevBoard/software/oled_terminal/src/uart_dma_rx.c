@@ -57,6 +57,7 @@ void UART_init(void) {
   USART1->CTLR1  = USART_CTLR1_RE | USART_CTLR1_UE;
 
   // Setup DMA Channel 5
+  UART_RX_tptr = 0;
   RCC->AHBPCENR |= RCC_DMA1EN;
   DMA1_Channel5->CNTR  = (uint16_t)UART_RX_BUF_SIZE;
   DMA1_Channel5->MADDR = (uint32_t)UART_RX_buffer;
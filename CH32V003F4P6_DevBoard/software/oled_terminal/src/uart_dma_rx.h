@@ -35,7 +35,7 @@ extern "C" {
 // UART Parameters
 #define UART_BAUD             115200      // default UART baud rate
 #define UART_MAP              0           // UART pin remapping (see above)
-#define UART_RX_BUF_SIZE      64          // UART RX buffer size
+#define UART_RX_BUF_SIZE      128         // UART RX buffer size
 
 // UART Functions
 void UART_init(void);                     // init UART with default BAUD rate
@@ -0,0 +1,135 @@
+// ===================================================================================
+// Host-Side Test and Benchmark for print.c
+// ===================================================================================
+//
+// 1. Compares the output of printD(), printF(), printBufF() (incl. fixed-point %.Nd)
+//    and sprintF() with the C library's printf for 2M pseudo-random values.
+// 2. Measures printD() and printF() against the v1.1 implementation (print_v11.c),
+//    which is also built with a software divider as used on cores without one.
+//
+// Build with "make" (shift/add decimal conversion as on CH32V003) or "make MUL=1"
+// (lookup table path as on cores with hardware multiplier). The timings are host
+// timings, only the ratios are meaningful for the microcontrollers.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <time.h>
+#include "print.h"
+
+// v1.1 reference implementations
+#define V11(name) v11_##name
+#include "print_v11.c"
+#undef  V11
+#define V11(name) v11sd_##name
+#define V11_SOFTDIV
+#include "print_v11.c"
+
+#define TEST_VALUES   2000000                     // number of values for output test
+#define BENCH_VALUES  4096                        // number of values for benchmark
+
+// Output sinks
+static char     out[256];
+static uint16_t outlen;
+static volatile uint32_t sink;
+static void putOut(char c)  { out[outlen++] = c; }
+static void putSink(char c) { sink += c; }
+static void putBuf(const uint8_t* buf, uint16_t len) {
+  memcpy(out + outlen, buf, len);
+  outlen += len;
+}
+
+// Xorshift pseudo-random number generator with random magnitude
+static uint32_t rnd(void) {
+  static uint32_t x = 12345;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  return x >> (x % 32);
+}
+
+static double now(void) {
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+static int errors = 0;
+static void check(const char* what, const char* ref) {
+  out[outlen] = 0;
+  if(strcmp(out, ref) && (errors++ < 10))
+    printf("%s: got \"%s\", expected \"%s\"\n", what, out, ref);
+}
+
+int main(void) {
+  char ref[256];
+
+  // Output test
+  for(long i=0; i<TEST_VALUES; i++) {
+    uint32_t v  = rnd();
+    int32_t  sv = (int32_t)rnd() * ((i & 1) ? -1 : 1);
+    if(i % 97 == 0) v  = 0xFFFFFFFF;
+    if(i % 89 == 0) sv = INT32_MIN;
+
+    outlen = 0; printD(putOut, v);
+    sprintf(ref, "%u", v);
+    check("printD", ref);
+
+    outlen = 0; printF(putOut, "a%d|%5d|%06d|%u|%x|%08x|%c%s%%",
+                       sv, sv % 1000, sv % 1000, v, v, v, 'Z', "st");
+    sprintf(ref, "a%d|%5d|%06d|%u|%X|%08X|%c%s%%",
+                       sv, sv % 1000, sv % 1000, v, v, v, 'Z', "st");
+    check("printF", ref);
+
+    int dec = i % 4;
+    int32_t fv = sv % 100000, p10 = 1;
+    char fmt[8];
+    for(int k=0; k<dec; k++) p10 *= 10;
+    sprintf(fmt, "%%.%dd", dec);
+    outlen = 0; printBufF(putBuf, fmt, fv);
+    if(dec) sprintf(ref, "%s%d.%0*d", (fv < 0) ? "-" : "", abs(fv) / p10, dec, abs(fv) % p10);
+    else    sprintf(ref, "%d", fv);
+    check("printBufF", ref);
+
+    outlen = 0; printF(putOut, "%b", v & 0xFFF);
+    int n = 0; char tmp[16];
+    uint32_t t = v & 0xFFF;
+    do { tmp[n++] = '0' + (t & 1); t >>= 1; } while(t);
+    for(int k=0; k<n; k++) ref[k] = tmp[n-1-k];
+    ref[n] = 0;
+    check("printF %b", ref);
+
+    outlen = 0; printFix(putOut, sv, 9 + (i % 8));   // dec > 9 is limited to 9
+    sprintf(ref, "%s%u.%09u", (sv < 0) ? "-" : "",
+            (uint32_t)llabs(sv) / 1000000000, (uint32_t)llabs(sv) % 1000000000);
+    check("printFix", ref);
+  }
+  outlen = sprintF(out, "%s=%.1d C, %u%%|%07.3d", "T", 215, 42u, -1234);
+  check("sprintF", "T=21.5 C, 42%|-01.234");
+  printf("Output test: %s (%d errors)\n", errors ? "FAILED" : "OK", errors);
+
+  // Benchmark
+  static uint32_t vals[BENCH_VALUES];
+  for(int i=0; i<BENCH_VALUES; i++) vals[i] = rnd();
+  double t0 = now();
+  for(int r=0; r<2000; r++) for(int i=0; i<BENCH_VALUES; i++) v11_printD(putSink, vals[i]);
+  double t1 = now();
+  for(int r=0; r<2000; r++) for(int i=0; i<BENCH_VALUES; i++) printD(putSink, vals[i]);
+  double t2 = now();
+  for(int r=0; r<500; r++) for(int i=0; i<BENCH_VALUES; i++)
+    v11_printF(putSink, "V=%d mV %5d", vals[i], vals[i] & 0xFFF);
+  double t3 = now();
+  for(int r=0; r<500; r++) for(int i=0; i<BENCH_VALUES; i++)
+    v11sd_printF(putSink, "V=%d mV %5d", vals[i], vals[i] & 0xFFF);
+  double t4 = now();
+  for(int r=0; r<500; r++) for(int i=0; i<BENCH_VALUES; i++)
+    printF(putSink, "V=%d mV %5d", vals[i], vals[i] & 0xFFF);
+  double t5 = now();
+  printf("printD:             v1.1 %6.1f ns, now %6.1f ns\n",
+         (t1 - t0) / (2000.0 * BENCH_VALUES) * 1e9, (t2 - t1) / (2000.0 * BENCH_VALUES) * 1e9);
+  printf("printF \"V=%%d mV %%5d\": v1.1 %6.1f ns (%6.1f ns with software divider), now %6.1f ns\n",
+         (t3 - t2) / (500.0 * BENCH_VALUES) * 1e9, (t4 - t3) / (500.0 * BENCH_VALUES) * 1e9,
+         (t5 - t4) / (500.0 * BENCH_VALUES) * 1e9);
+  return errors ? 1 : 0;
+}
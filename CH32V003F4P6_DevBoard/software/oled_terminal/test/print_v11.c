@@ -0,0 +1,134 @@
+// ===================================================================================
+// Reference: printD() and printF() of print.c v1.1 (host-side benchmark only)
+// ===================================================================================
+//
+// This file is included by print_bench.c with V11(name) defined as a name prefix.
+// With V11_SOFTDIV defined, divisions use a bitwise restoring divider like libgcc
+// on cores without a hardware divider (CH32V003, Cortex-M0).
+
+#if defined(V11_SOFTDIV)
+// Restoring division, one bit per step
+static uint32_t __attribute__((noinline)) V11(udiv)(uint32_t n, uint32_t d, uint32_t* rem) {
+  uint32_t q = 0, r = 0;
+  for(int8_t i=31; i>=0; i--) {
+    r = (r << 1) | ((n >> i) & 1);
+    if(r >= d) { r -= d; q |= (uint32_t)1 << i; }
+  }
+  *rem = r;
+  return q;
+}
+#endif
+
+// For BCD conversion
+static const uint32_t V11(DIVIDER)[] = {1, 10, 100, 1000, 10000, 100000, 1000000,
+                                        10000000, 100000000, 1000000000};
+
+// Print decimal value (BCD conversion by substraction method)
+static void V11(printD)(void (*putchar) (char c), uint32_t value) {
+  uint8_t digits   = 10;                    // print 10 digits
+  uint8_t leadflag = 0;                     // flag for leading spaces
+  while(digits--) {                         // for all digits
+    uint8_t digitval = 0;                   // start with digit value 0
+    uint32_t divider = V11(DIVIDER)[digits];// read current divider
+    while(value >= divider) {               // if current divider fits into the value
+      leadflag = 1;                         // end of leading spaces
+      digitval++;                           // increase digit value
+      value -= divider;                     // decrease value by divider
+    }
+    if(!digits)  leadflag++;                // least digit has to be printed
+    if(leadflag) putchar(digitval + '0');   // print the digit
+  }
+}
+
+static void V11(itoa)(void (*putchar) (char c), int32_t val, int8_t rad, int8_t len) {
+  char c, sgn = 0, pad = ' ';
+  char s[20];
+  uint8_t i = 0;
+
+  if(rad < 0) {
+    rad = -rad;
+    if(val < 0) {
+      val = -val;
+      sgn = '-';
+    }
+  }
+  if(len < 0) {
+    len = -len;
+    pad = '0';
+  }
+  if(len > 20) return;
+  do {
+    #if defined(V11_SOFTDIV)
+    uint32_t rem;
+    uint32_t quot = V11(udiv)((uint32_t)val, rad, &rem);
+    c = (char)rem;
+    #else
+    c = (char)((uint32_t)val % rad);
+    #endif
+    if (c >= 10) c += ('A' - 10);
+    else c += '0';
+    s[i++] = c;
+    #if defined(V11_SOFTDIV)
+    val = quot;
+    #else
+    val = (uint32_t)val / rad;
+    #endif
+  } while(val);
+  if((sgn != 0) && (pad != '0')) s[i++] = sgn;
+  while(i < len) s[i++] = pad;
+  if((sgn != 0) && (pad == '0')) s[i++] = sgn;
+  do putchar(s[--i]);
+  while(i);
+}
+
+static void V11(vfprintf)(void (*putchar) (char c), const char* str,  va_list arp) {
+  int32_t d, r, w, s;
+  char *c;
+
+  while((d = *str++) != 0) {
+    if(d != '%') {
+      putchar(d);
+      continue;
+    }
+    d = *str++;
+    w = r = s = 0;
+    if(d == '%') {
+      putchar(d);
+      d = *str++;
+    }
+    if(d == '0') {
+      d = *str++;
+      s = 1;
+    }
+    while((d >= '0') && (d <= '9')) {
+      w += w * 10 + (d - '0');
+      d = *str++;
+    }
+    if(s) w = -w;
+    if(d == 's') {
+      c = va_arg(arp, char*);
+      while(*c) putchar(*(c++));
+      continue;
+    }
+    if(d == 'c') {
+      putchar((char)va_arg(arp, int));
+      continue;
+    }
+    if(d =='\0') break;
+    else if(d == 'u') r = 10;
+    else if(d == 'd') r = -10;
+    else if(d == 'x') r = 16;
+    else if(d == 'b') r = 2;
+    else str--;
+    if(r == 0) continue;
+    if(r > 0) V11(itoa)(putchar, (uint32_t)va_arg(arp, int32_t), r, w);
+    else V11(itoa)(putchar, (int32_t)va_arg(arp, int32_t), r, w);
+  }
+}
+
+static void V11(printF)(void (*putchar) (char c), const char *format, ...) {
+  va_list arg;
+  va_start(arg, format);
+  V11(vfprintf)(putchar, format, arg);
+  va_end(arg);
+}
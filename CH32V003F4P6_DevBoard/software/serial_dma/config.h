@@ -5,7 +5,7 @@
 // Description:
 // ------------
 // Echoes data sent via UART (UART BAUD: 115200, 8N1, TX: PD5, RX: PD6).
-// Uses DMA for UART RX.
+// Uses DMA for UART RX and TX.
 
 #pragma once
 
@@ -10,7 +10,8 @@
 //
 // Description:
 // ------------
-// Echoes data sent via UART. Uses DMA for UART RX.
+// Echoes data sent via UART. Uses DMA for UART RX and TX. Received data is passed
+// block by block directly from the RX buffer to the TX buffer.
 //
 // References:
 // -----------
@@ -36,10 +37,16 @@
 // ===================================================================================
 int main(void) {
   // Setup
+  const char* ptr;
+  uint16_t len;
   UART_init();                // init UART with default BAUD rate (115200)
   
   // Loop
   while(1) {
-    UART_write(UART_read());  // echo any received character
+    UART_peekSpan(&ptr, &len);  // get received data
+    if(len) {
+      UART_writeBuffer(ptr, len); // echo received data
+      UART_consume(len);        // mark data as read
+    }
   }
 }
@@ -1,5 +1,5 @@
 // ===================================================================================
-// UART with DMA RX Buffer for CH32V003                                       * v1.1 *
+// UART with DMA RX and TX Buffer for CH32V003                                * v1.5 *
 // ===================================================================================
 // 2023 by Stefan Wagner:   https://github.com/wagiminator
 
@@ -7,9 +7,44 @@
 
 // Circular RX buffer
 char UART_RX_buffer[UART_RX_BUF_SIZE];
-uint8_t UART_RX_tptr = 0;
+volatile uint16_t UART_RX_tptr = 0;
 #define UART_RX_hptr (UART_RX_BUF_SIZE - DMA1_Channel5->CNTR)
 
+// RX notifications
+#if UART_RX_NOTIFY > 0
+uint16_t UART_RX_last;                      // DMA write position at last event
+uint16_t UART_RX_hcnt;                      // bytes received (free-running, by ISR)
+volatile uint16_t UART_RX_tcnt;             // bytes read (free-running, by reader)
+volatile uint8_t  UART_RX_drop;             // 1: overrun, reader drops unread data
+uint16_t UART_RX_dropPtr, UART_RX_dropCnt;  // read position and count after drop
+volatile uint16_t UART_RX_overruns;         // number of RX buffer overruns
+void (*UART_RX_callback)(void);             // frame-ready callback function
+
+// Drop unread data after an overrun (only the reader writes UART_RX_tptr)
+static inline void UART_RX_check(void) {
+  if(UART_RX_drop) {
+    INT_ATOMIC_BLOCK {
+      UART_RX_drop = 0;
+      UART_RX_tptr = UART_RX_dropPtr;       // continue with data after the overrun
+      UART_RX_tcnt = UART_RX_dropCnt;
+    }
+  }
+}
+  #define UART_RX_count(n)  UART_RX_tcnt += (n)
+#else
+  #define UART_RX_check()
+  #define UART_RX_count(n)
+#endif
+
+// Circular TX buffer
+#if UART_TX_BUF_SIZE > 0
+char UART_TX_buffer[UART_TX_BUF_SIZE];
+volatile uint16_t UART_TX_hptr;             // next free position (written by UART_write)
+volatile uint16_t UART_TX_tptr;             // first byte not yet sent (moved by DMA ISR)
+volatile uint16_t UART_TX_dlen;             // length of current DMA transfer (0: idle)
+uint16_t UART_TX_hwm;                       // high-water mark
+#endif
+
 // Init UART
 void UART_init(void) {
 #if UART_MAP == 0
@@ -58,6 +93,9 @@ void UART_init(void) {
   // Setup and start UART (8N1, RX/TX, default BAUD rate)
   USART1->BRR    = ((2 * F_CPU / UART_BAUD) + 1) / 2;
   USART1->CTLR3 |= USART_CTLR3_DMAR;
+  #if UART_TX_BUF_SIZE > 0
+  USART1->CTLR3 |= USART_CTLR3_DMAT;
+  #endif
   USART1->CTLR1  = USART_CTLR1_RE | USART_CTLR1_TE | USART_CTLR1_UE;
 
   // Setup DMA Channel 5
@@ -67,25 +105,207 @@ void UART_init(void) {
   DMA1_Channel5->PADDR = (uint32_t)&USART1->DATAR;
   DMA1_Channel5->CFGR  = DMA_CFGR1_MINC       // increment memory address
                        | DMA_CFGR1_CIRC       // circular mode
+                       #if UART_RX_NOTIFY > 0
+                       | DMA_CFGR1_HTIE       // half transfer interrupt enable
+                       | DMA_CFGR1_TCIE       // transfer complete interrupt enable
+                       #endif
                        | DMA_CFGR1_EN;        // enable
+
+  // Setup RX notifications (idle line and DMA half/full transfer)
+  #if UART_RX_NOTIFY > 0
+  UART_RX_tptr = 0; UART_RX_last = 0; UART_RX_hcnt = 0; UART_RX_tcnt = 0;
+  UART_RX_drop = 0; UART_RX_overruns = 0; UART_RX_callback = 0;
+  DMA1->INTFCR   = DMA_CGIF5;                 // clear interrupt flags
+  USART1->CTLR1 |= USART_CTLR1_IDLEIE;        // enable idle line interrupt
+  NVIC_EnableIRQ(DMA1_Channel5_IRQn);         // enable the DMA IRQ
+  NVIC_EnableIRQ(USART1_IRQn);                // enable the USART IRQ
+  #endif
+
+  // Setup DMA Channel 4 (TX)
+  #if UART_TX_BUF_SIZE > 0
+  UART_TX_hptr = 0; UART_TX_tptr = 0; UART_TX_dlen = 0; UART_TX_hwm = 0;
+  DMA1_Channel4->PADDR = (uint32_t)&USART1->DATAR;
+  DMA1_Channel4->CFGR  = DMA_CFGR1_MINC       // increment memory address
+                       | DMA_CFGR1_DIR        // memory to UART
+                       | DMA_CFGR1_TCIE;      // transfer complete interrupt enable
+  DMA1->INTFCR         = DMA_CGIF4;           // clear interrupt flags
+  NVIC_EnableIRQ(DMA1_Channel4_IRQn);         // enable the DMA IRQ
+  #endif
 }
 
 // Check if something is in the RX buffer
 uint8_t UART_available(void) {
+  UART_RX_check();
   return(UART_RX_hptr != UART_RX_tptr);
 }
 
 // Read from UART buffer
 char UART_read(void) {
   char result;
+  uint16_t tptr;
   while(!UART_available());
-  result = UART_RX_buffer[UART_RX_tptr++];
-  if(UART_RX_tptr >= UART_RX_BUF_SIZE) UART_RX_tptr = 0;
+  tptr = UART_RX_tptr;
+  result = UART_RX_buffer[tptr++];
+  if(tptr >= UART_RX_BUF_SIZE) tptr = 0;
+  UART_RX_tptr = tptr;
+  UART_RX_count(1);
   return result;
 }
 
+// Get pointer to and length of contiguous unread data in RX buffer (zero-copy)
+void UART_peekSpan(const char** ptr, uint16_t* len) {
+  UART_RX_check();
+  uint16_t hptr = UART_RX_hptr;
+  uint16_t tptr = UART_RX_tptr;
+  *ptr = &UART_RX_buffer[tptr];
+  *len = (hptr >= tptr) ? (hptr - tptr) : (UART_RX_BUF_SIZE - tptr);
+}
+
+// Mark n bytes in RX buffer as read
+void UART_consume(uint16_t n) {
+  uint16_t tptr = UART_RX_tptr + n;
+  if(tptr >= UART_RX_BUF_SIZE) tptr -= UART_RX_BUF_SIZE;
+  UART_RX_tptr = tptr;
+  UART_RX_count(n);
+}
+
+#if UART_RX_NOTIFY > 0
+
+// Set frame-ready callback function (called on idle line after reception)
+void UART_RX_setCallback(void (*callback)(void)) {
+  UART_RX_callback = callback;
+}
+
+// Update DMA write position and check for overrun (called by interrupts)
+// (half/full transfer interrupts keep the bytes received between two events below
+// the buffer size, so the free-running counters give the exact number of unread bytes)
+static void UART_RX_update(void) {
+  uint16_t hptr  = UART_RX_hptr;
+  int16_t  delta = hptr - UART_RX_last;       // bytes received since last event
+  if(delta < 0) delta += UART_RX_BUF_SIZE;
+  UART_RX_hcnt += delta;
+  UART_RX_last  = hptr;
+  if((uint16_t)(UART_RX_hcnt - UART_RX_tcnt) >= UART_RX_BUF_SIZE) { // DMA passed tptr?
+    UART_RX_overruns++;                       // -> count overrun
+    UART_RX_dropPtr = hptr;                   // -> reader discards buffer content
+    UART_RX_dropCnt = UART_RX_hcnt;
+    UART_RX_drop    = 1;
+  }
+}
+
+// DMA channel 5 (RX) interrupt service routine (half and full transfer)
+void DMA1_Channel5_IRQHandler(void) __attribute__((interrupt));
+void DMA1_Channel5_IRQHandler(void) {
+  DMA1->INTFCR = DMA_CGIF5;                   // clear interrupt flags
+  UART_RX_update();
+}
+
+// USART1 interrupt service routine (idle line detected)
+void USART1_IRQHandler(void) __attribute__((interrupt));
+void USART1_IRQHandler(void) {
+  if(USART1->STATR & USART_STATR_IDLE) {
+    (void)USART1->DATAR;                      // clear idle flag
+    UART_RX_update();
+    if(UART_RX_callback) UART_RX_callback();  // frame is ready
+  }
+}
+
+#endif
+
+#if UART_TX_BUF_SIZE == 0
+
 // Send byte via UART
 void UART_write(const char c) {
   while(!UART_ready());
   USART1->DATAR = c;
 }
+
+// Send buffer via UART
+void UART_writeBuffer(const char* buf, uint16_t len) {
+  while(len--) UART_write(*buf++);
+}
+
+// Wait until transmission is completed
+void UART_flush(void) {
+  while(!UART_completed());
+}
+
+#else
+
+// Start DMA transfer of next contiguous block in TX buffer (if DMA is idle)
+static void UART_TX_start(void) {
+  INT_ATOMIC_BLOCK {
+    uint16_t hptr = UART_TX_hptr;
+    uint16_t tptr = UART_TX_tptr;
+    if(!UART_TX_dlen && (hptr != tptr)) {
+      UART_TX_dlen = (hptr > tptr) ? (hptr - tptr) : (UART_TX_BUF_SIZE - tptr);
+      DMA1_Channel4->CNTR  = UART_TX_dlen;
+      DMA1_Channel4->MADDR = (uint32_t)&UART_TX_buffer[tptr];
+      USART1->STATR = ~USART_STATR_TC;    // clear TC, set again after the last byte
+      DMA1_Channel4->CFGR |= DMA_CFGR1_EN;
+    }
+  }
+}
+
+// Get number of bytes in TX buffer
+uint16_t UART_TX_level(void) {
+  int16_t level = UART_TX_hptr - UART_TX_tptr;
+  if(level < 0) level += UART_TX_BUF_SIZE;
+  return level;
+}
+
+// Update high-water mark
+static inline void UART_TX_mark(void) {
+  uint16_t level = UART_TX_level();
+  if(level > UART_TX_hwm) UART_TX_hwm = level;
+}
+
+// Put byte into TX buffer (returns 0 if buffer is full and UART_TX_BLOCK = 0)
+static uint8_t UART_TX_put(const char c) {
+  uint16_t next = UART_TX_hptr + 1;
+  if(next >= UART_TX_BUF_SIZE) next = 0;
+  while(next == UART_TX_tptr) {             // buffer full?
+    #if UART_TX_BLOCK > 0
+    UART_TX_start();                        // -> make sure DMA is running and wait
+    #else
+    return 0;                               // -> discard byte
+    #endif
+  }
+  UART_TX_buffer[UART_TX_hptr] = c;
+  UART_TX_hptr = next;
+  UART_TX_mark();                           // sample level while the DMA drains
+  return 1;
+}
+
+// Send byte via UART (put into TX buffer)
+void UART_write(const char c) {
+  UART_TX_put(c);
+  UART_TX_start();
+}
+
+// Send buffer via UART (put into TX buffer)
+void UART_writeBuffer(const char* buf, uint16_t len) {
+  while(len-- && UART_TX_put(*buf++));
+  UART_TX_start();
+}
+
+// Wait until TX buffer is empty and transmission is completed
+void UART_flush(void) {
+  while(UART_TX_hptr != UART_TX_tptr);
+  while(!UART_completed());
+}
+
+// DMA channel 4 (TX) interrupt service routine
+void DMA1_Channel4_IRQHandler(void) __attribute__((interrupt));
+void DMA1_Channel4_IRQHandler(void) {
+  uint16_t tptr;
+  DMA1_Channel4->CFGR &= ~DMA_CFGR1_EN;     // disable DMA channel
+  DMA1->INTFCR = DMA_CGIF4;                 // clear interrupt flags
+  tptr = UART_TX_tptr + UART_TX_dlen;       // release transmitted bytes
+  if(tptr >= UART_TX_BUF_SIZE) tptr = 0;
+  UART_TX_tptr = tptr;
+  UART_TX_dlen = 0;
+  UART_TX_start();                          // send next block
+}
+
+#endif
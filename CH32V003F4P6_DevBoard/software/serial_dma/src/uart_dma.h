@@ -1,5 +1,5 @@
 // ===================================================================================
-// UART with DMA RX Buffer for CH32V003                                       * v1.1 *
+// UART with DMA RX and TX Buffer for CH32V003                                * v1.5 *
 // ===================================================================================
 //
 // Functions available:
@@ -17,7 +17,15 @@
 // UART_completed()         Check if transmission is completed
 //
 // UART_read()              Read character via UART
+// UART_peekSpan(&p,&l)     Get pointer (p) and length (l) of contiguous unread RX data
+// UART_consume(n)          Mark n bytes of RX data as read (after UART_peekSpan)
 // UART_write(c)            Send character via UART
+// UART_writeBuffer(b,l)    Send buffer (*b) with length (l) via UART
+// UART_flush()             Wait until TX buffer is empty and transmission is completed
+// UART_TX_level()          Number of bytes in TX buffer waiting to be sent
+// UART_TX_highWater()      Highest fill level of TX buffer since init
+// UART_RX_setCallback(f)   Set function (f) to be called when a frame is received
+// UART_RX_overruns         Number of RX buffer overruns (unread data overwritten)
 //
 // UART_enable()            Enable USART
 // UART_disable()           Disable USART
@@ -28,7 +36,7 @@
 //
 // If print functions are activated (see below, print.h must be included):
 // -----------------------------------------------------------------------
-// UART_printf(f, ...)      printf (supports %s, %c, %d, %u, %x, %b, %02d, %%)
+// UART_printf(f, ...)      printf (supports %s, %c, %d, %u, %x, %b, %02d, %.2d, %%)
 // UART_printD(n)           Print decimal value
 // UART_printW(n)           Print 32-bit hex word value
 // UART_printH(n)           Print 16-bit hex half-word value
@@ -38,6 +46,20 @@
 // UART_println(s)          Print string with newline
 // UART_newline()           Send newline
 //
+// Notes:
+// ------
+// - If UART_TX_BUF_SIZE > 0, UART_write() and UART_writeBuffer() just copy the data
+//   into the TX ring buffer, which is drained via DMA in the background. They only
+//   wait if the buffer is full (or discard data if UART_TX_BLOCK = 0).
+// - If UART_RX_NOTIFY > 0, the DMA half/full transfer and the idle line interrupts
+//   keep track of received data. If unread data is overwritten, UART_RX_overruns is
+//   incremented and the next read access discards the unread data. The callback is
+//   executed in interrupt context when the line becomes idle after receiving data.
+// - With UART_PRINT, strings and decimal values are passed to UART_writeBuffer() as a
+//   whole, so with UART_TX_BUF_SIZE > 0 each call copies them into the TX buffer at once.
+// - UART_peekSpan() gives direct access to the RX buffer. Because the buffer is
+//   circular, call it again after UART_consume() to get data wrapped to the start.
+//
 // USART1 pin mapping (set below in UART parameters):
 // --------------------------------------------------
 // UART_MAP   0     1     2     3
@@ -52,14 +74,22 @@
 extern "C" {
 #endif
 
-#include "ch32v003.h"
+#include "system.h"
 
 // UART Parameters
 #define UART_BAUD             115200      // default UART baud rate
 #define UART_MAP              0           // UART pin mapping (see above)
 #define UART_RX_BUF_SIZE      64          // UART RX buffer size
+#define UART_TX_BUF_SIZE      128         // UART TX buffer size (0: no TX buffer)
+#define UART_TX_BLOCK         1           // 1: wait if TX buffer full, 0: discard data
+#define UART_RX_NOTIFY        1           // 1: idle line and DMA interrupts for RX
 #define UART_PRINT            0           // 1: include print functions (needs print.h)
 
+// Interrupt enable check
+#if (UART_TX_BUF_SIZE > 0 || UART_RX_NOTIFY > 0) && SYS_USE_VECTORS == 0
+  #error Interrupt vector table must be enabled (SYS_USE_VECTORS in system.h)!
+#endif
+
 // UART Macros
 #define UART_ready()          (USART1->STATR & USART_STATR_TXE)   // ready to write
 #define UART_completed()      (USART1->STATR & USART_STATR_TC)    // transmission completed
@@ -83,19 +113,37 @@ void UART_init(void);                     // init UART with default BAUD rate
 void UART_write(const char c);            // send character via UART
 char UART_read(void);                     // read character via UART
 uint8_t UART_available(void);             // check if there is something to read
+void UART_peekSpan(const char** ptr, uint16_t* len); // get contiguous unread RX data
+void UART_consume(uint16_t n);            // mark n bytes of RX data as read
+void UART_writeBuffer(const char* buf, uint16_t len); // send buffer via UART
+void UART_flush(void);                    // wait until everything is sent
+
+#if UART_RX_NOTIFY > 0
+void UART_RX_setCallback(void (*callback)(void)); // set frame-ready callback
+extern volatile uint16_t UART_RX_overruns;
+#endif
+
+#if UART_TX_BUF_SIZE > 0
+uint16_t UART_TX_level(void);             // number of bytes in TX buffer
+extern uint16_t UART_TX_hwm;
+#define UART_TX_highWater()   (UART_TX_hwm) // highest TX buffer fill level
+#endif
 
 // Additional print functions (if activated, see above)
 #if UART_PRINT == 1
 #include "print.h"
-#define UART_printD(n)        printD(UART_write, n)   // print decimal as string
-#define UART_printW(n)        printW(UART_write, n)   // print word as string
-#define UART_printH(n)        printH(UART_write, n)   // print half-word as string
-#define UART_printB(n)        printB(UART_write, n)   // print byte as string
-#define UART_printS(s)        printS(UART_write, s)   // print string
-#define UART_println(s)       println(UART_write, s)  // print string with newline
-#define UART_print            UART_printS             // alias
-#define UART_newline()        UART_write('\n')        // send newline
-#define UART_printf(f, ...)   printF(UART_write, f, ##__VA_ARGS__)
+static inline void UART_putBuffer(const uint8_t* buf, uint16_t len) { // putbuf sink
+  UART_writeBuffer((const char*)buf, len);
+}
+#define UART_printD(n)        printBufD(UART_putBuffer, n) // print decimal as string
+#define UART_printW(n)        printW(UART_write, n)        // print word as string
+#define UART_printH(n)        printH(UART_write, n)        // print half-word as string
+#define UART_printB(n)        printB(UART_write, n)        // print byte as string
+#define UART_printS(s)        printBufS(UART_putBuffer, s) // print string
+#define UART_println(s)       {printBufS(UART_putBuffer, s); UART_write('\n');}
+#define UART_print            UART_printS                  // alias
+#define UART_newline()        UART_write('\n')             // send newline
+#define UART_printf(f, ...)   printBufF(UART_putBuffer, f, ##__VA_ARGS__)
 #endif
 
 #ifdef __cplusplus
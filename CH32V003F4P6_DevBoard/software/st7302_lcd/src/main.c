@@ -1,6 +1,6 @@
 // ===================================================================================
 // Project:   Example for CH32V003
-// Version:   v1.0
+// Version:   v1.1
 // Year:      2024
 // Author:    Stefan Wagner
 // Github:    https://github.com/wagiminator
@@ -11,6 +11,8 @@
 // Description:
 // ------------
 // ST7302 250x122 Pixels Monochrome Low-Power Liquid Crystal Display Graphics Demo. 
+// The LCD is driven via hardware SPI with DMA from a banded shadow framebuffer, so
+// each screen is drawn in a picture loop (see st7302_gfx.h).
 // Connect the LCD as follows:
 // MCU - Display
 // GND - GND
@@ -41,13 +43,19 @@
 // ===================================================================================
 // Libraries, Definitions and Macros
 // ===================================================================================
-#include <st7302_gfx_soft.h>                        // LCD graphics functions
+#include <st7302_gfx.h>                             // LCD graphics functions
 
 // ===================================================================================
 // Pseudo Random Number Generator
 // ===================================================================================
+uint32_t rnval;
+
+// Restart random sequence (each band of a picture loop needs the same numbers)
+void seed(void) {
+  rnval = 0xACE1DFEE;
+}
+
 uint32_t random(uint32_t max) {
-  static uint32_t rnval = 0xACE1DFEE;
   rnval = rnval << 16 | (rnval << 1 ^ rnval << 2) >> 16;
   return(rnval % max);
 }
@@ -70,77 +78,103 @@ const uint8_t ANT[] = {
   0x01, 0x02, 0x04, 0x7F, 0x04, 0x02, 0x01
 };
 
+// ===================================================================================
+// Screens (drawn band by band, so they must not change state between calls)
+// ===================================================================================
+void drawHello(void) {
+  uint16_t i;
+  seed();
+  for(i=200; i; i--) LCD_setPixel(random(LCD_WIDTH), random(LCD_HEIGHT), 1);
+  for(i=32; i; i--) LCD_drawCircle(100, 50, i, 1);
+  LCD_drawSprite(20, 10, 32, 16, UFO);
+  LCD_cursor(150,  0); LCD_textsize(1);           LCD_print("Hello World");
+  LCD_cursor(150, 12); LCD_textsize(LCD_STRETCH); LCD_print("1234567890");
+  LCD_cursor(150, 36); LCD_textsize(LCD_SMOOTH);  LCD_print("12345");
+  LCD_cursor(150, 60); LCD_textsize(4);           LCD_print("TEST");
+}
+
+void drawRadio(void) {
+  uint8_t strength = 32;
+  uint8_t volume = 10;
+  LCD_cursor(0, 0); LCD_textsize(LCD_SMOOTH); LCD_print("FM Radio");
+  LCD_drawBitmap(121, 0, 7, 16, BAT_OK);
+  LCD_cursor(-10, 20); LCD_printSegment(10885, 5, 1, 2);
+  LCD_cursor(94, 36); LCD_print("MHz");
+  LCD_drawBitmap(94, 20, 7, 8, ANT);
+  LCD_drawRect(104, 20, 24, 7, 1);
+  if(strength > 64) strength = 64;
+  strength = (strength >> 2) + (strength >> 3);
+  if(strength) LCD_fillRect(104, 20, strength, 7, 1);
+  LCD_cursor(0, 56); LCD_textsize(1); LCD_print("Volume:");
+  LCD_drawRect(50, 56, 78, 7, 1);
+  uint8_t xpos = 47;
+  while(volume--) LCD_fillRect(xpos+=5, 58, 4, 3, 1);
+
+  LCD_fillCircle(144 + 25, 25, 25, 1);
+  LCD_drawCircle(144 + 55 + 25, 25, 25, 1);
+  LCD_fillRect(144, 60, 50, 50, 1);
+  LCD_drawRect(144 + 55, 60, 50, 50, 1);
+}
+
+void drawLines(void) {
+  seed();
+  for(uint16_t i=300; i; i--) {
+    LCD_drawLine(random(LCD_WIDTH), random(LCD_HEIGHT), random(LCD_WIDTH), random(LCD_HEIGHT), 1);
+  }
+}
+
+void drawRects(void) {
+  seed();
+  for(uint16_t i=300; i; i--) {
+    LCD_drawRect(random(LCD_WIDTH), random(LCD_HEIGHT), random(LCD_WIDTH/2), random(LCD_HEIGHT/2), 1);
+  }
+}
+
+void drawCircles(void) {
+  seed();
+  for(uint16_t i=300; i; i--) {
+    LCD_drawCircle(random(LCD_WIDTH), random(LCD_HEIGHT), random(16), 1);
+  }
+  for(uint16_t i=100; i; i--) {
+    LCD_cursor(random(LCD_WIDTH), random(LCD_HEIGHT));
+    LCD_textsize(random(3) + 1);
+    LCD_textinvert(random(2));
+    LCD_print("Hello");
+  }
+  LCD_textinvert(0);
+}
+
+// Draw screen in a picture loop
+void draw(void (*screen)(void)) {
+  LCD_firstBand();
+  do {
+    screen();
+  } while(LCD_nextBand());
+}
+
 // ===================================================================================
 // Main Function
 // ===================================================================================
 int main(void) {
-  // Variables
-  uint16_t i;
-  
   // Setup
   LCD_init();
 
   // Loop
   while(1) {
-    LCD_clear();
-    for(i=200; i; i--) LCD_setPixel(random(LCD_WIDTH), random(LCD_HEIGHT), 1);
-    for(i=32; i; i--) LCD_drawCircle(100, 50, i, 1);
-    LCD_drawSprite(20, 10, 32, 16, UFO);
-    LCD_cursor(150,  0); LCD_textsize(1);           LCD_print("Hello World");
-    LCD_cursor(150, 12); LCD_textsize(LCD_STRETCH); LCD_print("1234567890");
-    LCD_cursor(150, 36); LCD_textsize(LCD_SMOOTH);  LCD_print("12345");
-    LCD_cursor(150, 60); LCD_textsize(4);           LCD_print("TEST");
-    LCD_flush();
+    draw(drawHello);
     DLY_ms(3000);
 
-    uint8_t strength = 32;
-    uint8_t volume = 10;
-    LCD_clear();
-    LCD_cursor(0, 0); LCD_textsize(LCD_SMOOTH); LCD_print("FM Radio");
-    LCD_drawBitmap(121, 0, 7, 16, BAT_OK);
-    LCD_cursor(-10, 20); LCD_printSegment(10885, 5, 1, 2);
-    LCD_cursor(94, 36); LCD_print("MHz");
-    LCD_drawBitmap(94, 20, 7, 8, ANT);
-    LCD_drawRect(104, 20, 24, 7, 1);
-    if(strength > 64) strength = 64;
-    strength = (strength >> 2) + (strength >> 3);
-    if(strength) LCD_fillRect(104, 20, strength, 7, 1);
-    LCD_cursor(0, 56); LCD_textsize(1); LCD_print("Volume:");
-    LCD_drawRect(50, 56, 78, 7, 1);
-    uint8_t xpos = 47;
-    while(volume--) LCD_fillRect(xpos+=5, 58, 4, 3, 1);
-
-    LCD_fillCircle(144 + 25, 25, 25, 1);
-    LCD_drawCircle(144 + 55 + 25, 25, 25, 1);
-    LCD_fillRect(144, 60, 50, 50, 1);
-    LCD_drawRect(144 + 55, 60, 50, 50, 1);
-    LCD_flush();
+    draw(drawRadio);
     DLY_ms(3000);
     LCD_invert(!LCD_INVERT);
     DLY_ms(3000);
     LCD_invert(LCD_INVERT);
 
-    LCD_clear();
-    for(i = 300; i; i--) {
-      LCD_drawLine(random(LCD_WIDTH), random(LCD_HEIGHT), random(LCD_WIDTH), random(LCD_HEIGHT), 1);
-    }
-
-    LCD_clear();
-    for(i = 300; i; i--) {
-      LCD_drawRect(random(LCD_WIDTH), random(LCD_HEIGHT), random(LCD_WIDTH/2), random(LCD_HEIGHT/2), 1);
-    }
-
-    LCD_clear();
-    for(i = 300; i; i--) {
-      LCD_drawCircle(random(LCD_WIDTH), random(LCD_HEIGHT), random(16), 1);
-    }
-
-    for(i = 100; i; i--) {
-      LCD_cursor(random(LCD_WIDTH), random(LCD_HEIGHT));
-      LCD_textsize(random(3) + 1);
-      LCD_textinvert(random(2));
-      LCD_print("Hello");
-    }
-    LCD_textinvert(0);
+    draw(drawLines);
+    DLY_ms(1000);
+    draw(drawRects);
+    DLY_ms(1000);
+    draw(drawCircles);
+    DLY_ms(1000);
   }
 }
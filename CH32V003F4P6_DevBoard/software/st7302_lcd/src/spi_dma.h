@@ -0,0 +1,74 @@
+// ===================================================================================
+// Basic SPI Master Functions (TX only) with DMA for CH32V003                 * v1.0 *
+// ===================================================================================
+//
+// Functions available:
+// --------------------
+// SPI_init()               Init SPI with defined clock rate (see below) and DMA
+// SPI_write(d)             Transmit one data byte
+// SPI_writeBuffer(buf,len) Transmit (len) bytes from (*buf) via DMA
+// SPI_writeBuffer16(b,len) Transmit (len) 16-bit words (MSB first) from (*b) via DMA
+// SPI_fill(d,len)          Transmit data byte (d) (len) times via DMA
+// SPI_fill16(d,len)        Transmit 16-bit word (d) (len) times (MSB first) via DMA
+// SPI_wait()               Wait until DMA transfer and SPI transmission are finished
+//
+// SPI_busy()               Check if SPI bus or DMA is busy
+// SPI_ready()              Check if SPI is ready to write
+// SPI_DMA_busy()           Check if DMA transfer is still in progress
+// SPI_enable()             Enable SPI module
+// SPI_disable()            Disable SPI module
+// SPI_setBAUD(n)           Set BAUD rate (see below)
+// SPI_setCPOL(n)           0: SCK low in idle, 1: SCK high in idle
+// SPI_setCPHA(n)           Start sampling from 0: first clock edge, 1: second clock edge
+//
+// SPI pin mapping:
+// ----------------
+// SCK-pin   PC5
+// MOSI-pin  PC6
+//
+// Notes:
+// ------
+// - DMA1 channel 3 is used for SPI1 TX. The DMA functions return as soon as the
+//   (last part of the) transfer has been started. The source buffer must not be
+//   changed until SPI_DMA_busy() returns false. Data from flash can be used directly.
+// - Transfers longer than 65535 units are split automatically (blocking between
+//   the parts).
+// - No interrupts are used, the interrupt vector table is not needed.
+// - Slave select pins (NSS) must be defined and controlled by the application.
+// - SPI clock rate must be defined below.
+//
+// 2023 by Stefan Wagner:   https://github.com/wagiminator
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "system.h"
+
+// SPI Parameters
+#define SPI_PRESC           1     // SPI_CLKRATE = F_CPU / (2 << SPI_PRESC + 1)
+
+// SPI Functions and Macros
+#define SPI_DMA_busy()      (DMA1_Channel3->CNTR)
+#define SPI_busy()          (SPI_DMA_busy() || (SPI1->STATR & SPI_STATR_BSY) || !SPI_ready())
+#define SPI_ready()         (SPI1->STATR & SPI_STATR_TXE)
+
+#define SPI_enable()        SPI1->CTLR1 |=  SPI_CTLR1_SPE
+#define SPI_disable()       SPI1->CTLR1 &= ~SPI_CTLR1_SPE
+#define SPI_setCPOL(n)      (n)?(SPI1->CTLR1|=SPI_CTLR1_CPOL):(SPI1->CTLR1&=~SPI_CTLR1_CPOL)
+#define SPI_setCPHA(n)      (n)?(SPI1->CTLR1|=SPI_CTLR1_CPHA):(SPI1->CTLR1&=~SPI_CTLR1_CPHA)
+#define SPI_setBAUD(n)      SPI1->CTLR1 = (SPI1->CTLR1&~SPI_CTLR1_BR) | (((n)&7)<<3)
+
+void SPI_init(void);
+void SPI_write(uint8_t data);
+void SPI_wait(void);
+void SPI_writeBuffer(const uint8_t* buf, uint32_t len);
+void SPI_writeBuffer16(const uint16_t* buf, uint32_t len);
+void SPI_fill(uint8_t data, uint32_t len);
+void SPI_fill16(uint16_t data, uint32_t len);
+
+#ifdef __cplusplus
+};
+#endif
@@ -1,9 +1,9 @@
 // ===================================================================================
-// ST7302 250x122 Pixels Monochrome Low-Power LCD Graphics Functions          * v1.1 *
+// ST7302 250x122 Pixels Monochrome Low-Power LCD Graphics Functions          * v1.2 *
 // ===================================================================================
 // 2024 by Stefan Wagner:   https://github.com/wagiminator
 
-#include "st7302_gfx_soft.h"
+#include "st7302_gfx.h"
 
 // ===================================================================================
 // Standard ASCII 5x8 Font (chars 32 - 127)
@@ -112,42 +112,24 @@ const uint8_t LCD_FONT_SEG[] = {
 // ===================================================================================
 // SPI Functions
 // ===================================================================================
-#define LCD_sendData      LCD_SPI_write
-#define LCD_readData      LCD_SPI_read
-#define LCD_sendCommand   LCD_SPI_command
-#define LCD_sendCommand2  LCD_SPI_command2
 
-// SPI init function (setup pins)
-void LCD_SPI_init(void) {
-  PIN_high(LCD_PIN_CS);                           // setup control pins
-  PIN_high(LCD_PIN_DC);
-  PIN_high(LCD_PIN_SCL);
-  PIN_output(LCD_PIN_CS);
-  PIN_output(LCD_PIN_DC);
-  PIN_output(LCD_PIN_SCL);
-  PIN_output(LCD_PIN_SDA);
-}
-
-// Transmit one data byte
-void LCD_SPI_write(uint8_t data) {
-  for(uint8_t i=8; i; i--, data <<= 1) {          // shift out 8 bits, MSB first
-    PIN_low(LCD_PIN_SCL);                         // SCL low -> prepare next bit
-    if(data & 0x80) PIN_high(LCD_PIN_SDA);        // set SDA according to data bit
-    else            PIN_low(LCD_PIN_SDA);
-    PIN_high(LCD_PIN_SCL);                        // SCL high -> shift bit out
-  }
+// Send a command to the display
+void LCD_sendCommand(uint8_t cmd) {
+  SPI_wait();                                     // wait for pending data to be sent
+  PIN_low(LCD_PIN_DC);                            // DC low -> command
+  SPI_write(cmd);
+  SPI_wait();
+  PIN_high(LCD_PIN_DC);                           // DC high -> data
 }
 
-// Send a command to the display
-void LCD_SPI_command(uint8_t cmd) {
-  PIN_low(LCD_PIN_DC);
-  LCD_SPI_write(cmd);
-  PIN_high(LCD_PIN_DC);
+// Send data byte to the display
+void LCD_sendData(uint8_t data) {
+  SPI_write(data);
 }
 
 // Send a command followed by two data bytes
-void LCD_SPI_command2(uint8_t c, uint8_t d1, uint8_t d2) {
-  LCD_SPI_command(c); LCD_sendData(d1); LCD_sendData(d2);
+void LCD_sendCommand2(uint8_t c, uint8_t d1, uint8_t d2) {
+  LCD_sendCommand(c); LCD_sendData(d1); LCD_sendData(d2);
 }
 
 // ===================================================================================
@@ -156,7 +138,15 @@ void LCD_SPI_command2(uint8_t c, uint8_t d1, uint8_t d2) {
 
 // Init LCD
 void LCD_init(void) {
-  LCD_SPI_init();                                 // initialize SPI first
+  PIN_high(LCD_PIN_CS);                           // setup control pins
+  PIN_high(LCD_PIN_DC);
+  PIN_output(LCD_PIN_CS);
+  PIN_output(LCD_PIN_DC);
+  SPI_init();                                     // setup SPI with DMA
+  SPI_disable();                                  // set SPI mode 3 (SCK high in idle)
+  SPI_setCPOL(1);
+  SPI_setCPHA(1);
+  SPI_enable();
   #if LCD_BOOT_TIME > 0
     DLY_ms(LCD_BOOT_TIME);                        // time for the LCD to boot up
   #endif
@@ -201,6 +191,7 @@ void LCD_init(void) {
   #if LCD_CS_CONTROL > 0
   PIN_high(LCD_PIN_CS);
   #endif
+  LCD_firstBand();                                // start with first band, cleared
 }
 
 // Invert display
@@ -210,6 +201,7 @@ void LCD_invert(uint8_t yes) {
   #endif
   LCD_sendCommand(LCD_INVOFF + yes);
   #if LCD_CS_CONTROL > 0
+  SPI_wait();
   PIN_high(LCD_PIN_CS);
   #endif
 }
@@ -226,75 +218,94 @@ void LCD_sleep(uint8_t yes) {
   #endif
 }
 
-// Plot a 12x2 block at row, col
-void LCD_writeBlock(uint8_t row, uint8_t column, uint32_t block) {
+// ===================================================================================
+// Shadow Framebuffer (band of display RAM rows)
+// ===================================================================================
+
+// Each display RAM row holds two pixel columns (x) in blocks of 12x2 pixels (3 bytes),
+// one block per display RAM column (12 pixel lines (y))
+uint8_t __attribute__ ((aligned(4))) LCD_buffer[(LCD_BAND_ROWS * LCD_COLUMNS * 3 + 3) & ~3];
+uint8_t LCD_band;                                 // first display RAM row of current band
+uint8_t LCD_dirtyR0, LCD_dirtyR1;                 // dirty display RAM rows (absolute)
+uint8_t LCD_dirtyC0, LCD_dirtyC1;                 // dirty display RAM columns
+
+// Mark band as clean
+static inline void LCD_markClean(void) {
+  LCD_dirtyR0 = 255; LCD_dirtyR1 = 0;
+  LCD_dirtyC0 = 255; LCD_dirtyC1 = 0;
+}
+
+// Mark block at row, column as dirty
+static inline void LCD_markDirty(uint8_t row, uint8_t column) {
+  if(row    < LCD_dirtyR0) LCD_dirtyR0 = row;
+  if(row    > LCD_dirtyR1) LCD_dirtyR1 = row;
+  if(column < LCD_dirtyC0) LCD_dirtyC0 = column;
+  if(column > LCD_dirtyC1) LCD_dirtyC1 = column;
+}
+
+// Clear buffer of current band and mark it completely dirty
+void LCD_clear(void) {
+  uint32_t* ptr = (uint32_t*)LCD_buffer;
+  for(uint16_t i=sizeof(LCD_buffer) >> 2; i; i--) *ptr++ = 0;
+  LCD_dirtyR0 = LCD_band;
+  LCD_dirtyR1 = LCD_band + LCD_BAND_ROWS - 1;
+  if(LCD_dirtyR1 >= LCD_ROWS) LCD_dirtyR1 = LCD_ROWS - 1;
+  LCD_dirtyC0 = 0;
+  LCD_dirtyC1 = LCD_COLUMNS - 1;
+}
+
+// Send dirty blocks of current band to the display (one row window at a time)
+void LCD_flush(void) {
+  if(LCD_dirtyR0 > LCD_dirtyR1) return;           // nothing changed
   #if LCD_CS_CONTROL > 0
   PIN_low(LCD_PIN_CS);
   #endif
-  LCD_sendCommand2(LCD_CASET, LCD_YOFF + column, LCD_YOFF + column);
-  LCD_sendCommand2(LCD_RASET, LCD_XOFF + row, LCD_XOFF + row);
-  LCD_sendCommand(LCD_RAMWR);
-  LCD_sendData(block >> 16); LCD_sendData(block >> 8); LCD_sendData(block);
+  uint8_t  len = (LCD_dirtyC1 - LCD_dirtyC0 + 1) * 3;
+  uint8_t* ptr = LCD_buffer + ((LCD_dirtyR0 - LCD_band) * LCD_COLUMNS + LCD_dirtyC0) * 3;
+  for(uint8_t row=LCD_dirtyR0; row<=LCD_dirtyR1; row++, ptr+=LCD_COLUMNS*3) {
+    LCD_sendCommand2(LCD_CASET, LCD_YOFF + LCD_dirtyC0, LCD_YOFF + LCD_dirtyC1);
+    LCD_sendCommand2(LCD_RASET, LCD_XOFF + row, LCD_XOFF + row);
+    LCD_sendCommand(LCD_RAMWR);
+    SPI_writeBuffer(ptr, len);                    // send blocks of this row via DMA
+  }
+  SPI_wait();                                     // buffer may be changed afterwards
   #if LCD_CS_CONTROL > 0
   PIN_high(LCD_PIN_CS);
   #endif
+  LCD_markClean();                                // band is clean now
 }
 
-// Read a 12x2 block at row, col
-uint32_t LCD_readBlock(uint8_t row, uint8_t column) {
-  #if LCD_CS_CONTROL > 0
-  PIN_low(LCD_PIN_CS);
-  #endif
-  LCD_sendCommand2(LCD_CASET, LCD_YOFF + column, LCD_YOFF + column);
-  LCD_sendCommand2(LCD_RASET, LCD_XOFF + row, LCD_XOFF + row);
-  LCD_sendCommand(LCD_RAMRD);
-  uint32_t block = 0;
-  PIN_input_PU(LCD_PIN_SDA);                      // data in
-  for(uint8_t i=25; i; i--) {                     // shift in dummy bit + 24 bits, MSB first
-    PIN_low(LCD_PIN_SCL);                         // SCL low -> shift bit in
-    block <<= 1;                                  // shift data byte
-    PIN_high(LCD_PIN_SCL);                        // SCL high -> prepare next bit
-    if(PIN_read(LCD_PIN_SDA)) block |= 1;         // set data bit according to SDA
+// Select first band and clear it
+void LCD_firstBand(void) {
+  LCD_band = 0;
+  LCD_clear();
+}
+
+// Flush current band, select and clear next band, returns 0 if all bands are done
+uint8_t LCD_nextBand(void) {
+  LCD_flush();
+  #if LCD_BAND_ROWS < LCD_ROWS
+  LCD_band += LCD_BAND_ROWS;
+  if(LCD_band < LCD_ROWS) {
+    LCD_clear();
+    return 1;
   }
-  PIN_output(LCD_PIN_SDA);                        // back to data out
-  PIN_high(LCD_PIN_CS);
-  #if LCD_CS_CONTROL == 0
-  PIN_low(LCD_PIN_CS);
+  LCD_band = 0;                                   // back to first band: the buffer
+  LCD_clear();                                    // doesn't hold its content, so
+  LCD_markClean();                                // nothing is sent until drawn
   #endif
-  return block;
+  return 0;
 }
 
 // ===================================================================================
 // LCD Graphics Functions
 // ===================================================================================
 
-// Global Variables
-uint8_t row0 = 255 >> 1, column0 = 0;
-uint32_t block;
-
-// Clear screen
-void LCD_clear(void) {
-  #if LCD_CS_CONTROL > 0
-  PIN_low(LCD_PIN_CS);
-  #endif
-  LCD_sendCommand2(LCD_CASET, LCD_YOFF, LCD_YOFF + ((LCD_HEIGHT - 1) / 12));  // Column Address Set
-  LCD_sendCommand2(LCD_RASET, LCD_XOFF, LCD_XOFF + ((LCD_WIDTH - 1) >> 1));   // Row Address Set
-  LCD_sendCommand(LCD_RAMWR);                     // Write to RAM
-  PIN_low(LCD_PIN_SDA);
-  for(uint16_t i=LCD_WIDTH*((LCD_HEIGHT + 11) / 12 * 12); i; i--) {
-    PIN_low(LCD_PIN_SCL);
-    PIN_high(LCD_PIN_SCL);
-  }
-  #if LCD_CS_CONTROL > 0
-  PIN_high(LCD_PIN_CS);
-  #endif
-  row0 = 255 >> 1; column0 = 0;
-}
-
-// Set pixel at position (x,y) with color (0: clear pixel, 1: set pixel, 2: invert pixel)
-void LCD_setPixel(int16_t x, int16_t y, uint8_t color) {
+// Get pointer to block byte and bit mask of pixel at (x,y), returns 0 if not in band,
+// marks block as dirty if (mark) is set
+static uint8_t* LCD_locate(int16_t x, int16_t y, uint8_t* mask, uint8_t mark) {
   #if LCD_PORTRAIT == 0
-    if((x < 0) || (x >= LCD_WIDTH) || (y < 0) || (y >= LCD_HEIGHT)) return;
+    if((x < 0) || (x >= LCD_WIDTH) || (y < 0) || (y >= LCD_HEIGHT)) return 0;
     #if LCD_FLIP > 0
       x = (int16_t)(LCD_WIDTH  - 1) - x;
       y = (int16_t)(LCD_HEIGHT - 1) - y;
@@ -302,7 +313,7 @@ void LCD_setPixel(int16_t x, int16_t y, uint8_t color) {
     uint8_t row = x >> 1, column = y / 12;
     uint8_t bit = ((~x) & 1) | (11 - y % 12) << 1;
   #else
-    if((x < 0) || (x >= LCD_HEIGHT) || (y < 0) || (y >= LCD_WIDTH)) return;
+    if((x < 0) || (x >= LCD_HEIGHT) || (y < 0) || (y >= LCD_WIDTH)) return 0;
     #if LCD_FLIP > 0
       y = (int16_t)(LCD_WIDTH - 1) - y;
     #else
@@ -311,47 +322,29 @@ void LCD_setPixel(int16_t x, int16_t y, uint8_t color) {
     uint8_t row = y >> 1, column = x / 12;
     uint8_t bit = ((~y) & 1) | (11 - x % 12) << 1;
   #endif
+  if((uint8_t)(row - LCD_band) >= LCD_BAND_ROWS) return 0;  // not in current band
+  if(mark) LCD_markDirty(row, column);
+  *mask = 1 << (bit & 7);                         // block is sent MSB first
+  return LCD_buffer + ((row - LCD_band) * LCD_COLUMNS + column) * 3 + 2 - (bit >> 3);
+}
 
-  if(row != row0 || column != column0) {
-    LCD_writeBlock(row0, column0, block);
-    block = LCD_readBlock(row, column);
-    row0 = row; column0 = column;
-  }
-
+// Set pixel at position (x,y) with color (0: clear pixel, 1: set pixel, 2: invert pixel)
+void LCD_setPixel(int16_t x, int16_t y, uint8_t color) {
+  uint8_t  mask;
+  uint8_t* ptr = LCD_locate(x, y, &mask, 1);
+  if(!ptr) return;
   switch(color) {
-    case 0: block &= ~((uint32_t)1 << bit); break;
-    case 1: block |=  ((uint32_t)1 << bit); break;
-    case 2: block ^=  ((uint32_t)1 << bit); break;
+    case 0: *ptr &= ~mask; break;
+    case 1: *ptr |=  mask; break;
+    case 2: *ptr ^=  mask; break;
   }
 }
 
-// Flush screen buffer
-void LCD_flush(void) {
-  LCD_writeBlock(row0, column0, block);
-  row0 = 255 >> 1; column0 = 0;
-}
-
 // Get pixel color at (x,y) (0: pixel cleared, 1: pixel set)
 uint8_t LCD_getPixel(int16_t x, int16_t y) {
-  #if LCD_PORTRAIT == 0
-    if((x < 0) || (x >= LCD_WIDTH) || (y < 0) || (y >= LCD_HEIGHT)) return 0;
-    #if LCD_FLIP > 0
-      x = (int16_t)(LCD_WIDTH  - 1) - x;
-      y = (int16_t)(LCD_HEIGHT - 1) - y;
-    #endif
-    uint8_t  row = x >> 1, column = y / 12;
-    uint32_t bit = ((~x) & 1) | (11 - y % 12) << 1;
-  #else
-    if((x < 0) || (x >= LCD_HEIGHT) || (y < 0) || (y >= LCD_WIDTH)) return 0;
-    #if LCD_FLIP > 0
-      y = (int16_t)(LCD_WIDTH - 1) - y;
-    #else
-      x = (int16_t)(LCD_HEIGHT - 1) - x;
-    #endif
-    uint8_t row = y >> 1, column = x / 12;
-    uint8_t bit = ((~y) & 1) | (11 - x % 12) << 1;
-  #endif
-  return((LCD_readBlock(row, column) >> bit) & 1);
+  uint8_t  mask;
+  uint8_t* ptr = LCD_locate(x, y, &mask, 0);
+  return (ptr && (*ptr & mask));
 }
 
 // Draw vertical line starting from (x,y), height (h), color (0: cleared, 1: set)
@@ -42,6 +42,7 @@
 // Libraries, Definitions and Macros
 // ===================================================================================
 #include <st7735_gfx.h>                         // TFT graphics functions
+#include <st7735_dl.h>                          // TFT display list renderer
 
 // ===================================================================================
 // Pseudo Random Number Generator
@@ -82,6 +83,32 @@ int main(void) {
 
   // Loop
   while(1) {
+    uint32_t ticks = STK->CNT;                  // measure full screen fill time
+    TFT_fill(TFT_RED); TFT_fill(TFT_GREEN); TFT_fill(TFT_BLUE); TFT_fill(TFT_BLACK);
+    while(SPI_busy());
+    ticks = (STK->CNT - ticks) / (4 * DLY_MS_TIME);
+    TFT_cursor(0, 0); TFT_textcolor(TFT_WHITE); TFT_textsize(2); TFT_print("Fill time [ms]:");
+    TFT_cursor(0, 20); TFT_printSegment(ticks, 3, 1, 0);
+    DLY_ms(3000);
+
+    // Display list demo: moving objects in front of and behind others without flicker
+    DL_clear(TFT_BLUE);
+    DL_fillRect(20, 20, 80, 60, TFT_YELLOW);
+    uint8_t ball = DL_fillCircle(0, 0, 20, TFT_RED);
+    DL_drawRect(140, 30, 80, 80, TFT_WHITE);
+    DL_print(4, 4, "Display List", 2, TFT_WHITE);
+    uint8_t ufo  = DL_drawSprite(0, 90, 32, 16, UFO, TFT_MAGENTA);
+    uint8_t line = DL_drawLine(0, TFT_HEIGHT - 1, 0, 0, TFT_GREEN);
+    int16_t bx = 30, by = 40, dx = 3, dy = 2;
+    for(i=0; i<300; i++) {
+      bx += dx; if((bx < 20) || (bx > TFT_WIDTH  - 21)) dx = -dx;
+      by += dy; if((by < 20) || (by > TFT_HEIGHT - 21)) dy = -dy;
+      DL_move(ball, bx, by);
+      DL_move(ufo, i % TFT_WIDTH, 90);
+      DL_move(line, (i >> 1) % TFT_WIDTH, TFT_HEIGHT - 1);
+      DL_render();
+    }
+
     TFT_clear();
     TFT_drawRect(0, 0, TFT_WIDTH, TFT_HEIGHT, TFT_YELLOW);
     TFT_drawVLine(TFT_WIDTH/2, 0, TFT_HEIGHT, TFT_YELLOW);
@@ -0,0 +1,104 @@
+// ===================================================================================
+// Basic SPI Master Functions (TX only) with DMA for CH32V003                 * v1.0 *
+// ===================================================================================
+// 2023 by Stefan Wagner:   https://github.com/wagiminator
+
+#include "spi_dma.h"
+
+// DMA channel configurations
+#define SPI_DMA_CFG8    (DMA_CFGR1_DIR | DMA_CFGR1_PL)
+#define SPI_DMA_CFG16   (DMA_CFGR1_DIR | DMA_CFGR1_PL | DMA_CFGR1_MSIZE_0 | DMA_CFGR1_PSIZE_0)
+
+// Source of DMA fill functions (must stay valid during transfer)
+volatile uint16_t SPI_fillword;
+
+// Init SPI
+void SPI_init(void) {
+  // Enable GPIO, SPI and DMA module clock
+  RCC->APB2PCENR |= RCC_AFIOEN | RCC_IOPCEN | RCC_SPI1EN;
+  RCC->AHBPCENR  |= RCC_DMA1EN;
+
+  // Setup GPIO pins PC5 (SCK) and PC6 (MOSI)
+  GPIOC->CFGLR  = (GPIOC->CFGLR & ~(((uint32_t)0b1111<<(5<<2)) | ((uint32_t)0b1111<<(6<<2)) ))
+                                |  (((uint32_t)0b1001<<(5<<2)) | ((uint32_t)0b1001<<(6<<2)) );
+
+  // Setup and enable SPI master, standard configuration
+  SPI1->CTLR1 = (SPI_PRESC << 3)      // set prescaler
+              | SPI_CTLR1_MSTR        // master configuration
+              | SPI_CTLR1_BIDIMODE    // one-line mode
+              | SPI_CTLR1_BIDIOE      // transmit only
+              | SPI_CTLR1_SSM         // software control of NSS
+              | SPI_CTLR1_SSI         // set internal NSS high
+              | SPI_CTLR1_SPE;        // enable SPI
+  SPI1->CTLR2 = SPI_CTLR2_TXDMAEN;    // enable TX DMA request
+
+  // Setup DMA channel 3 (SPI1 TX)
+  DMA1_Channel3->PADDR = (uint32_t)&SPI1->DATAR;
+  DMA1_Channel3->CFGR  = 0;           // channel disabled until first transfer
+  DMA1_Channel3->CNTR  = 0;
+}
+
+// Wait until DMA transfer and SPI transmission are finished
+void SPI_wait(void) {
+  while(SPI_busy());
+}
+
+// Set data frame format (0: 8-bit, 1: 16-bit), SPI must be idle to change it
+static void SPI_setFrame(uint8_t wide) {
+  if(!(SPI1->CTLR1 & SPI_CTLR1_DFF) == !wide) return;
+  SPI_wait();
+  SPI_disable();
+  SPI1->CTLR1 ^= SPI_CTLR1_DFF;
+  SPI_enable();
+}
+
+// Start DMA transfer, split into parts with a maximum of 65535 units
+static void SPI_DMA_start(const void* src, uint32_t len, uint16_t cfg) {
+  uint32_t addr = (uint32_t)src;
+  while(len) {
+    uint16_t cnt = (len > 0xFFFF) ? 0xFFFF : len;
+    while(SPI_DMA_busy());            // wait for previous part to be finished
+    DMA1_Channel3->CFGR  = 0;         // disable channel to allow reconfiguration
+    DMA1_Channel3->CNTR  = cnt;       // number of units to transfer
+    DMA1_Channel3->MADDR = addr;      // source address
+    DMA1_Channel3->CFGR  = cfg | DMA_CFGR1_EN;  // start transfer
+    len -= cnt;
+    if(cfg & DMA_CFGR1_MINC) addr += (cfg & DMA_CFGR1_MSIZE_0) ? (cnt << 1) : cnt;
+  }
+}
+
+// Transmit one data byte
+void SPI_write(uint8_t data) {
+  while(SPI_DMA_busy());              // wait for DMA transfer to be finished
+  SPI_setFrame(0);                    // make sure 8-bit frame format is set
+  while(!SPI_ready());                // wait for ready to write
+  SPI1->DATAR = data;                 // send data byte
+}
+
+// Transmit buffer via DMA
+void SPI_writeBuffer(const uint8_t* buf, uint32_t len) {
+  SPI_setFrame(0);
+  SPI_DMA_start(buf, len, SPI_DMA_CFG8 | DMA_CFGR1_MINC);
+}
+
+// Transmit buffer of 16-bit words (MSB first) via DMA
+void SPI_writeBuffer16(const uint16_t* buf, uint32_t len) {
+  SPI_setFrame(1);
+  SPI_DMA_start(buf, len, SPI_DMA_CFG16 | DMA_CFGR1_MINC);
+}
+
+// Transmit data byte (len) times via DMA (non-incrementing source)
+void SPI_fill(uint8_t data, uint32_t len) {
+  SPI_setFrame(0);
+  while(SPI_DMA_busy());              // source is still in use by previous fill
+  SPI_fillword = data;
+  SPI_DMA_start((const void*)&SPI_fillword, len, SPI_DMA_CFG8);
+}
+
+// Transmit 16-bit word (len) times (MSB first) via DMA (non-incrementing source)
+void SPI_fill16(uint16_t data, uint32_t len) {
+  SPI_setFrame(1);
+  while(SPI_DMA_busy());              // source is still in use by previous fill
+  SPI_fillword = data;
+  SPI_DMA_start((const void*)&SPI_fillword, len, SPI_DMA_CFG16);
+}
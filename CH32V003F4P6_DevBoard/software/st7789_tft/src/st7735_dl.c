@@ -0,0 +1,351 @@
+// ===================================================================================
+// Display List Renderer for ST7735/ST7789/ILI934x Color TFT                  * v1.1 *
+// ===================================================================================
+// 2024 by Stefan Wagner:   https://github.com/wagiminator
+
+#include "st7735_dl.h"
+
+// Resources of the graphics library
+extern const uint8_t TFT_FONT[];                  // 5x8 font
+extern uint8_t TFT_line[2][TFT_LINEBUF * 2];      // double line buffer
+extern uint8_t TFT_flip;                          // buffer not used by last transfer
+
+// Display list entry
+typedef struct {
+  uint8_t  type;                                  // primitive type
+  uint8_t  size;                                  // text size
+  uint16_t color;                                 // color (RGB565)
+  int16_t  x, y;                                  // position, center or start point
+  int16_t  a, b;                                  // width/height, radius or end point
+  int16_t  left, right, top, bottom;              // bounding box
+  union {
+    const void* ptr;                              // string or sprite
+    struct { int16_t px, py; };                   // line walker position
+  };
+  int16_t  err;                                   // line walker error term
+} DL_CMD;
+
+// Variables
+DL_CMD   DL_list[DL_SIZE];                        // display list
+uint8_t  DL_count;                                // number of entries in list
+uint16_t DL_bg;                                   // background color
+uint16_t* DL_buf;                                 // current column buffer
+int16_t  DL_top, DL_bottom;                       // current band
+
+// ===================================================================================
+// Display List Functions
+// ===================================================================================
+
+// Convert color to RGB565 (display list is always rendered in 16-bit color mode)
+static uint16_t DL_rgb(uint16_t color) {
+  #if TFT_COLORBITS == 12
+  uint16_t r = color >> 12, g = (color >> 8) & 0x0f, b = (color >> 4) & 0x0f;
+  return (r << 12) | ((r & 0x08) << 8) | (g << 7) | (g << 3 & 0x60) | (b << 1) | (b >> 3);
+  #else
+  return color;
+  #endif
+}
+
+// Add entry to display list
+static uint8_t DL_add(uint8_t type, int16_t x, int16_t y, int16_t a, int16_t b, uint16_t color) {
+  if(DL_count >= DL_SIZE) return DL_FULL;
+  DL_CMD* c = &DL_list[DL_count];
+  c->type  = type;
+  c->color = DL_rgb(color);
+  c->x = x; c->y = y; c->a = a; c->b = b;
+  return DL_count++;
+}
+
+// Clear display list and set background color
+void DL_clear(uint16_t color) {
+  DL_count = 0;
+  DL_bg = DL_rgb(color);
+}
+
+// Add filled rectangle
+uint8_t DL_fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+  if((w < 1) || (h < 1)) return DL_INVALID;
+  uint8_t id = DL_add(DL_FILLRECT, x, y, w, h, color);
+  if(id != DL_FULL) {
+    DL_CMD* c = &DL_list[id];
+    c->left = x; c->right  = x + w - 1;
+    c->top  = y; c->bottom = y + h - 1;
+  }
+  return id;
+}
+
+// Add rectangle outline
+uint8_t DL_drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+  uint8_t id = DL_fillRect(x, y, w, h, color);
+  if(id < DL_SIZE) DL_list[id].type = DL_RECT;
+  return id;
+}
+
+// Add filled circle
+uint8_t DL_fillCircle(int16_t x, int16_t y, int16_t r, uint16_t color) {
+  if(r < 0) return DL_INVALID;
+  uint8_t id = DL_add(DL_FILLCIRCLE, x, y, r, 0, color);
+  if(id != DL_FULL) {
+    DL_CMD* c = &DL_list[id];
+    c->left = x - r; c->right  = x + r;
+    c->top  = y - r; c->bottom = y + r;
+  }
+  return id;
+}
+
+// Add circle outline
+uint8_t DL_drawCircle(int16_t x, int16_t y, int16_t r, uint16_t color) {
+  uint8_t id = DL_fillCircle(x, y, r, color);
+  if(id < DL_SIZE) DL_list[id].type = DL_CIRCLE;
+  return id;
+}
+
+// Add line (start point is always the left one)
+uint8_t DL_drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color) {
+  if(x0 > x1) {
+    int16_t t;
+    t = x0; x0 = x1; x1 = t;
+    t = y0; y0 = y1; y1 = t;
+  }
+  uint8_t id = DL_add(DL_LINE, x0, y0, x1, y1, color);
+  if(id != DL_FULL) {
+    DL_CMD* c = &DL_list[id];
+    c->left = x0; c->right  = x1;
+    if(y0 < y1) { c->top = y0; c->bottom = y1; }
+    else        { c->top = y1; c->bottom = y0; }
+  }
+  return id;
+}
+
+// Add string (transparent background)
+uint8_t DL_print(int16_t x, int16_t y, const char* str, uint8_t size, uint16_t color) {
+  uint16_t len = 0;
+  while(str[len]) len++;
+  if(!len || !size || (size > 8)) return DL_INVALID;
+  uint8_t id = DL_add(DL_TEXT, x, y, 0, 0, color);
+  if(id != DL_FULL) {
+    DL_CMD* c = &DL_list[id];
+    c->size = size;
+    c->ptr  = str;
+    c->left = x; c->right  = x + len * 6 * size - 1;
+    c->top  = y; c->bottom = y + (size << 3) - 1;
+  }
+  return id;
+}
+
+// Add sprite (monochrome bitmap with transparent background)
+uint8_t DL_drawSprite(int16_t x, int16_t y, int16_t w, int16_t h, const uint8_t* bmp, uint16_t color) {
+  if((w < 1) || (h < 1)) return DL_INVALID;
+  uint8_t id = DL_add(DL_SPRITE, x, y, w, h, color);
+  if(id != DL_FULL) {
+    DL_CMD* c = &DL_list[id];
+    c->ptr  = bmp;
+    c->left = x; c->right  = x + w - 1;
+    c->top  = y; c->bottom = y + h - 1;
+  }
+  return id;
+}
+
+// Move primitive to position (x,y)
+void DL_move(uint8_t id, int16_t x, int16_t y) {
+  if(id >= DL_count) return;
+  DL_CMD* c = &DL_list[id];
+  int16_t dx = x - c->x;
+  int16_t dy = y - c->y;
+  c->x += dx; c->left += dx; c->right  += dx;
+  c->y += dy; c->top  += dy; c->bottom += dy;
+  if(c->type == DL_LINE) {
+    c->a += dx; c->b += dy;
+  }
+}
+
+// Change color of primitive
+void DL_color(uint8_t id, uint16_t color) {
+  if(id < DL_count) DL_list[id].color = DL_rgb(color);
+}
+
+// Remove primitive from rendering
+void DL_remove(uint8_t id) {
+  if(id < DL_count) DL_list[id].type = DL_NONE;
+}
+
+// ===================================================================================
+// Rasterizer Functions
+// ===================================================================================
+
+// Integer square root
+static int16_t DL_sqrt(int32_t n) {
+  uint32_t root = 0;
+  uint32_t bit  = 1UL << 30;
+  while(bit > (uint32_t)n) bit >>= 2;
+  while(bit) {
+    if((uint32_t)n >= root + bit) {
+      n   -= root + bit;
+      root = (root >> 1) + bit;
+    }
+    else root >>= 1;
+    bit >>= 2;
+  }
+  return root;
+}
+
+// Fill span from row y0 to row y1 of current column (clipped to current band)
+static void DL_span(int16_t y0, int16_t y1, uint16_t color) {
+  if(y0 < DL_top)    y0 = DL_top;
+  if(y1 > DL_bottom) y1 = DL_bottom;
+  if(y0 > y1) return;
+  uint16_t* ptr = DL_buf + (y0 - DL_top);
+  for(y1 -= y0; y1 >= 0; y1--) *ptr++ = color;
+}
+
+// Rasterize column x of a circle (r^2-r < d^2 <= r^2+r for outline)
+static void DL_circleColumn(DL_CMD* c, int16_t x) {
+  int32_t r  = c->a;
+  int32_t dx = x - c->x;
+  int32_t q  = r * r - dx * dx;
+  int16_t h  = DL_sqrt(q + r);
+  if((c->type == DL_CIRCLE) && (q >= r)) {
+    int16_t i = DL_sqrt(q - r);
+    DL_span(c->y - h, c->y - i - 1, c->color);
+    DL_span(c->y + i + 1, c->y + h, c->color);
+    return;
+  }
+  DL_span(c->y - h, c->y + h, c->color);
+}
+
+// Rasterize column x of a line (Bresenham's line algorithm, walker moves left to right)
+static void DL_lineColumn(DL_CMD* c, int16_t x) {
+  int16_t dx = c->a - c->x;
+  int16_t dy = -TFT_abs(c->b - c->y);
+  int16_t sy = (c->y < c->b) ? 1 : -1;
+  int16_t y0 = 0x7FFF, y1 = -0x7FFF;
+  while(c->px <= x) {
+    if(c->px == x) {
+      if(c->py < y0) y0 = c->py;
+      if(c->py > y1) y1 = c->py;
+    }
+    if((c->px == c->a) && (c->py == c->b)) {
+      c->px++;                                    // end point reached
+      break;
+    }
+    int16_t e2 = c->err << 1;
+    if(e2 >= dy) { c->err += dy; c->px++; }
+    if(e2 <= dx) { c->err += dx; c->py += sy; }
+  }
+  if(y0 <= y1) DL_span(y0, y1, c->color);
+}
+
+// Rasterize column x of a string
+static void DL_textColumn(DL_CMD* c, int16_t x) {
+  uint8_t  size = c->size;
+  uint16_t dx   = x - c->x;
+  uint16_t cw   = (size << 2) + (size << 1);      // character width
+  uint16_t ci   = dx / cw;                        // character index
+  uint8_t  col  = (dx - ci * cw) / size;          // column within character
+  if(col >= 5) return;
+  uint8_t ch = ((const char*)c->ptr)[ci] & 0x7f;
+  if(ch < 32) return;
+  uint8_t line = TFT_FONT[(ch - 32) * 5 + col];
+  for(int16_t y=c->y; line; line>>=1, y+=size) {
+    if(line & 1) DL_span(y, y + size - 1, c->color);
+  }
+}
+
+// Rasterize column x of a sprite
+static void DL_spriteColumn(DL_CMD* c, int16_t x) {
+  const uint8_t* ptr = (const uint8_t*)c->ptr + (x - c->x);
+  int16_t y = c->y;
+  for(int16_t band=(c->b+7)>>3; band; band--, ptr+=c->a) {
+    uint8_t line = *ptr;
+    if((y > DL_bottom) || (y + 7 < DL_top)) {
+      y += 8;
+      continue;
+    }
+    for(uint8_t i=8; i; i--, y++, line>>=1) {
+      if(line & 1) DL_span(y, y, c->color);
+    }
+  }
+}
+
+// ===================================================================================
+// Render Functions
+// ===================================================================================
+
+// Render screen area
+void DL_renderArea(int16_t x, int16_t y, int16_t w, int16_t h) {
+  uint8_t active[DL_SIZE];
+  int16_t x1 = x + w;
+  int16_t y1 = y + h;
+  if(x < 0) x = 0;
+  if(y < 0) y = 0;
+  if(x1 > TFT_WIDTH)  x1 = TFT_WIDTH;
+  if(y1 > TFT_HEIGHT) y1 = TFT_HEIGHT;
+  if((x >= x1) || (y >= y1)) return;
+  w = x1 - x;
+
+  #if TFT_COLORBITS == 12
+    #if TFT_CS_CONTROL > 0
+      PIN_low(TFT_PIN_CS);
+    #endif
+    TFT_SPI_command(TFT_COLMOD); SPI_write(0x05); // switch to 16-bit color
+  #endif
+
+  for(DL_top=y; DL_top<y1; DL_top+=TFT_LINEBUF) {
+    // Collect primitives within the band
+    uint8_t n = 0;
+    h = y1 - DL_top;
+    if(h > TFT_LINEBUF) h = TFT_LINEBUF;
+    DL_bottom = DL_top + h - 1;
+    for(uint8_t i=0; i<DL_count; i++) {
+      DL_CMD* c = &DL_list[i];
+      if((c->type == DL_NONE) || (c->top > DL_bottom) || (c->bottom < DL_top)) continue;
+      if((c->left >= x1) || (c->right < x)) continue;
+      if(c->type == DL_LINE) {                    // reset line walker
+        c->px  = c->x;
+        c->py  = c->y;
+        c->err = (c->a - c->x) - TFT_abs(c->b - c->y);
+      }
+      active[n++] = i;
+    }
+
+    // Compose band column by column and stream it via DMA
+    TFT_streamStart(x, DL_top, w, h);
+    for(int16_t cx=x; cx<x1; cx++) {
+      DL_buf = (uint16_t*)TFT_line[TFT_flip];     // DMA may still read the other buffer
+      TFT_flip ^= 1;
+      for(uint8_t i=0; i<h; i++) DL_buf[i] = DL_bg;
+      for(uint8_t i=0; i<n; i++) {
+        DL_CMD* c = &DL_list[active[i]];
+        if((cx < c->left) || (cx > c->right)) continue;
+        switch(c->type) {
+          case DL_FILLRECT:   DL_span(c->top, c->bottom, c->color); break;
+          case DL_RECT:       if((cx == c->left) || (cx == c->right)) DL_span(c->top, c->bottom, c->color);
+                              else {
+                                DL_span(c->top, c->top, c->color);
+                                DL_span(c->bottom, c->bottom, c->color);
+                              }
+                              break;
+          case DL_FILLCIRCLE:
+          case DL_CIRCLE:     DL_circleColumn(c, cx); break;
+          case DL_LINE:       DL_lineColumn(c, cx); break;
+          case DL_TEXT:       DL_textColumn(c, cx); break;
+          case DL_SPRITE:     DL_spriteColumn(c, cx); break;
+          default:            break;
+        }
+      }
+      SPI_writeBuffer16(DL_buf, h);
+    }
+    TFT_streamStop();
+  }
+
+  #if TFT_COLORBITS == 12
+    #if TFT_CS_CONTROL > 0
+      PIN_low(TFT_PIN_CS);
+    #endif
+    TFT_SPI_command(TFT_COLMOD); SPI_write(0x03); // switch back to 12-bit color
+    #if TFT_CS_CONTROL > 0
+      SPI_wait();
+      PIN_high(TFT_PIN_CS);
+    #endif
+  #endif
+}
@@ -0,0 +1,88 @@
+// ===================================================================================
+// Display List Renderer for ST7735/ST7789/ILI934x Color TFT                  * v1.1 *
+// ===================================================================================
+//
+// Functions available:
+// --------------------
+// DL_clear(c)                    Clear display list and set background color (c)
+// DL_fillRect(x,y,w,h,c)         Add filled rectangle at (x,y), width (w), height (h), color (c)
+// DL_drawRect(x,y,w,h,c)         Add rectangle outline at (x,y), width (w), height (h), color (c)
+// DL_fillCircle(x,y,r,c)         Add filled circle, center at (x,y), radius (r), color (c)
+// DL_drawCircle(x,y,r,c)         Add circle outline, center at (x,y), radius (r), color (c)
+// DL_drawLine(x0,y0,x1,y1,c)     Add line from (x0,y0) to (x1,y1) with color (c)
+// DL_print(x,y,*s,sz,c)          Add string (*s) at (x,y), size (sz), color (c), transparent
+// DL_drawSprite(x,y,w,h,*p,c)    Add sprite at (x,y), width (w), hight (h), pointer (*p), color (c)
+//
+// DL_move(id,x,y)                Move primitive (id) to position (x,y)
+// DL_color(id,c)                 Change color of primitive (id) to (c)
+// DL_remove(id)                  Remove primitive (id) from rendering
+//
+// DL_render()                    Render whole screen
+// DL_renderArea(x,y,w,h)         Render screen area at (x,y), width (w), height (h)
+//
+// Notes:
+// ------
+// - Primitives are recorded in a display list instead of being drawn immediately.
+//   The add functions return the id of the primitive, which can be used to modify the
+//   primitive later (retained mode). They return DL_FULL if the list is full and
+//   DL_INVALID for invalid arguments (width or height below 1, negative radius, empty
+//   string, text size outside 1..8). DL_move(), DL_color() and DL_remove() ignore
+//   these values.
+// - DL_render() composes all primitives in list order (painter's algorithm) on top of
+//   the background color. The screen is divided into horizontal bands of TFT_LINEBUF
+//   rows, each band is sent within one RAM window. The band is composed column by
+//   column in the double line buffer of the graphics library, which is sent via DMA
+//   while the next column is composed. Each pixel is written only once per frame, so
+//   overlapping or moving objects don't flicker.
+// - Strings and sprites are referenced, not copied. They must remain valid until the
+//   display list is cleared. Strings are printed in one line using the 5x8 font of the
+//   graphics library (size 1..8).
+// - DMA of the graphics library must be enabled (TFT_DMA in st7735_gfx.h).
+//
+// 2024 by Stefan Wagner:   https://github.com/wagiminator
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "st7735_gfx.h"
+
+// Display List Parameters
+#define DL_SIZE           16        // max number of primitives in display list
+
+#if DL_SIZE > 254
+  #error DL_SIZE must not exceed 254!
+#endif
+
+#if TFT_DMA == 0
+  #error DMA must be enabled (TFT_DMA in st7735_gfx.h)!
+#endif
+
+// Primitive Types
+enum {DL_NONE, DL_FILLRECT, DL_RECT, DL_FILLCIRCLE, DL_CIRCLE, DL_LINE, DL_TEXT, DL_SPRITE};
+
+#define DL_FULL           0xFF      // returned if display list is full
+#define DL_INVALID        0xFE      // returned if arguments are invalid
+
+// Display List Functions
+void DL_clear(uint16_t color);
+uint8_t DL_fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+uint8_t DL_drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+uint8_t DL_fillCircle(int16_t x, int16_t y, int16_t r, uint16_t color);
+uint8_t DL_drawCircle(int16_t x, int16_t y, int16_t r, uint16_t color);
+uint8_t DL_drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color);
+uint8_t DL_print(int16_t x, int16_t y, const char* str, uint8_t size, uint16_t color);
+uint8_t DL_drawSprite(int16_t x, int16_t y, int16_t w, int16_t h, const uint8_t* bmp, uint16_t color);
+
+void DL_move(uint8_t id, int16_t x, int16_t y);
+void DL_color(uint8_t id, uint16_t color);
+void DL_remove(uint8_t id);
+
+void DL_renderArea(int16_t x, int16_t y, int16_t w, int16_t h);
+#define DL_render()       DL_renderArea(0, 0, TFT_WIDTH, TFT_HEIGHT)
+
+#ifdef __cplusplus
+};
+#endif
@@ -1,5 +1,5 @@
 // ===================================================================================
-// ST7735/ST7789/ILI9340/ILI9341 Color TFT Graphics Functions                 * v1.4 *
+// ST7735/ST7789/ILI9340/ILI9341 Color TFT Graphics Functions                 * v1.5 *
 // ===================================================================================
 // 2024 by Stefan Wagner:   https://github.com/wagiminator
 
@@ -144,6 +144,15 @@ void TFT_SPI_command2(uint8_t c, uint16_t d1, uint16_t d2) {
   TFT_sendData(d1>>8); TFT_sendData(d1); TFT_sendData(d2>>8); TFT_sendData(d2);
 }
 
+// Current column and row address window
+uint32_t TFT_window[2];
+
+// Line buffers for DMA transfers (double buffered)
+#if TFT_DMA > 0
+uint8_t TFT_line[2][TFT_LINEBUF * 2] __attribute__((aligned(4))); // line buffers
+uint8_t TFT_flip;                                 // buffer not used by last transfer
+#endif
+
 // Resync by toggling CS pin (for non-active control of CS-line mode)
 void TFT_resync(void) {
   #if TFT_CS_CONTROL > 0
@@ -166,6 +175,8 @@ void TFT_init(void) {
   PIN_low(TFT_PIN_CS);
   TFT_sendCommand(TFT_RESET);                     // software reset
   DLY_ms(TFT_RST_TIME);                           // delay
+  TFT_window[0] = 0xFFFFFFFF;                     // invalidate window cache
+  TFT_window[1] = 0xFFFFFFFF;
   TFT_sendCommand(TFT_MADCTL);
   TFT_sendData(TFT_XORDER<<7 | TFT_YORDER<<6 | TFT_ROTATE<<5 | TFT_BGR<<3); // set orientation and rgb/bgr
   TFT_sendCommand(TFT_COLMOD);
@@ -218,16 +229,25 @@ void TFT_invert(uint8_t yes) {
 }
 
 // Start sending data stream to RAM
+// (column and row address are only sent if they differ from the current window)
 void TFT_streamStart(int16_t x, int16_t y, int16_t w, int16_t h) {
   int16_t row1 = TFT_XOFF + x;
   int16_t row2 = row1 + w - 1;
   int16_t col1 = TFT_YOFF + y;
   int16_t col2 = col1 + h - 1;
+  uint32_t col = (uint32_t)col1 << 16 | (uint16_t)col2;
+  uint32_t row = (uint32_t)row1 << 16 | (uint16_t)row2;
   #if TFT_CS_CONTROL > 0
     PIN_low(TFT_PIN_CS);
   #endif
-  TFT_sendCommand2(TFT_CASET, col1, col2);        // column address set
-  TFT_sendCommand2(TFT_RASET, row1, row2);        // row address set
+  if(col != TFT_window[0]) {
+    TFT_sendCommand2(TFT_CASET, col1, col2);      // column address set
+    TFT_window[0] = col;
+  }
+  if(row != TFT_window[1]) {
+    TFT_sendCommand2(TFT_RASET, row1, row2);      // row address set
+    TFT_window[1] = row;
+  }
   TFT_sendCommand(TFT_RAMWR);                     // write to RAM
 }
 
@@ -239,6 +259,48 @@ void TFT_streamStop(void) {
   #endif
 }
 
+// Stream (count) pixels with the same color
+void TFT_streamFill(uint16_t color, uint32_t count) {
+  #if TFT_COLORBITS == 16
+    #if TFT_DMA > 0
+    if(count >= TFT_DMA_MIN) {
+      SPI_fill16(color, count);                   // non-incrementing DMA source
+      return;
+    }
+    #endif
+    for(; count; count--) {
+      TFT_sendData(color >> 8); TFT_sendData(color);
+    }
+  #else
+    uint8_t c1 = color >> 8, c2 = (color & 0xf0) | (color >> 12), c3 = color >> 4;
+    uint32_t len = ((count + 1) >> 1) * 3;
+    #if TFT_DMA > 0
+    if(count >= TFT_DMA_MIN) {
+      if((c1 == c2) && (c2 == c3)) {
+        SPI_fill(c1, len);                        // non-incrementing DMA source
+        return;
+      }
+      uint8_t* buf = TFT_line[TFT_flip];          // 3-byte pattern in line buffer
+      uint8_t* ptr = buf;
+      uint8_t  max = (TFT_LINEBUF * 2 / 3) * 3;
+      TFT_flip ^= 1;
+      for(uint8_t i=max/3; i; i--) {
+        *ptr++ = c1; *ptr++ = c2; *ptr++ = c3;
+      }
+      while(len) {
+        uint8_t part = (len > max) ? max : len;
+        SPI_writeBuffer(buf, part);
+        len -= part;
+      }
+      return;
+    }
+    #endif
+    for(len/=3; len; len--) {
+      TFT_sendData(c1); TFT_sendData(c2); TFT_sendData(c3);
+    }
+  #endif
+}
+
 // Stream a color
 void TFT_streamColor(uint16_t color) {
   #if TFT_COLORBITS == 16
@@ -272,7 +334,11 @@ void TFT_clear(void) {
   #endif
 
   TFT_streamStart(0, 0, TFT_WIDTH, TFT_HEIGHT);
-  for(uint32_t i=TFT_WIDTH*TFT_HEIGHT*12/8; i; i--) TFT_sendData(0);
+  #if TFT_DMA > 0
+    SPI_fill(0, (uint32_t)TFT_WIDTH * TFT_HEIGHT * 12 / 8);
+  #else
+    for(uint32_t i=TFT_WIDTH*TFT_HEIGHT*12/8; i; i--) TFT_sendData(0);
+  #endif
 
   #if TFT_COLORBITS == 16
     TFT_sendCommand(TFT_COLMOD); TFT_sendData(0x05);      // switch back to 16-bit color
@@ -302,16 +368,7 @@ void TFT_fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
   h = y1 - y;
 
   TFT_streamStart(x, y, w, h);
-  #if TFT_COLORBITS == 16
-    for(uint32_t i=w*h; i; i--) {
-      TFT_sendData(color >> 8); TFT_sendData(color);
-    }
-  #else
-    uint8_t c1 = color >> 8, c2 = (color & 0xf0) | (color >> 12), c3 = color >> 4;
-    for(uint32_t i=((w*h)+1)>>1; i; i--) {
-      TFT_sendData(c1); TFT_sendData(c2); TFT_sendData(c3);
-    }
-  #endif
+  TFT_streamFill(color, (uint32_t)w * h);
   TFT_streamStop();
 }
 
@@ -434,10 +491,14 @@ void TFT_drawBitmap(int16_t x0, int16_t y0, int16_t w, int16_t h, const uint16_t
   #endif
 
   TFT_streamStart(x0, y0, w, h);
-  for(uint32_t i=w*h; i; i--) {
-    uint16_t color = *bmp++;
-    TFT_sendData(color >> 8); TFT_sendData(color);
-  }
+  #if TFT_DMA > 0
+    SPI_writeBuffer16(bmp, (uint32_t)w * h);      // DMA directly from flash
+  #else
+    for(uint32_t i=w*h; i; i--) {
+      uint16_t color = *bmp++;
+      TFT_sendData(color >> 8); TFT_sendData(color);
+    }
+  #endif
 
   #if TFT_COLORBITS == 12
     TFT_sendCommand(TFT_COLMOD); TFT_sendData(0x03);    // switch back to 12-bit color
@@ -446,14 +507,23 @@ void TFT_drawBitmap(int16_t x0, int16_t y0, int16_t w, int16_t h, const uint16_t
 }
 
 // Draw sprite (monochrome bitmap with transparent background)
+// (vertical runs of set pixels are drawn as one line each)
 void TFT_drawSprite(int16_t x0, int16_t y0, int16_t w, int16_t h, const uint8_t* bmp, uint16_t color) {
-  for(int16_t y=y0; y<y0+h; y+=8) {
-    for(int16_t x=x0; x<x0+w; x++) {
-      uint8_t line = *bmp++;
-      for(int16_t i=y; i<y+8; i++, line>>=1) {
-        if(line & 1) TFT_setPixel(x, i, color);
+  for(int16_t x=x0; x<x0+w; x++, bmp++) {
+    const uint8_t* ptr = bmp;
+    int16_t run = 0;
+    int16_t y = y0;
+    for(int16_t band=(h+7)>>3; band; band--, ptr+=w) {
+      uint8_t line = *ptr;
+      for(uint8_t i=8; i; i--, y++, line>>=1) {
+        if(line & 1) run++;
+        else if(run) {
+          TFT_drawVLine(x, y - run, run, color);
+          run = 0;
+        }
       }
     }
+    if(run) TFT_drawVLine(x, y - run, run, color);
   }
 }
 
@@ -495,9 +565,47 @@ uint16_t TFT_stretch(uint16_t x) {
   return x | x<<1;
 }
 
+// Compose a column of (bytes) bitmap bytes with foreground and background color,
+// each pixel enlarged by (scale), in a line buffer and send it (repeat) times via DMA
+#if TFT_DMA > 0
+void TFT_lineSend(const uint8_t* bmp, uint8_t bytes, uint8_t scale, uint8_t repeat) {
+  uint8_t* buf = TFT_line[TFT_flip];              // DMA may still read the other buffer
+  uint8_t* ptr = buf;
+  #if TFT_COLORBITS == 12
+  uint8_t  odd = 0;
+  #endif
+  TFT_flip ^= 1;
+  for(; bytes; bytes--) {
+    uint8_t line = *bmp++;
+    for(uint8_t y=8; y; y--, line>>=1) {
+      uint16_t color = TFT_cb;
+      if(line & 1) color = TFT_cc;
+      for(uint8_t j=scale; j; j--) {
+        #if TFT_COLORBITS == 16
+        *ptr++ = color >> 8; *ptr++ = color;
+        #else
+        if(odd) { ptr[-1] |= color >> 12; *ptr++ = color >> 4; }
+        else    { *ptr++ = color >> 8; *ptr++ = color & 0xf0; }
+        odd = !odd;
+        #endif
+      }
+    }
+  }
+  for(; repeat; repeat--) SPI_writeBuffer(buf, ptr - buf);
+}
+#endif
+
 // Print a bitmap at cursor position with foreground and background color
 void TFT_printBitmap(uint16_t w, uint16_t h, const uint8_t* bmp) {
   TFT_streamStart(TFT_cx, TFT_cy, w, h);
+  #if TFT_DMA > 0
+  if(h <= TFT_LINEBUF) {
+    for(uint8_t x=w; x; x--, bmp+=h>>3) TFT_lineSend(bmp, h >> 3, 1, 1);
+    TFT_cx += w;
+    TFT_streamStop();
+    return;
+  }
+  #endif
   for(uint8_t x=w; x; x--) {
     for(uint8_t y=h>>3; y; y--) {
       uint8_t line = *bmp++;
@@ -526,6 +634,9 @@ void TFT_write(char c) {
       for(uint8_t x=6; x; x--) {
         uint8_t line = 0;
         if(x > 1) line = TFT_FONT[ptr++];
+        #if TFT_DMA > 0
+        TFT_lineSend(&line, 1, TFT_cs, TFT_cs);
+        #else
         for(uint8_t i=TFT_cs; i; i--) {
           uint8_t line2 = line;
           for(uint8_t y=8; y; y--, line2>>=1) {
@@ -534,6 +645,7 @@ void TFT_write(char c) {
             for(uint8_t j = TFT_cs; j; j--) TFT_streamColor(color);
           }
         }
+        #endif
       }
       TFT_cx += w;
       TFT_streamStop();
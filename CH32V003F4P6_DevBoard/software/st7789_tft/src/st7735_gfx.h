@@ -1,5 +1,5 @@
 // ===================================================================================
-// ST7735/ST7789/ILI9340/ILI9341 Color TFT Graphics Functions                 * v1.4 *
+// ST7735/ST7789/ILI9340/ILI9341 Color TFT Graphics Functions                 * v1.5 *
 // ===================================================================================
 //
 // Functions available:
@@ -10,6 +10,11 @@
 // TFT_invert(v)                  Invert display (0: inverse off, 1: inverse on)
 // TFT_resync()                   Resync by toggling CS pin (for non-active control of CS-line mode)
 //
+// TFT_streamStart(x,y,w,h)       Start data stream to RAM window at (x,y), width (w), height (h)
+// TFT_streamColor(c)             Stream one pixel with color (c)
+// TFT_streamFill(c,n)            Stream (n) pixels with color (c)
+// TFT_streamStop()               Stop data stream
+//
 // TFT_clear()                    Clear TFT screen
 // TFT_fill(c)                    Fill screen with color (c)
 // TFT_setPixel(x,y,c)            Set pixel color (c) at position (x,y)
@@ -76,6 +81,10 @@
 // ------
 // - Define TFT parameters down below!
 // - This library works without a screen buffer.
+// - If TFT_DMA is enabled (needs spi_dma.h), fills and bitmaps are transferred via DMA
+//   (fills from a non-incrementing source, bitmaps directly from flash), text and
+//   monochrome bitmaps are composed column by column in a small double line buffer,
+//   which is then sent via DMA while the next column is prepared.
 // - color: 16-bit color mode (5 bits red, 6 bits green, 5 bits blue) or
 //          12-bit color mode (4 bits red, 4 bits green, 4 bits blue)
 // - size:  1: normal 6x8 pixels, 2: double size (12x16), ... , 8: 8 times (48x64)
@@ -95,7 +104,7 @@ extern "C" {
 #endif
 
 #include "gpio.h"
-#include "spi_tx.h"                 // choose your SPI library
+#include "spi_dma.h"                // choose your SPI library
 
 // TFT Pins
 #define TFT_PIN_DC        PC3       // pin connected to DC (data/command) of TFT
@@ -120,6 +129,11 @@ extern "C" {
 #define TFT_RST_TIME      50        // time to wait after reset in milliseconds
 #define TFT_SLPOUT_TIME   150       // time to wait after sleep out in milliseconds
 
+// TFT DMA Parameters
+#define TFT_DMA           1         // 1: use DMA for pixel data (needs spi_dma.h)
+#define TFT_DMA_MIN       16        // minimum number of pixels to use DMA for fills
+#define TFT_LINEBUF       64        // line buffer size in pixels (at least 64)
+
 // TFT Text Parameters
 #define TFT_PRINT         0         // 1: include print functions (needs print.h)
 #define TFT_SEG_FONT      1         // 0: standard font, 1: 13x32 digits, 2: 5x16 digits
@@ -159,6 +173,13 @@ void TFT_sleep(uint8_t yes);
 void TFT_invert(uint8_t yes);
 void TFT_resync(void);
 
+// TFT Stream Functions
+void TFT_SPI_command(uint8_t cmd);
+void TFT_streamStart(int16_t x, int16_t y, int16_t w, int16_t h);
+void TFT_streamColor(uint16_t color);
+void TFT_streamFill(uint16_t color, uint32_t count);
+void TFT_streamStop(void);
+
 // TFT Graphics Functions
 void TFT_clear(void);
 void TFT_fill(uint16_t color);
@@ -0,0 +1,149 @@
+// ===================================================================================
+// Basic FLASH Functions for CH32V003                                         * v1.3 *
+// ===================================================================================
+// 2023 by Stefan Wagner:   https://github.com/wagiminator
+
+#include "flash.h"
+
+#define FLASH_OB_MASK       0b11100010
+#define FLASH_busy()        (FLASH->STATR & FLASH_STATR_BSY)
+#define FLASH_error()       (FLASH->STATR & FLASH_STATR_WRPRTERR)
+#define FLASH_eop()         (FLASH->STATR & FLASH_STATR_EOP)
+
+// Erase FLASH page (64 bytes)
+void FLASH_PAGE_erase(uint16_t page) {
+  uint32_t addr = FLASH_PAGE_BASE(page);
+  FLASH_FAST_unlock();
+  FLASH->CTLR |=  FLASH_CTLR_PAGE_ER;
+  FLASH->ADDR  =  addr;
+  FLASH->CTLR |=  FLASH_CTLR_STRT;
+  while(FLASH_busy());
+  FLASH->CTLR &= ~FLASH_CTLR_PAGE_ER;
+  FLASH_FAST_lock();
+}
+
+// Write 64 bytes from buffer to erased FLASH page using fast page programming mode
+void FLASH_PAGE_write(uint16_t page, const uint32_t* buf) {
+  __IO uint32_t* ptr = (__IO uint32_t*)FLASH_PAGE_BASE(page);
+  FLASH_FAST_unlock();
+  FLASH->CTLR  = FLASH_CTLR_PAGE_PG;                      // fast page programming mode
+  FLASH->CTLR  = FLASH_CTLR_PAGE_PG | FLASH_CTLR_BUF_RST; // reset page buffer
+  while(FLASH_busy());
+  for(uint8_t i=FLASH_PAGE_SIZE/4; i; i--) {
+    *ptr++ = *buf++;                                      // write word to page buffer
+    FLASH->CTLR = FLASH_CTLR_PAGE_PG | FLASH_CTLR_BUF_LOAD; // load word
+    while(FLASH_busy());
+  }
+  FLASH->ADDR  = FLASH_PAGE_BASE(page);
+  FLASH->CTLR  = FLASH_CTLR_PAGE_PG | FLASH_CTLR_STRT;    // program whole page
+  while(FLASH_busy());
+  FLASH->CTLR &= ~FLASH_CTLR_PAGE_PG;
+  FLASH_FAST_lock();
+}
+
+// Erase FLASH page and write 64 bytes from buffer to it
+void FLASH_PAGE_update(uint16_t page, const uint32_t* buf) {
+  FLASH_PAGE_erase(page);
+  FLASH_PAGE_write(page, buf);
+}
+
+// Write bytes from buffer to FLASH addr (read-modify-write of affected pages)
+void FLASH_writeBuffer(uint32_t addr, const uint8_t* buf, uint16_t len) {
+  uint32_t page[FLASH_PAGE_SIZE/4];
+  uint8_t* ptr = (uint8_t*)page;
+  while(len) {
+    const uint32_t* base = (const uint32_t*)(addr & ~(uint32_t)(FLASH_PAGE_SIZE - 1));
+    uint16_t pnum   = ((uint32_t)base - FLASH_BASE) >> 6;   // page number
+    uint8_t  offset = addr & (FLASH_PAGE_SIZE - 1);
+    uint8_t  cnt    = FLASH_PAGE_SIZE - offset;
+    uint8_t  diff   = 0;
+    if(cnt > len) cnt = len;
+    for(uint8_t i=0; i<FLASH_PAGE_SIZE/4; i++) page[i] = base[i]; // read page
+    for(uint8_t i=0; i<cnt; i++) {                        // merge new data
+      if(ptr[offset + i] != buf[i]) {
+        ptr[offset + i] = buf[i];
+        diff = 1;
+      }
+    }
+    if(diff) FLASH_PAGE_update(pnum, page); // write page if changed
+    addr += cnt; buf += cnt; len -= cnt;
+  }
+}
+
+// Write 16-bit data to FLASH addr
+void FLASH_write(uint32_t addr, uint16_t data) {
+  FLASH->CTLR |= FLASH_CTLR_PG;
+  *(__IO uint16_t *)addr = data;
+  while(FLASH_busy());
+  FLASH->CTLR &= ~FLASH_CTLR_PG;
+}
+
+// Write option byte to FLASH addr
+void FLASH_OB_write(uint32_t addr, uint8_t data) {
+  FLASH->CTLR |= FLASH_CTLR_OPTPG;
+  *(__IO uint16_t *)addr = data;
+  while(FLASH_busy());
+  FLASH->CTLR &= ~FLASH_CTLR_OPTPG;
+}
+
+// Unlock FLASH and remove option bytes write protection
+void FLASH_OB_unlock_full(void) {
+  FLASH_unlock();
+  FLASH_OB_unlock();
+}
+
+// Set option bytes read protection and CODE FLASH write protection
+void FLASH_OB_protect(void) {
+  FLASH_OB_unlock_full();
+  FLASH->CTLR |=  FLASH_CTLR_OPTPG;
+  OB->RDPR = 0x0001;
+  while(FLASH_busy());
+  FLASH->CTLR &= ~FLASH_CTLR_OPTPG;
+  FLASH_lock();
+}
+
+// Remove option bytes read protection and CODE FLASH write protection
+void FLASH_OB_unprotect(void) {
+  FLASH_OB_unlock_full();
+  FLASH->CTLR |=  FLASH_CTLR_OPTPG;
+  OB->RDPR = FLASH_RDPRT;
+  while(FLASH_busy());
+  FLASH->CTLR &= ~FLASH_CTLR_OPTPG;
+  FLASH_lock();
+}
+
+// Erase option bytes area and remove protection
+void FLASH_OB_erase(void) {
+  FLASH_OB_unlock_full();
+  FLASH->CTLR |=  FLASH_CTLR_OPTER;
+  FLASH->CTLR |=  FLASH_CTLR_STRT;
+  while(FLASH_busy());
+  FLASH->CTLR &= ~FLASH_CTLR_OPTER;
+  FLASH->CTLR |=  FLASH_CTLR_OPTPG;
+  OB->RDPR = FLASH_RDPRT;
+  while(FLASH_busy());
+  FLASH->CTLR &= ~FLASH_CTLR_OPTPG;
+  FLASH_lock();
+}
+
+// Write option bytes user flags
+void FLASH_OB_USER_write(uint8_t flags) {
+  FLASH_OB_unlock_full();
+  FLASH->CTLR |= FLASH_CTLR_OPTPG;
+  OB->USER = (uint16_t)(FLASH_OB_MASK | flags);
+  while(FLASH_busy());
+  FLASH->CTLR &= ~FLASH_CTLR_OPTPG;
+  FLASH_lock();
+}
+
+// Write option bytes user data
+void FLASH_OB_DATA_write(uint16_t data) {
+  FLASH_OB_unlock_full();
+  FLASH->CTLR |= FLASH_CTLR_OPTPG;
+  OB->Data0 = (uint16_t)(data & 0x00FF);
+  while(FLASH_busy());
+  OB->Data1 = (uint16_t)(data >> 8);
+  while(FLASH_busy());
+  FLASH->CTLR &= ~FLASH_CTLR_OPTPG;
+  FLASH_lock();
+}
@@ -30,6 +30,64 @@
 // - Connect the device via USB-to-serial converter to your PC.
 // - Open a serial terminal and select the proper COM port.
 // - Write and execute your BASIC program.
+//
+// Hardware Statements and Functions:
+// ----------------------------------
+// Pins are given as numbers: PA0..PA7 = 0..7, PC0..PC7 = 8..15, PD0..PD7 = 16..23.
+// OUT p,v        Set pin p to output and write value v (0: LOW, else HIGH)
+// IN(p)          Set pin p to input with pullup and return its value (0/1)
+// ADC(p)         Sample analog pin p (PA1, PA2, PC4, PD2, PD3, PD4), returns 0..1023
+// PWM p,d        Set PWM duty cycle d (0..255) on pin p (PC0, PD3, PD4), ~3.9kHz
+// DELAY n        Wait n milliseconds (can be aborted with ESC)
+// TICK()         Return milliseconds counter (counts while a program is running)
+// PEEK(i)        Read peripheral register at address 0x40000000 + 4*i
+// POKE i,v       Write value v to peripheral register at address 0x40000000 + 4*i
+// In 16-bit mode only the lower 16 bits of a register can be read and written.
+// Example (blink LED on PC0): 10 OUT 8,1;DELAY 500;OUT 8,0;DELAY 500;GOTO 10
+//
+// Build Options (ttbasic.h):
+// --------------------------
+// - TB_INT32 = 1: Variables, arrays and constants are 32-bit values instead of 16-bit.
+//   Line numbers stay in the range of 1..32767.
+// - TB_FLASH = 1: The program list is kept in the upper 4K of the code flash and is
+//   executed directly from there. Each entered or deleted line rewrites only the
+//   flash pages from that line to the end of the list. The 1K list buffer in RAM is
+//   omitted, the freed RAM is used for a larger array. The program is retained after
+//   power off and is listed again after reset (NEW clears it). Build with
+//   "make TB_FLASH=1" or the CH32V003_TB_FLASH PlatformIO environment, which also
+//   select the linker script that keeps the code out of the upper 4K.
+//
+// Benchmark Programs:
+// -------------------
+// Type NEW, the program and RUN, the runtime can be measured with a stopwatch. Number
+// of executed statements is given for calculating statements per second. Programs 2
+// to 4 need 50 filler lines between (e.g. "100 A=A+1" to "149 A=A+1"), so that jump
+// targets are at the end of a long list. No results on the CH32V003 have been
+// recorded yet. Timings of a host build don't tell the speed on the target, which
+// has no hardware divider and runs from flash with a wait state.
+// 1. FOR/NEXT (600k statements):
+//    10 FOR K=1 TO 20;FOR I=1 TO 30000
+//    20 NEXT I;NEXT K
+// 2. GOTO loop (1.2M statements):
+//    10 FOR K=1 TO 10;I=0
+//    900 I=I+1;IF I<30000 GOTO 900
+//    905 NEXT K
+// 3. GOSUB (1.4M statements):
+//    10 FOR K=1 TO 10;FOR I=1 TO 20000;GOSUB 950;NEXT I;NEXT K
+//    20 STOP
+//    950 B=B+1;RETURN
+// 4. Computed GOTO (800k statements):
+//    10 FOR K=1 TO 10;I=0
+//    900 I=I+1;GOTO 910+(I>20000)*10
+//    910 GOTO 900
+//    920 NEXT K
+// 5. Sieve (638k statements):
+//    10 FOR K=1 TO 2000
+//    20 FOR I=0 TO 31;@(I)=1;NEXT I
+//    30 FOR I=2 TO 15;IF @(I)=0 GOTO 60
+//    40 FOR J=I*2 TO 31 STEP I;@(J)=0;NEXT J
+//    60 NEXT I
+//    70 NEXT K
 
 
 // ===================================================================================
@@ -14,14 +14,15 @@ void newline(void) {
 }
 
 // Return random number
-short getrnd(short max) {
+num_t getrnd(num_t max) {
   static uint32_t rnval = 0xACE1DFEE;
   rnval = rnval << 16 | (rnval << 1 ^ rnval << 2) >> 16;
-  return(rnval % (max + 1));
+  if(max < 0) return 0;
+  return(rnval % ((uint32_t)max + 1)); // no overflow for max = NUM_MAX
 }
 
 // Prototypes (necessity minimum)
-short iexp(void);
+num_t iexp(void);
 
 // Keyword table
 const char *kwtbl[] = {
@@ -29,10 +30,12 @@ const char *kwtbl[] = {
   "FOR", "TO", "STEP", "NEXT",
   "IF", "REM", "STOP",
   "INPUT", "PRINT", "LET",
+  "POKE", "OUT", "PWM", "DELAY",
   ",", ";",
   "-", "+", "*", "/", "(", ")",
   ">=", "#", ">", "=", "<=", "<",
   "@", "RND", "ABS", "SIZE",
+  "PEEK", "IN", "ADC", "TICK",
   "LIST", "RUN", "NEW"
 };
 
@@ -45,12 +48,14 @@ enum {
   I_FOR, I_TO, I_STEP, I_NEXT,
   I_IF, I_REM, I_STOP,
   I_INPUT, I_PRINT, I_LET,
+  I_POKE, I_OUT, I_PWM, I_DELAY,
   I_COMMA, I_SEMI,
   I_MINUS, I_PLUS, I_MUL, I_DIV, I_OPEN, I_CLOSE,
   I_GTE, I_SHARP, I_GT, I_EQ, I_LTE, I_LT,
   I_ARRAY, I_RND, I_ABS, I_SIZE,
+  I_PEEK, I_IN, I_ADC, I_TICK,
   I_LIST, I_RUN, I_NEW,
-  I_NUM, I_VAR, I_STR,
+  I_NUM, I_LNUM, I_VAR, I_STR,
   I_EOL
 
 };
@@ -61,7 +66,8 @@ const unsigned char i_nsa[] = {
   I_RETURN, I_STOP, I_COMMA,
   I_MINUS, I_PLUS, I_MUL, I_DIV, I_OPEN, I_CLOSE,
   I_GTE, I_SHARP, I_GT, I_EQ, I_LTE, I_LT,
-  I_ARRAY, I_RND, I_ABS, I_SIZE
+  I_ARRAY, I_RND, I_ABS, I_SIZE,
+  I_PEEK, I_IN, I_ADC, I_TICK
 };
 
 // 前が定数か変数のとき前の空白をなくす中間コード
@@ -109,7 +115,8 @@ const char* errmsg[] = {
   "Illegal command",
   "Syntax error",
   "Internal error",
-  "User abort"
+  "User abort",
+  "Illegal pin"
 };
 
 // Error code assignment
@@ -128,21 +135,31 @@ enum {
   ERR_COM,
   ERR_SYNTAX,
   ERR_SYS,
-  ERR_ESC
+  ERR_ESC,
+  ERR_PIN
 };
 
 // RAM mapping
 char lbuf[SIZE_LINE]; //Command line buffer
 unsigned char ibuf[SIZE_IBUF]; //i-code conversion buffer
-short var[26]; //Variable area
-short arr[SIZE_ARRY]; //Array area
+num_t var[26]; //Variable area
+num_t arr[SIZE_ARRY]; //Array area
+#if TB_FLASH > 0
+#define listbuf ((unsigned char*)FLASH_LIST) //List area (code flash)
+unsigned char lpage[FLASH_PAGE] __attribute__((aligned(4))); //Page buffer for writing the list
+#else
 unsigned char listbuf[SIZE_LIST]; //List area
+#endif
 unsigned char* clp; //Pointer current line
 unsigned char* cip; //Pointer current Intermediate code
 unsigned char* gstk[SIZE_GSTK]; //GOSUB stack
 unsigned char gstki; //GOSUB stack index
 unsigned char* lstk[SIZE_LSTK]; //FOR stack
 unsigned char lstki; //FOR stack index
+unsigned short lidx[SIZE_LIDX]; //Line index: offset of every LIDX_STEP-th line
+unsigned char lidxn; //Number of line index entries
+unsigned short jcsite[SIZE_JCACHE]; //Jump cache: offset of jump site (0: empty)
+unsigned short jctarget[SIZE_JCACHE]; //Jump cache: offset of target line
 
 // Standard C library (about) same functions
 char c_toupper(char c) {
@@ -192,8 +209,11 @@ void c_gets() {
   }
 }
 
+// Check if appending digit d to value v would exceed NUM_MAX
+#define numof(v, d) ((v) > NUM_MAX / 10 || ((v) == NUM_MAX / 10 && (d) > NUM_MAX % 10))
+
 // Print numeric specified columns
-void putnum(short value, short d) {
+void putnum(num_t value, short d) {
   unsigned char dig; //桁位置
   unsigned char sign; //負号の有無（値を絶対値に変換した印）
 
@@ -204,8 +224,8 @@ void putnum(short value, short d) {
     sign = 0; //負号なし
   }
 
-  lbuf[6] = 0; //終端を置く
-  dig = 6; //桁位置の初期値を末尾に設定
+  lbuf[NUM_DIGITS + 1] = 0; //終端を置く
+  dig = NUM_DIGITS + 1; //桁位置の初期値を末尾に設定
   do { //次の処理をやってみる
     lbuf[--dig] = (value % 10) + '0'; //1の位を文字に変換して保存
     value /= 10; //1桁落とす
@@ -214,7 +234,7 @@ void putnum(short value, short d) {
   if (sign) //もし負号ありなら
     lbuf[--dig] = '-'; //負号を保存
 
-  while (6 - dig < d) { //指定の桁数を下回っていれば繰り返す
+  while (NUM_DIGITS + 1 - dig < d) { //指定の桁数を下回っていれば繰り返す
     c_putch(' '); //桁の不足を空白で埋める
     d--; //指定の桁数を1減らす
   }
@@ -223,8 +243,8 @@ void putnum(short value, short d) {
 
 // Input numeric and return value
 // Called by only INPUT statement
-short getnum() {
-  short value, tmp; //値と計算過程の値
+num_t getnum() {
+  num_t value, tmp; //値と数字の値
   char c; //文字
   unsigned char len; //文字数
   unsigned char sign; //負号
@@ -236,9 +256,9 @@ short getnum() {
       len--; //文字数を1減らす
       c_putch(8); c_putch(' '); c_putch(8); //文字を消す
     } else
-    //行頭の符号および数字が入力された場合の処理（符号込みで6桁を超えないこと）
+    //行頭の符号および数字が入力された場合の処理（符号込みでNUM_DIGITS+1桁を超えないこと）
     if ((len == 0 && (c == '+' || c == '-')) ||
-      (len < 6 && c_isdigit(c))) {
+      (len < NUM_DIGITS + 1 && c_isdigit(c))) {
       lbuf[len++] = c; //バッファへ入れて文字数を1増やす
       c_putch(c); //表示
     }
@@ -262,13 +282,12 @@ short getnum() {
   }
 
   value = 0; //値をクリア
-  tmp = 0; //計算過程の値をクリア
   while (lbuf[len]) { //終端でなければ繰り返す
-    tmp = 10 * value + lbuf[len++] - '0'; //数字を値に変換
-    if (value > tmp) { //もし計算過程の値が前回より小さければ
+    tmp = lbuf[len++] - '0'; //数字を値に変換
+    if (numof(value, tmp)) { //もし値の上限を超えるなら
       err = ERR_VOF; //オーバーフローを記録
     }
-    value = tmp; //計算過程の値を記録
+    value = 10 * value + tmp; //計算過程の値を記録
   }
 
   if (sign) //もし負の値なら
@@ -286,8 +305,8 @@ unsigned char toktoi() {
   char* ptok; //ひとつの単語の内部を指すポインタ
   char* s = lbuf; //文字列バッファの内部を指すポインタ
   char c; //文字列の括りに使われている文字（「"」または「'」）
-  short value; //定数
-  short tmp; //変換過程の定数
+  num_t value; //定数
+  num_t tmp; //数字の値
 
   while (*s) { //文字列1行分の終端まで繰り返す
     while (c_isspace(*s)) s++; //空白を読み飛ばす
@@ -345,21 +364,30 @@ unsigned char toktoi() {
     //定数への変換を試みる
     if (c_isdigit(*ptok)) { //もし文字が数字なら
       value = 0; //定数をクリア
-      tmp = 0; //変換過程の定数をクリア
       do { //次の処理をやってみる
-        tmp = 10 * value + *ptok++ - '0'; //数字を値に変換
-        if (value > tmp) { //もし前回の値より小さければ
+        tmp = *ptok++ - '0'; //数字を値に変換
+        if (numof(value, tmp)) { //もし値の上限を超えるなら
           err = ERR_VOF; //エラー番号をセット
           return 0; //0を持ち帰る
         }
-        value = tmp; //0を持ち帰る
+        value = 10 * value + tmp; //値に数字を加える
       } while (c_isdigit(*ptok)); //文字が数字である限り繰り返す
 
-      if (len >= SIZE_IBUF - 3) { //もし中間コードが長すぎたら
+      if (len >= SIZE_IBUF - 5) { //もし中間コードが長すぎたら
         err = ERR_IBUFOF; //エラー番号をセット
         return 0; //0を持ち帰る
       }
       s = ptok; //文字列の処理ずみの部分を詰める
+#if TB_INT32 > 0
+      if (value > 32767) { //もし16ビットに収まらなければ
+        ibuf[len++] = I_LNUM; //中間コードを記録
+        ibuf[len++] = value & 255; //定数の下位バイトから順に記録
+        ibuf[len++] = value >> 8;
+        ibuf[len++] = value >> 16;
+        ibuf[len++] = value >> 24;
+        continue; //次の単語へ
+      }
+#endif
       ibuf[len++] = I_NUM; //中間コードを記録
       ibuf[len++] = value & 255; //定数の下位バイトを記録
       ibuf[len++] = value >> 8; //定数の上位バイトを記録
@@ -423,6 +451,11 @@ short getsize() {
   return listbuf + SIZE_LIST - lp - 1; //残りを計算して持ち帰る
 }
 
+#if TB_INT32 > 0
+// Get 32-bit constant of I_LNUM
+#define getlnum(p) ((num_t)((p)[0] | (p)[1] << 8 | (uint32_t)(p)[2] << 16 | (uint32_t)(p)[3] << 24))
+#endif
+
 // Get line numbere by line pointer
 short getlineno(unsigned char *lp) {
   if(*lp == 0) //もし末尾だったら
@@ -430,17 +463,137 @@ short getlineno(unsigned char *lp) {
   return *(lp + 1) | *(lp + 2) << 8; //行番号を持ち帰る
 }
 
+// Rebuild line index and clear jump cache (must be called if the list was changed)
+void mkindex() {
+  unsigned char *lp; //ポインタ
+  unsigned short n = 0; //行数
+  unsigned char i; //ループカウンタ
+
+  lidxn = 0; //索引を空にする
+  for (lp = listbuf; *lp && (lidxn < SIZE_LIDX); lp += *lp) //先頭から末尾まで繰り返す
+    if (!(n++ & (LIDX_STEP - 1))) //LIDX_STEP行ごとに
+      lidx[lidxn++] = lp - listbuf; //行の位置を索引に記録
+
+  for (i = 0; i < SIZE_JCACHE; i++) //分岐キャッシュを空にする
+    jcsite[i] = 0;
+}
+
 // Search line by line number
 unsigned char* getlp(short lineno) {
   unsigned char *lp; //ポインタ
+  unsigned char lo = 0, hi = lidxn, mid; //二分探索の範囲
 
-  for (lp = listbuf; *lp; lp += *lp) //先頭から末尾まで繰り返す
+  //索引を二分探索して、指定の行番号より前の最後の索引を探す
+  while (lo < hi) {
+    mid = (lo + hi) >> 1;
+    if (getlineno(listbuf + lidx[mid]) < lineno)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+
+  //索引の位置から末尾まで繰り返す（最大LIDX_STEP行）
+  for (lp = lo ? listbuf + lidx[lo - 1] : listbuf; *lp; lp += *lp)
     if (getlineno(lp) >= lineno) //もし指定の行番号以上なら
       break; //繰り返しを打ち切る
 
   return lp; //ポインタを持ち帰る
 }
 
+#if TB_FLASH > 0
+// Replace dlen bytes of the list at offset pos by ilen bytes of ins and move the rest
+// of the list, only the flash pages from pos to the new end of the list are rewritten
+void lreplace(unsigned short pos, unsigned short dlen,
+  unsigned char *ins, unsigned short ilen) {
+  unsigned char *lp; //ポインタ
+  unsigned short end; //新しいリストの末尾の位置（末尾の印を含む）
+  unsigned short o; //書き込む位置
+  short delta; //後ろの部分の移動量
+  short page, last, step; //書き込むページと進む向き
+  unsigned char i; //ループカウンタ
+
+  for (lp = listbuf; *lp; lp += *lp); //ポインタをリストの末尾へ移動
+  delta = ilen - dlen; //移動量を計算
+  end = lp - listbuf + 1 + delta; //新しいリストの末尾を計算
+  page = pos / FLASH_PAGE; //最初のページ
+  last = (end - 1) / FLASH_PAGE; //最後のページ
+  step = 1; //前のページから書き換える
+
+  //後ろへ移動する場合は後ろのページから書き換えて、未読のデータを壊さないようにする
+  if (delta > 0) {
+    step = page; page = last; last = step; //最初と最後のページを入れ替える
+    step = -1; //後ろのページから書き換える
+  }
+
+  FLASH_unlock(); //フラッシュの書き込み禁止を解除
+  while (1) {
+    //ページの内容をバッファに組み立てる
+    for (i = 0; i < FLASH_PAGE; i++) {
+      o = page * FLASH_PAGE + i; //書き込む位置
+      if (o < pos) lpage[i] = listbuf[o]; //挿入位置より前はそのまま
+      else if (o < pos + ilen) lpage[i] = ins[o - pos]; //挿入する中間コード
+      else if (o < end) lpage[i] = listbuf[o - delta]; //挿入位置より後ろは移動
+      else lpage[i] = 0; //新しい末尾より後ろは0
+    }
+
+    //ページを消去してバッファを一度に書き込む
+    FLASH_PAGE_update((FLASH_LIST - FLASH_BASE) / FLASH_PAGE + page, (uint32_t*)lpage);
+
+    if (page == last) break; //最後のページなら終了
+    page += step; //次のページへ
+  }
+  FLASH_lock(); //フラッシュを書き込み禁止にする
+}
+
+// Clear the list in flash (only the first page is rewritten)
+void lclear() {
+  FLASH_unlock(); //フラッシュの書き込み禁止を解除
+  FLASH_PAGE_erase((FLASH_LIST - FLASH_BASE) / FLASH_PAGE); //最初のページを消去
+  FLASH_write(FLASH_LIST, 0); //先頭に末尾の印を置く
+  FLASH_lock(); //フラッシュを書き込み禁止にする
+}
+
+// Check the list in flash (it may be erased or garbage after programming the firmware)
+unsigned char lcheck() {
+  unsigned char *lp; //ポインタ
+  short lineno = 0; //前の行の行番号
+
+  for (lp = listbuf; *lp; lp += *lp) { //先頭から末尾まで繰り返す
+    if ((*lp < 4) || (lp + *lp >= listbuf + SIZE_LIST) || //もし行の長さが不正か
+      (lp[*lp - 1] != I_EOL) || (getlineno(lp) <= lineno)) //行末や行番号が不正なら
+      return 0; //0を持ち帰る
+    lineno = getlineno(lp); //行番号を記憶
+  }
+  return 1; //1を持ち帰る
+}
+
+// Insert i-code to the list
+void inslist() {
+  unsigned char *insp; //挿入位置
+  unsigned char dlen = 0; //削除する長さ
+
+  if (getsize() < *ibuf) { //もし空きが不足していたら
+    err = ERR_LBUFOF; //エラー番号をセット
+    return; //処理を打ち切る
+  }
+
+  insp = getlp(getlineno(ibuf)); //挿入位置を取得
+
+  //同じ行番号の行が存在したら置き換える
+  if (getlineno(insp) == getlineno(ibuf)) //もし行番号が一致したら
+    dlen = *insp; //その行を削除する
+
+  //行番号だけが入力された場合は削除のみ
+  if (*ibuf == 4) { //もし長さが4（行番号のみ）なら
+    if (!dlen) //もし削除する行がなければ
+      return; //終了する
+    lreplace(insp - listbuf, dlen, ibuf, 0); //行を削除
+  } else
+    lreplace(insp - listbuf, dlen, ibuf, *ibuf); //行を挿入
+
+  mkindex(); //索引を作り直す
+}
+#else
 // Insert i-code to the list
 void inslist() {
   unsigned char *insp; //挿入位置
@@ -466,8 +619,10 @@ void inslist() {
   }
 
   //行番号だけが入力された場合はここで終わる
-  if (*ibuf == 4) //もし長さが4（行番号のみ）なら
+  if (*ibuf == 4) { //もし長さが4（行番号のみ）なら
+    mkindex(); //索引を作り直す
     return; //終了する
+  }
 
   //挿入のためのスペースを空ける
   for (p1 = insp; *p1; p1 += *p1); //p1をリストの末尾へ移動
@@ -482,7 +637,10 @@ void inslist() {
   p2 = ibuf; //転送元を設定
   while (len--) //中間コードの長さだけ繰り返す
     *p1++ = *p2++; //転送
+
+  mkindex(); //索引を作り直す
 }
+#endif
 
 //Listing 1 line of i-code
 void putlist(unsigned char* ip) {
@@ -518,6 +676,18 @@ void putlist(unsigned char* ip) {
     }
     else
 
+#if TB_INT32 > 0
+    //32ビット定数の処理
+    if (*ip == I_LNUM) { //もし32ビット定数なら
+      ip++; //ポインタを値へ進める
+      putnum(getlnum(ip), 0); //値を取得して表示
+      ip += 4; //ポインタを次の中間コードへ進める
+      if (!nospaceb(*ip)) //もし例外にあたらなければ
+        c_putch(' '); //空白を表示
+    }
+    else
+#endif
+
     //変数の処理
     if (*ip == I_VAR) { //もし定数なら
       ip++; //ポインタを変数番号へ進める
@@ -557,9 +727,140 @@ void putlist(unsigned char* ip) {
   }
 }
 
+// Millisecond counter for TICK (updated while a program runs)
+uint32_t tickms; //経過時間（ミリ秒）
+uint32_t tickcnt; //最後に数えたSysTickの値
+
+// Update millisecond counter and return it
+num_t gettick() {
+  uint32_t n = (STK->CNT - tickcnt) / DLY_MS_TIME; //前回から経過したミリ秒
+
+  tickcnt += n * DLY_MS_TIME; //数えた分だけSysTickの値を進める
+  tickms += n; //経過時間に加える
+  return tickms; //経過時間を持ち帰る
+}
+
+// Check if pin is in pin mask
+unsigned char chkpin(num_t pin, uint32_t mask) {
+  if (((unum_t)pin >= PIN_COUNT) || !((mask >> pin) & 1)) { //もし使えない端子なら
+    err = ERR_PIN; //エラー番号をセット
+    return 0; //0を持ち帰る
+  }
+  return 1; //1を持ち帰る
+}
+
+// Get two arguments separated by comma
+void getargs(num_t *a, num_t *b) {
+  *a = iexp(); //1番目の引数を取得
+  if (err) //もしエラーが生じたら
+    return; //終了
+  if (*cip != I_COMMA) { //もしコンマでなければ
+    err = ERR_SYNTAX; //エラー番号をセット
+    return; //終了
+  }
+  cip++; //中間コードポインタを次へ進める
+  *b = iexp(); //2番目の引数を取得
+}
+
+// PEEK function: read 32-bit register with index addr
+num_t fpeek(num_t addr) {
+  return *(__IO uint32_t*)(POKE_BASE + ((uint32_t)(uint16_t)addr << 2));
+}
+
+// IN function: set pin to input with pullup and read it
+num_t fin(num_t pin) {
+  if (!chkpin(pin, PIN_MASK)) //もし使えない端子なら
+    return 0; //終了
+  PIN_input_PU(pin); //プルアップ付きの入力に設定
+  return PIN_read(pin); //端子の値を持ち帰る
+}
+
+// ADC function: sample analog pin (0..1023)
+num_t fadc(num_t pin) {
+  if (!chkpin(pin, ADC_MASK)) //もしADCの端子でなければ
+    return 0; //終了
+  if (!(ADC1->CTLR2 & ADC_ADON)) //もしADCが停止していたら
+    ADC_init(); //ADCを初期化
+  PIN_input_AN(pin); //アナログ入力に設定
+  ADC_input(pin); //ADCの入力を選択
+  return ADC_read(); //変換した値を持ち帰る
+}
+
+// POKE handler: write 32-bit register with index addr
+void ipoke() {
+  num_t addr, value; //レジスタ番号と値
+
+  getargs(&addr, &value); //引数を取得
+  if (err) //もしエラーが生じたら
+    return; //終了
+  *(__IO uint32_t*)(POKE_BASE + ((uint32_t)(uint16_t)addr << 2)) = (unum_t)value;
+}
+
+// OUT handler: set pin to output and write value
+void iout() {
+  num_t pin, value; //端子と値
+
+  getargs(&pin, &value); //引数を取得
+  if (err || !chkpin(pin, PIN_MASK)) //もしエラーか使えない端子なら
+    return; //終了
+  PIN_write(pin, value); //出力の値を設定
+  PIN_output(pin); //出力に設定
+}
+
+// PWM handler: set duty cycle (0..255) of PWM pin
+void ipwm() {
+  num_t pin, duty; //端子とデューティ比
+
+  getargs(&pin, &duty); //引数を取得
+  if (err || !chkpin(pin, PWM_MASK)) //もしエラーかPWMの端子でなければ
+    return; //終了
+  if (duty < 0) duty = 0; //範囲に収める
+  if (duty > PWM_TOP + 1) duty = PWM_TOP + 1;
+
+  if (!(TIM2->CTLR1 & TIM_CEN)) { //もしタイマーが停止していたら
+    RCC->APB1PCENR |= RCC_TIM2EN; //タイマーを有効にする
+    RCC->APB2PCENR |= RCC_AFIOEN; //代替機能を有効にする
+    TIM2->PSC       = PWM_PRESC; //プリスケーラを設定
+    TIM2->ATRLR     = PWM_TOP; //周期を設定
+    TIM2->CHCTLR1   = TIM_OC1M_2 | TIM_OC1M_1 | TIM_OC2M_2 | TIM_OC2M_1; //PWMモード1
+    TIM2->CHCTLR2   = TIM_OC3M_2 | TIM_OC3M_1;
+    TIM2->SWEVGR    = TIM_UG; //設定を反映
+    TIM2->CTLR1     = TIM_CEN; //タイマーを開始
+  }
+
+  switch (pin) { //端子で分岐
+  case PD4: TIM2->CH1CVR = duty; TIM2->CCER |= TIM_CC1E; break; //チャネル1
+  case PD3: TIM2->CH2CVR = duty; TIM2->CCER |= TIM_CC2E; break; //チャネル2
+  default:  TIM2->CH3CVR = duty; TIM2->CCER |= TIM_CC3E; break; //チャネル3（PC0）
+  }
+  PIN_alternate(pin); //代替機能の出力に設定
+}
+
+// DELAY handler: wait milliseconds (can be aborted with ESC)
+void idelay() {
+  num_t value; //待ち時間
+
+  value = iexp(); //待ち時間を取得
+  if (err) //もしエラーが生じたら
+    return; //終了
+  while (value-- > 0) { //待ち時間だけ繰り返す
+    DLY_ms(1); //1ミリ秒待つ
+    if (c_kbhit() && (c_getch() == KEY_ABORT)) { //もし［ESC］キーが押されたら
+      err = ERR_ESC; //エラー番号をセット
+      return; //終了
+    }
+  }
+}
+
+// Function table (PEEK, IN, ADC: one argument in parenthesis)
+num_t (* const fnctbl[])(num_t) = {fpeek, fin, fadc};
+
+// Statement table (POKE, OUT, PWM, DELAY)
+void (* const stmtbl[])(void) = {ipoke, iout, ipwm, idelay};
+
 // Get argument in parenthesis
-short getparam() {
-  short value; //値
+num_t getparam() {
+  num_t value; //値
 
   if (*cip != I_OPEN) { //もし「(」でなければ
     err = ERR_PAREN; //エラー番号をセット
@@ -581,8 +882,9 @@ short getparam() {
 }
 
 // Get value
-short ivalue() {
-  short value; //値
+num_t ivalue() {
+  num_t value; //値
+  unsigned char i; //関数の番号
 
   switch (*cip) { //中間コードで分岐
 
@@ -593,6 +895,14 @@ short ivalue() {
     cip += 2; //中間コードポインタを定数の次へ進める
     break; //ここで打ち切る
 
+#if TB_INT32 > 0
+  case I_LNUM: //32ビット定数の場合
+    cip++; //中間コードポインタを次へ進める
+    value = getlnum(cip); //定数を取得
+    cip += 4; //中間コードポインタを定数の次へ進める
+    break; //ここで打ち切る
+#endif
+
   //+付きの値の取得
   case I_PLUS: //「+」の場合
     cip++; //中間コードポインタを次へ進める
@@ -622,7 +932,7 @@ short ivalue() {
     value = getparam(); //括弧の値を取得
     if (err) //もしエラーが生じたら
       break; //ここで打ち切る
-    if (value >= SIZE_ARRY) { //もし添え字の上限を超えたら
+    if ((unsigned)value >= SIZE_ARRY) { //もし添え字の上限を超えたら
       err = ERR_SOR; //エラー番号をセット
       break; //ここで打ち切る
     }
@@ -658,16 +968,35 @@ short ivalue() {
     value = getsize(); //プログラム保存領域の空きを取得
     break; //ここで打ち切る
 
+  case I_TICK: //関数TICKの場合
+    cip++; //中間コードポインタを次へ進める
+    //もし後ろに「()」がなかったら
+    if ((*cip != I_OPEN) || (*(cip + 1) != I_CLOSE)) {
+      err = ERR_PAREN; //エラー番号をセット
+      break; //ここで打ち切る
+    }
+    cip += 2; //中間コードポインタを「()」の次へ進める
+    value = gettick(); //経過時間を取得
+    break; //ここで打ち切る
+
   default: //以上のいずれにも該当しなかった場合
-    err = ERR_SYNTAX; //エラー番号をセット
+    if ((*cip < I_PEEK) || (*cip > I_ADC)) { //もし周辺機器の関数でなければ
+      err = ERR_SYNTAX; //エラー番号をセット
+      break; //ここで打ち切る
+    }
+    i = *cip++ - I_PEEK; //関数の番号を取得
+    value = getparam(); //括弧の値を取得
+    if (err) //もしエラーが生じたら
+      break; //ここで打ち切る
+    value = fnctbl[i](value); //関数の表から処理を呼び出す
     break; //ここで打ち切る
   }
   return value; //取得した値を持ち帰る
 }
 
 // multiply or divide calculation
-short imul() {
-  short value, tmp; //値と演算値
+num_t imul() {
+  num_t value, tmp; //値と演算値
 
   value = ivalue(); //値を取得
   if (err) //もしエラーが生じたら
@@ -698,8 +1027,8 @@ short imul() {
 }
 
 // add or subtract calculation
-short iplus() {
-  short value, tmp; //値と演算値
+num_t iplus() {
+  num_t value, tmp; //値と演算値
 
   value = imul(); //値を取得
   if (err) //もしエラーが生じたら
@@ -726,8 +1055,8 @@ short iplus() {
 }
 
 // The parser
-short iexp() {
-  short value, tmp; //値と演算値
+num_t iexp() {
+  num_t value, tmp; //値と演算値
 
   value = iplus(); //値を取得
   if (err) //もしエラーが生じたら
@@ -775,7 +1104,7 @@ short iexp() {
 
 // PRINT handler
 void iprint() {
-  short value; //値
+  num_t value; //値
   short len; //桁数
   unsigned char i; //文字数
 
@@ -822,8 +1151,8 @@ void iprint() {
 
 // INPUT handler
 void iinput() {
-  short value; //値
-  short index; //配列の添え字
+  num_t value; //値
+  num_t index; //配列の添え字
   unsigned char i; //文字数
   unsigned char prompt; //プロンプト表示フラグ
 
@@ -858,7 +1187,7 @@ void iinput() {
       index = getparam(); //配列の添え字を取得
       if (err) //もしエラーが生じたら
         return; //終了
-      if (index >= SIZE_ARRY) { //もし添え字が上限を超えたら
+      if ((unsigned)index >= SIZE_ARRY) { //もし添え字が上限を超えたら
         err = ERR_SOR; //エラー番号をセット
         return; //終了
       }
@@ -895,7 +1224,7 @@ void iinput() {
 
 // Variable assignment handler
 void ivar() {
-  short value; //値
+  num_t value; //値
   short index; //変数番号
 
   index = *cip++; //変数番号を取得して次へ進む
@@ -915,14 +1244,14 @@ void ivar() {
 
 // Array assignment handler
 void iarray() {
-  short value; //値
-  short index; //配列の添え字
+  num_t value; //値
+  num_t index; //配列の添え字
 
   index = getparam(); //配列の添え字を取得
   if (err) //もしエラーが生じたら
     return; //終了
 
-  if (index >= SIZE_ARRY) { //もし添え字が上限を超えたら
+  if ((unsigned)index >= SIZE_ARRY) { //もし添え字が上限を超えたら
     err = ERR_SOR; //エラー番号をセット
     return; //終了
   }
@@ -959,35 +1288,68 @@ void ilet() {
   }
 }
 
+// Get target line of GOTO/GOSUB
+// Constant targets within the list are looked up only once and kept in the jump cache
+unsigned char* getjump() {
+  unsigned short site = cip - listbuf; //分岐命令の位置
+  unsigned char slot = site & (SIZE_JCACHE - 1); //分岐キャッシュの番号
+  unsigned char cacheable; //定数の分岐先
+  unsigned char* lp; //分岐先のポインタ
+  num_t lineno; //分岐先の行番号
+
+  //分岐先が定数で文末が続くか（リストの中のみ）
+  cacheable = (cip > listbuf) && (cip < listbuf + SIZE_LIST) &&
+    (*cip == I_NUM) && ((cip[3] == I_EOL) || (cip[3] == I_SEMI));
+
+  if (cacheable && (jcsite[slot] == site)) { //もしキャッシュにあれば
+    cip += 3; //中間コードポインタを定数の次へ進める
+    return listbuf + jctarget[slot]; //分岐先のポインタを持ち帰る
+  }
+
+  lineno = iexp(); //分岐先の行番号を取得
+  if (err) //もしエラーが生じたら
+    return NULL; //終了
+  lp = getlp(lineno); //分岐先のポインタを取得
+  if (lineno != getlineno(lp)) { //もし分岐先が存在しなければ
+    err = ERR_ULN; //エラー番号をセット
+    return NULL; //終了
+  }
+
+  if (cacheable) { //定数の分岐先をキャッシュに記録
+    jcsite[slot] = site;
+    jctarget[slot] = lp - listbuf;
+  }
+  return lp; //分岐先のポインタを持ち帰る
+}
+
 // Execute a series of i-code
 unsigned char* iexe() {
-  short lineno; //行番号
   unsigned char* lp; //未確定の（エラーかもしれない）行ポインタ
-  short index, vto, vstep; //FOR文の変数番号、終了値、増分
-  short condition; //IF文の条件値
+  short index; //FOR文の変数番号
+  num_t vto, vstep; //FOR文の終了値、増分
+  num_t condition; //IF文の条件値
 
   while (*cip != I_EOL) { //行末まで繰り返す
   
-  //強制的な中断の判定
-    if (c_kbhit()) //もし未読文字があったら
-      if (c_getch() == KEY_ABORT) { //読み込んでもし［ESC］キーだったら
-        err = ERR_ESC; //エラー番号をセット
-        break; //打ち切る
-      }
+  //強制的な中断の判定（ESC_CHECK_MSごと）
+    if (c_escdue()) { //もし判定の時間になったら
+      c_escnext(); //次の判定の時間を設定
+      gettick(); //経過時間を更新
+      if (c_kbhit()) //もし未読文字があったら
+        if (c_getch() == KEY_ABORT) { //読み込んでもし［ESC］キーだったら
+          err = ERR_ESC; //エラー番号をセット
+          break; //打ち切る
+        }
+    }
 
     //中間コードを実行
     switch (*cip) { //中間コードで分岐
 
     case I_GOTO: //GOTOの場合
       cip++; //中間コードポインタを次へ進める
-      lineno = iexp(); //分岐先の行番号を取得
+      lp = getjump(); //分岐先のポインタを取得
       if (err) //もしエラーが生じたら
         break; //打ち切る
-      lp = getlp(lineno); //分岐先のポインタを取得
-      if (lineno != getlineno(lp)) { //もし分岐先が存在しなければ
-        err = ERR_ULN; //エラー番号をセット
-        break; //打ち切る
-      }
 
       clp = lp; //行ポインタを分岐先へ更新
       cip = clp + 3; //中間コードポインタを先頭の中間コードに更新
@@ -995,14 +1357,9 @@ unsigned char* iexe() {
 
     case I_GOSUB: //GOSUBの場合
       cip++; //中間コードポインタを次へ進める
-      lineno = iexp(); //分岐先の行番号を取得
+      lp = getjump(); //分岐先のポインタを取得
       if (err) //もしエラーが生じたら
         break; //打ち切る
-      lp = getlp(lineno); //分岐先のポインタを取得
-      if (lineno != getlineno(lp)) { //もし分岐先が存在しなければ
-        err = ERR_ULN; //エラー番号をセット
-        break; //打ち切る
-      }
 
       //ポインタを退避
       if (gstki > SIZE_GSTK - 2) { //もしGOSUBスタックがいっぱいなら
@@ -1056,8 +1413,8 @@ unsigned char* iexe() {
         vstep = 1; //増分を1に設定
 
       //もし変数がオーバーフローする見込みなら
-      if (((vstep < 0) && (-32767 - vstep > vto)) ||
-        ((vstep > 0) && (32767 - vstep < vto))){
+      if (((vstep < 0) && (-NUM_MAX - vstep > vto)) ||
+        ((vstep > 0) && (NUM_MAX - vstep < vto))){
         err = ERR_VOF; //エラー番号をセット
         break; //打ち切る
       }
@@ -1094,9 +1451,9 @@ unsigned char* iexe() {
         break; //打ち切る
       }
 
-      vstep = (short)(uintptr_t)lstk[lstki - 2]; //増分を復帰
+      vstep = (num_t)(uintptr_t)lstk[lstki - 2]; //増分を復帰
       var[index] += vstep; //変数の値を最新の開始値に更新
-      vto = (short)(uintptr_t)lstk[lstki - 3]; //終了値を復帰
+      vto = (num_t)(uintptr_t)lstk[lstki - 3]; //終了値を復帰
 
       //もし変数の値が終了値を超えていたら
       if (((vstep < 0) && (var[index] < vto)) ||
@@ -1162,7 +1519,10 @@ unsigned char* iexe() {
       cip++; //中間コードポインタを次へ進める
       break; //打ち切る
     default: //以上のいずれにも該当しない場合
-      err = ERR_SYNTAX; //エラー番号をセット
+      if ((*cip >= I_POKE) && (*cip <= I_DELAY)) //もし周辺機器の文なら
+        stmtbl[*cip++ - I_POKE](); //文の表から処理を呼び出す
+      else
+        err = ERR_SYNTAX; //エラー番号をセット
       break; //打ち切る
     } //中間コードで分岐の末尾
 
@@ -1218,8 +1578,8 @@ void ilist() {
   }
 }
 
-//NEW command handler
-void inew(void) {
+//Clear variables and stacks
+void iclear(void) {
   unsigned char i; //ループカウンタ
 
   //変数と配列の初期化
@@ -1231,10 +1591,21 @@ void inew(void) {
   //実行制御用の初期化
   gstki = 0; //GOSUBスタックインデクスを0に初期化
   lstki = 0; //FORスタックインデクスを0に初期化
-  *listbuf = 0; //プログラム保存領域の先頭に末尾の印を置く
   clp = listbuf; //行ポインタをプログラム保存領域の先頭に設定
 }
 
+//NEW command handler
+void inew(void) {
+  iclear(); //変数と実行制御用の初期化
+#if TB_FLASH > 0
+  if (*listbuf) //もしリストが空でなければ
+    lclear(); //フラッシュのリストを消去
+#else
+  *listbuf = 0; //プログラム保存領域の先頭に末尾の印を置く
+#endif
+  mkindex(); //索引を作り直す
+}
+
 //Command precessor
 void icom() {
 
@@ -1305,7 +1676,15 @@ void error() {
 void basic() {
   unsigned char len; //中間コードの長さ
 
+#if TB_FLASH > 0
+  iclear(); //実行環境を初期化（フラッシュのリストは保持）
+  if (!lcheck()) //もしリストが不正なら
+    lclear(); //フラッシュのリストを消去
+  mkindex(); //索引を作り直す
+#else
   inew(); //実行環境を初期化
+#endif
+  c_escnext(); //ESCキーの判定の時間を設定
 
   //起動メッセージ
   c_puts("TOYOSHIKI TINY BASIC"); //「TOYOSHIKI TINY BASIC」を表示
@@ -1313,7 +1692,7 @@ void basic() {
   c_puts(STR_EDITION); //版を区別する文字列を表示
   c_puts(" EDITION"); //「 EDITION」を表示
   newline(); //改行
-  putnum(SIZE_LIST, 0);
+  putnum(getsize(), 0);
   c_puts(" BYTES FREE");
   newline(); //改行
   error(); //「OK」またはエラーメッセージを表示してエラー番号をクリア
@@ -1330,6 +1709,14 @@ void basic() {
       continue; //繰り返しの先頭へ戻ってやり直し
     }
 
+#if TB_INT32 > 0
+    if (*ibuf == I_LNUM) { //もし行番号が16ビットに収まらなければ
+      err = ERR_VOF; //エラー番号をセット (line numbers are limited to 32767)
+      error(); //エラーメッセージを表示してエラー番号をクリア
+      continue; //繰り返しの先頭へ戻ってやり直し
+    }
+#endif
+
     //中間コードの並びがプログラムと判断される場合
     if (*ibuf == I_NUM) { //もし中間コードバッファの先頭が行番号なら
       *ibuf = len; //中間コードバッファの先頭を長さに書き換える
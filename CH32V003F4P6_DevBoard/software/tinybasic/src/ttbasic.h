@@ -5,6 +5,13 @@
 // https://github.com/rutles/ttbasic_arduino
 
 #include "uart_dma.h"
+#include "gpio.h"
+
+// TOYOSHIKI Tiny BASIC options
+#define TB_INT32      0       // 1: 32-bit values, 0: 16-bit values
+#ifndef TB_FLASH              // set by makefile (TB_FLASH=1) or platformio.ini env,
+#define TB_FLASH      0       // 1: program list in code flash, 0: in RAM
+#endif                        // which also select the matching linker script
 
 // Define special keys
 #define KEY_ENTER     10      // ENTER key: LF
@@ -14,10 +21,48 @@
 // TO-DO Rewrite defined values to fit your machine as needed
 #define SIZE_LINE     80      // Command line buffer length + NULL
 #define SIZE_IBUF     80      // i-code conversion buffer size
+#if TB_FLASH > 0
+#define SIZE_LIST     4096    // List area size (upper 4K of code flash)
+#define SIZE_ARRY     128     // Array area size
+#else
 #define SIZE_LIST     1024    // List buffer size
 #define SIZE_ARRY     32      // Array area size
+#endif
 #define SIZE_GSTK     6       // GOSUB stack size (2/nest)
 #define SIZE_LSTK     15      // FOR stack size (5/nest)
+#define SIZE_LIDX     (SIZE_LIST / 32) // Line index size (entries)
+#define LIDX_STEP     8       // Lines per line index entry (2^n)
+#define SIZE_JCACHE   8       // Jump cache size (2^n)
+#define ESC_CHECK_MS  20      // Interval of checking for ESC key in ms
+
+// Value type
+#if TB_INT32 > 0
+typedef int32_t num_t;
+typedef uint32_t unum_t;
+#define NUM_MAX       2147483647
+#define NUM_DIGITS    10      // Max number of decimal digits
+#else
+typedef short num_t;
+typedef unsigned short unum_t;
+#define NUM_MAX       32767
+#define NUM_DIGITS    5       // Max number of decimal digits
+#endif
+
+// Program list in code flash (executed in place)
+#if TB_FLASH > 0
+#include "flash.h"
+#define FLASH_LIST    (FLASH_BASE + 0x4000 - SIZE_LIST) // List area start address
+#define FLASH_PAGE    FLASH_PAGE_SIZE // Flash page size
+#endif
+
+// Hardware statements
+#define POKE_BASE     0x40000000 // PEEK/POKE: base address of 32-bit register index
+#define PIN_COUNT     24      // Pin numbers 0..23 (PA0..PA7, PC0..PC7, PD0..PD7)
+#define PIN_MASK      0x9DFF06 // OUT/IN: PA1, PA2, PC0..PC7, PD0, PD2..PD4, PD7
+#define ADC_MASK      0x1C1006 // ADC: PA1, PA2, PC4, PD2..PD4
+#define PWM_MASK      0x180100 // PWM: PC0, PD3, PD4 (TIM2)
+#define PWM_PRESC     (F_CPU / 1000000 - 1) // PWM prescaler (1MHz timer clock)
+#define PWM_TOP       254     // PWM period - 1 (duty 0..255 = 0..100%, ~3.9kHz)
 
 // Edition string
 #define STR_EDITION   "CH32V003"
@@ -27,5 +72,9 @@
 #define c_getch( )    UART_read()
 #define c_kbhit( )    UART_available()
 
+// Interval timer for ESC key check (SysTick compare flag, no interrupt needed)
+#define c_escdue( )   (STK->SR & STK_SR_CNTIF)
+#define c_escnext( )  {STK->SR = 0; STK->CMP = STK->CNT + ESC_CHECK_MS * DLY_MS_TIME;}
+
 // Functions
 void basic();
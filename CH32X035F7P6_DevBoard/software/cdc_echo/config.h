@@ -13,9 +13,18 @@
 //   matter).
 // - Send a text message (with newline termination), it should be echoed back by
 //   the device.
+// - Loopback benchmark (CDC_BENCH = 1): send a large file to the device while
+//   capturing the echo, e.g. 'cat file > /dev/ttyACM0 & cat /dev/ttyACM0 > out'.
+//   After the stream has been idle for a moment, the device appends a line with
+//   the number of bytes looped back and the achieved throughput.
 
 #pragma once
 
+// Loopback benchmark mode
+#define CDC_BENCH           0         // 1: bulk echo with throughput report
+#define CDC_BENCH_IDLE_MS   200       // idle time in ms which ends a measurement
+#define CDC_PRINT           CDC_BENCH // print functions are only needed for the report
+
 // Pin definitions
 #define PIN_LED             PB1       // pin connected to LED
 
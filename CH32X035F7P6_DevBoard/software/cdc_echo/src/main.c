@@ -32,20 +32,58 @@
 //   matter).
 // - Send a text message (with newline termination), it should be echoed back by
 //   the device.
+// - Loopback benchmark (CDC_BENCH = 1 in config.h): send a large file to the
+//   device while capturing the echo, e.g. 'cat file > /dev/ttyACM0 & 
+//   cat /dev/ttyACM0 > out'. After the stream has been idle for a moment, the
+//   device appends a line with the number of bytes looped back, the elapsed time
+//   and the achieved throughput.
 
 
 // ===================================================================================
 // Libraries, Definitions and Macros
 // ===================================================================================
+#include "config.h"                 // user configurations
 #include "system.h"                 // system functions
 #include "usb_cdc.h"                // USB CDC serial functions
 
+// ===================================================================================
+// Loopback Benchmark
+// ===================================================================================
+#if CDC_BENCH > 0
+void BENCH_run(void) {
+  uint8_t  buf[EP2_SIZE];
+  uint16_t len;
+  uint32_t bytes = 0, start = 0, last = 0, ms;
+
+  while(1) {
+    len = CDC_readBuffer(buf, sizeof(buf)); // fetch received bytes
+    if(len) {
+      if(!bytes) start = STK->CNTL;         // first packet starts measurement
+      CDC_writeBuffer(buf, len);            // echo them back in bulk
+      CDC_flush();                          // send partial packets, too
+      bytes += len;
+      last = STK->CNTL;
+    }
+    else if(bytes && (STK->CNTL - last) > (CDC_BENCH_IDLE_MS * DLY_MS_TIME)) {
+      ms = (last - start) / DLY_MS_TIME;    // elapsed time in ms
+      if(!ms) ms = 1;
+      CDC_printf("\n%d bytes in %d ms: %d kB/s\n", bytes, ms, bytes / ms);
+      bytes = 0;
+    }
+  }
+}
+#endif
+
 // ===================================================================================
 // Main Function
 // ===================================================================================
 int main(void) {
   // Setup
   CDC_init();                       // init USB CDC
+
+  #if CDC_BENCH > 0
+  BENCH_run();                      // loopback benchmark (never returns)
+  #endif
   
   // Loop
   while(1) {
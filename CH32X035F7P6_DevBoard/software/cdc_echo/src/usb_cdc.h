@@ -1,5 +1,5 @@
 // ===================================================================================
-// Basic USB CDC Functions for CH32X035/X034/X033                             * v1.0 *
+// Basic USB CDC Functions for CH32X035/X034/X033                             * v1.2 *
 // ===================================================================================
 //
 // Functions available:
@@ -10,6 +10,8 @@
 // CDC_flush()              flush transmit buffer
 // CDC_writeflush(c)        write & flush character
 // CDC_newline()            newline and flush
+// CDC_readBuffer(buf,len)  read up to len bytes from receive buffer, returns count
+// CDC_writeBuffer(buf,len) write len bytes to transmit buffer
 //
 // CDC_available()          check number of bytes in the receive buffer
 // CDC_ready()              check if transmit buffer is ready to be written
@@ -23,7 +25,7 @@
 //
 // If print functions are activated (see below, print.h must be included):
 // -----------------------------------------------------------------------
-// CDC_printf(f, ...)       printf (supports %s, %c, %d, %u, %x, %b, %02d, %%)
+// CDC_printf(f, ...)       printf (supports %s, %c, %d, %u, %x, %b, %02d, %.2d, %%)
 // CDC_printD(n)            print decimal value
 // CDC_printW(n)            print 32-bit hex word value
 // CDC_printH(n)            print 16-bit hex half-word value
@@ -32,6 +34,13 @@
 // CDC_print(s)             print string (alias)
 // CDC_println(s)           print string with newline and flush
 //
+// Bulk data is transferred via ping-pong endpoint buffers (EP2 in double buffer
+// mode) and a software FIFO in each direction. The EP2 handlers move complete
+// packets between endpoint buffers and FIFOs, so the host can send and fetch
+// back-to-back packets without waiting for the main code. While one IN packet is
+// in flight, the next full packet is preloaded into the other buffer half. Partial
+// packets are only sent on CDC_flush().
+//
 // 2023 by Stefan Wagner:   https://github.com/wagiminator
 
 #pragma once
@@ -47,7 +56,11 @@ extern "C" {
 // ===================================================================================
 // CDC Parameters
 // ===================================================================================
+#ifndef CDC_PRINT
 #define CDC_PRINT       0         // 1: include print functions (needs print.h)
+#endif
+#define CDC_RX_BUF_SIZE 256       // receive FIFO size in bytes (2^n, >= 128)
+#define CDC_TX_BUF_SIZE 256       // transmit FIFO size in bytes (2^n, >= 64)
 
 // ===================================================================================
 // CDC Functions
@@ -56,7 +69,9 @@ void CDC_init(void);              // setup USB-CDC
 void CDC_flush(void);             // flush OUT buffer
 char CDC_read(void);              // read single character from IN buffer
 void CDC_write(char c);           // write single character to OUT buffer
-uint8_t CDC_available(void);      // check number of bytes in the IN buffer
+uint16_t CDC_readBuffer(uint8_t* buf, uint16_t len);        // read up to len bytes
+void CDC_writeBuffer(const uint8_t* buf, uint16_t len);     // write len bytes
+uint16_t CDC_available(void);     // check number of bytes in the IN buffer
 uint8_t CDC_ready(void);          // check if OUT buffer is ready to be written
 
 #define CDC_writeflush(c)         {CDC_write(c);CDC_flush();}     // write & flush char
@@ -92,14 +107,14 @@ extern CDC_LINE_CODING_TYPE CDC_lineCoding;
 // ===================================================================================
 #if CDC_PRINT == 1
 #include "print.h"
-#define CDC_printD(n)         printD(CDC_write, n)    // print decimal as string
-#define CDC_printW(n)         printW(CDC_write, n)    // print word as string
-#define CDC_printH(n)         printH(CDC_write, n)    // print half-word as string
-#define CDC_printB(n)         printB(CDC_write, n)    // print byte as string
-#define CDC_printS(s)         printS(CDC_write, s)    // print string
+#define CDC_printD(n)         printBufD(CDC_writeBuffer, n) // print decimal as string
+#define CDC_printW(n)         printW(CDC_write, n)          // print word as string
+#define CDC_printH(n)         printH(CDC_write, n)          // print half-word as string
+#define CDC_printB(n)         printB(CDC_write, n)          // print byte as string
+#define CDC_printS(s)         printBufS(CDC_writeBuffer, s) // print string
 #define CDC_println(s)        {println(CDC_write, s); CDC_flush();}
-#define CDC_print             CDC_printS              // alias
-#define CDC_printf(f, ...)    {printF(CDC_write, f, ##__VA_ARGS__); CDC_flush();}
+#define CDC_print             CDC_printS                    // alias
+#define CDC_printf(f, ...)    {printBufF(CDC_writeBuffer, f, ##__VA_ARGS__); CDC_flush();}
 #endif
 
 #ifdef __cplusplus
@@ -34,7 +34,7 @@ extern "C" {
 
 #define EP0_BUF_SIZE    EP_BUF_SIZE(EP0_SIZE)
 #define EP1_BUF_SIZE    EP_BUF_SIZE(EP1_SIZE)
-#define EP2_BUF_SIZE    EP_BUF_SIZE(EP2_SIZE) + 64
+#define EP2_BUF_SIZE    (4 * EP_BUF_SIZE(EP2_SIZE))
 
 #define EP_BUF_SIZE(x)  (x+2<64 ? x+2 : 64)
 
@@ -1,5 +1,5 @@
 // ===================================================================================
-// SSD1306/SH1106/SH1107 I2C OLED Text Functions                              * v1.3 *
+// SSD1306/SH1106/SH1107 I2C OLED Text Functions                              * v1.4 *
 // ===================================================================================
 //
 // Collection of the most necessary functions for controlling an SSD1306/SH1106 I2C 
@@ -357,6 +357,33 @@ void OLED_print(char* str) {
   while(*str) OLED_write(*str++);
 }
 
+// OLED write buffer, consecutive 5x8 characters of one line are sent in one transmission
+void OLED_writeBuffer(const uint8_t* buf, uint16_t len) {
+  while(len) {
+    char c = *buf & 0x7f;                         // ignore top bit
+    #if OLED_BIGCHARS > 0
+    if((c < 32) || OLED_sz || (OLED_x > OLED_WIDTH - 6)) {
+    #else
+    if((c < 32) || (OLED_x > OLED_WIDTH - 6)) {
+    #endif
+      OLED_write(c);                              // control, big or wrapping character
+      buf++; len--;
+      continue;
+    }
+    I2C_start(OLED_ADDR << 1);                    // start transmission to OLED
+    I2C_write(OLED_DAT_MODE);                     // set data mode
+    do {
+      uint16_t ptr = c - 32;                      // character pointer
+      ptr += ptr << 2;                            // -> ptr = (ch - 32) * 5;
+      I2C_write(OLED_i ? 0xff : 0x00);            // write space between characters
+      for(uint8_t i=5; i; i--) I2C_write(OLED_i ? ~OLED_FONT[ptr++] : OLED_FONT[ptr++]);
+      OLED_x += 6;                                // move cursor
+      buf++; len--;
+    } while(len && ((c = *buf & 0x7f) >= 32) && (OLED_x <= OLED_WIDTH - 6));
+    I2C_stop();                                   // stop transmission
+  }
+}
+
 // ===================================================================================
 // OLED Bitmap Functions
 // ===================================================================================
@@ -1,5 +1,5 @@
 // ===================================================================================
-// SSD1306/SH1106/SH1107 I2C OLED Text Functions                              * v1.3 *
+// SSD1306/SH1106/SH1107 I2C OLED Text Functions                              * v1.4 *
 // ===================================================================================
 //
 // Collection of the most necessary functions for controlling an SSD1306/SH1106 I2C 
@@ -21,6 +21,7 @@
 // OLED_textinvert(v)           Invert text (0: inverse off, 1: inverse on)
 // OLED_write(c)                Write character at cursor position or handle control characters
 // OLED_print(str)              Print string (*str) at cursor position
+// OLED_writeBuffer(buf,len)    Write (len) characters from buffer (*buf) at cursor position
 // OLED_printSegment(v,d,l,dp)  Print value (v) at cursor position using defined segment font
 //                              with (d) number of digits, (l) leading (0: '0', 1: space) and 
 //                              decimal point at position (dp) counted from the right
@@ -29,7 +30,7 @@
 //
 // If print functions are activated (see below, print.h must be included):
 // -----------------------------------------------------------------------
-// OLED_printf(f, ...)          printf (supports %s, %c, %d, %u, %x, %b, %02d, %%)
+// OLED_printf(f, ...)          printf (supports %s, %c, %d, %u, %x, %b, %02d, %.2d, %%)
 // OLED_printD(n)               Print decimal value
 // OLED_printW(n)               Print 32-bit hex word value
 // OLED_printH(n)               Print 16-bit hex half-word value
@@ -131,6 +132,7 @@ void OLED_clear(void);              // Clear screen
 void OLED_clearLine(uint8_t y);     // Clear line y
 void OLED_write(char c);            // Write a character or handle control characters
 void OLED_print(char* str);         // Print a string
+void OLED_writeBuffer(const uint8_t* buf, uint16_t len); // Write characters from buffer
 void OLED_cursor(uint8_t x, uint8_t y); // Set cursor
 void OLED_textinvert(uint8_t yes);  // Invert text
 
@@ -151,14 +153,14 @@ extern uint8_t OLED_x, OLED_y;
 // Additional print functions (if activated, see above)
 #if OLED_PRINT == 1
 #include "print.h"
-#define OLED_printD(n)        printD(OLED_write, n)   // print decimal as string
-#define OLED_printW(n)        printW(OLED_write, n)   // print word as string
-#define OLED_printH(n)        printH(OLED_write, n)   // print half-word as string
-#define OLED_printB(n)        printB(OLED_write, n)   // print byte as string
-#define OLED_printS(s)        printS(OLED_write, s)   // print string
-#define OLED_println(s)       println(OLED_write, s)  // print string with newline
-#define OLED_newline()        OLED_write('\n')        // send newline
-#define OLED_printf(f, ...)   printF(OLED_write, f, ##__VA_ARGS__)
+#define OLED_printD(n)        printBufD(OLED_writeBuffer, n) // print decimal as string
+#define OLED_printW(n)        printW(OLED_write, n)          // print word as string
+#define OLED_printH(n)        printH(OLED_write, n)          // print half-word as string
+#define OLED_printB(n)        printB(OLED_write, n)          // print byte as string
+#define OLED_printS(s)        printBufS(OLED_writeBuffer, s) // print string
+#define OLED_println(s)       {printBufS(OLED_writeBuffer, s); OLED_write('\n');}
+#define OLED_newline()        OLED_write('\n')               // send newline
+#define OLED_printf(f, ...)   printBufF(OLED_writeBuffer, f, ##__VA_ARGS__)
 #endif
 
 #ifdef __cplusplus
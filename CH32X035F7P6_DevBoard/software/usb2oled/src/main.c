@@ -59,5 +59,8 @@ int main(void) {
   OLED_print("_\r");
 
   // Loop
-  while(1) OLED_write(CDC_read());        // send incoming characters to OLED
+  while(1) {
+    if(CDC_available()) OLED_write(CDC_read()); // send incoming characters to OLED
+    else OLED_update();                   // send pending changes to OLED
+  }
 }
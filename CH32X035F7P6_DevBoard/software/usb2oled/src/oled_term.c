@@ -1,5 +1,5 @@
 // ===================================================================================
-// SSD1306 128x64 Pixels OLED Terminal Functions                              * v1.1 *
+// SSD1306 128x64 Pixels OLED Terminal Functions                              * v1.3 *
 // ===================================================================================
 //
 // Collection of the most necessary functions for controlling an SSD1306 128x64 pixels
@@ -66,46 +66,176 @@ const uint8_t OLED_INIT_CMD[] = {
   OLED_DISPLAY_ON                         // display on
 };
 
+// OLED line buffer header: scroll offset, page and column are set in the same
+// transaction as the pixel data (control byte 0x80: one command byte follows)
+#define OLED_HDR          11              // header length in bytes
+const uint8_t OLED_HDR_CMD[] = {
+  0x80, OLED_OFFSET, 0x80, 0x00,          // set display offset (scroll)
+  0x80, OLED_PAGE,                        // set page
+  0x80, OLED_COLUMN_LOW,                  // set start column
+  0x80, OLED_COLUMN_HIGH,
+  OLED_DAT_MODE                           // followed by data
+};
+
+// Tick counter for flush timer
+#define OLED_ticks()      (STK->CNTL)
+
+// Wait until line buffer is not in use by DMA anymore
+#ifdef I2C_busy
+  #define OLED_wait(buf)  if((buf) == OLED_sent) while(I2C_busy())
+  #define OLED_busy()     I2C_busy()
+#else
+  #define OLED_wait(buf)
+  #define OLED_busy()     0
+#endif
+
+// Terminal size and parser states
+#define OLED_ROWS         8               // number of text rows
+#define OLED_COLS         21              // number of text columns
+enum {OLED_NORMAL, OLED_ESC, OLED_CSI};
+
 // OLED global variables
-uint8_t line, column, scroll;
+uint8_t line, column, scroll;             // cursor row, cursor column, display offset
+uint8_t OLED_top, OLED_bottom = 7;        // scroll region
+uint8_t OLED_attr;                        // 0x80: reverse video
+uint8_t OLED_saved[2];                    // saved cursor position
+uint8_t OLED_state;                       // escape sequence parser state
+uint8_t OLED_par[2], OLED_npar;           // escape sequence parameters
+uint8_t OLED_text[OLED_ROWS][OLED_COLS];  // characters (bit 7: reverse) for each page
+uint8_t OLED_from[OLED_ROWS];             // first changed column of each page
+uint8_t OLED_to[OLED_ROWS];               // last changed column of each page
+uint8_t OLED_pending;                     // 1: changes are pending
+uint32_t OLED_stamp;                      // time of first pending change
+uint8_t OLED_buf[2][OLED_HDR + 128];      // double line buffer
+uint8_t* OLED_ptr = OLED_buf[0];          // buffer of current transfer
+uint8_t* OLED_sent;                       // buffer of last transfer
 
-// OLED set cursor to line start
-void OLED_setline(uint8_t line) {
-  I2C_start(OLED_ADDR);                   // start transmission to OLED
-  I2C_write(OLED_CMD_MODE);               // set command mode
-  I2C_write(OLED_PAGE + line);            // set line
-  I2C_write(0x00); I2C_write(0x10);       // set column to "0"
-  I2C_stop();                             // stop transmission
+// ===================================================================================
+// Screen Buffer Functions
+// ===================================================================================
+
+// Get page of text row (display offset is used for hardware scrolling)
+#define OLED_page(r)      (((r) + scroll) & 0x07)
+
+// Mark columns c0 to c1 of page p as changed
+void OLED_markPage(uint8_t p, uint8_t c0, uint8_t c1) {
+  if(c0 < OLED_from[p]) OLED_from[p] = c0;
+  if(c1 > OLED_to[p])   OLED_to[p]   = c1;
+  if(!OLED_pending) {
+    OLED_pending = 1;
+    OLED_stamp = OLED_ticks();
+  }
+}
+
+// Erase columns c0 to c1 of text row r
+void OLED_erase(uint8_t r, uint8_t c0, uint8_t c1) {
+  uint8_t p = OLED_page(r);
+  uint8_t* ptr = &OLED_text[p][c0];
+  for(uint8_t i=c0; i<=c1; i++) *ptr++ = ' ';
+  OLED_markPage(p, c0, c1);
 }
 
-// OLED clear line
-void OLED_clearline(uint8_t line) {
+// Copy text of page src to page dst
+void OLED_copyPage(uint8_t dst, uint8_t src) {
+  for(uint8_t i=0; i<OLED_COLS; i++) OLED_text[dst][i] = OLED_text[src][i];
+  OLED_markPage(dst, 0, OLED_COLS - 1);
+}
+
+// Scroll region up by one row. Large regions are scrolled by the display offset
+// register, only the rows outside the region have to be redrawn. Small regions are
+// scrolled by redrawing the rows of the region.
+void OLED_scrollUp(void) {
+  uint8_t r;
+  if(OLED_bottom - OLED_top >= 4) {
+    for(r=OLED_top; r; r--) OLED_copyPage(OLED_page(r), OLED_page(r - 1));
+    for(r=7; r>OLED_bottom; r--) OLED_copyPage(OLED_page(r + 1), OLED_page(r));
+    scroll = (scroll + 1) & 0x07;
+  }
+  else {
+    for(r=OLED_top; r<OLED_bottom; r++) OLED_copyPage(OLED_page(r), OLED_page(r + 1));
+  }
+  OLED_erase(OLED_bottom, 0, OLED_COLS - 1);
+}
+
+// Move cursor down by one row, scroll if cursor is at the bottom of the region
+void OLED_lineFeed(void) {
+  if(line == OLED_bottom) OLED_scrollUp();
+  else if(line < OLED_ROWS - 1) line++;
+}
+
+// ===================================================================================
+// OLED Transfer Functions
+// ===================================================================================
+
+// OLED send changed part of a page in a single transaction
+void OLED_sendPage(uint8_t p) {
   uint8_t i;
-  OLED_setline(line);                     // set cursor to line start
+  uint8_t c0 = OLED_from[p];
+  uint8_t c1 = OLED_to[p];
+  uint8_t x0 = (c0 << 2) + (c0 << 1);     // start column in pixels
+  uint8_t* ptr;
+  OLED_ptr = (OLED_ptr == OLED_buf[0]) ? OLED_buf[1] : OLED_buf[0];
+  OLED_wait(OLED_ptr);                    // wait if buffer is still in use
+  ptr = OLED_ptr;
+  for(i=0; i<OLED_HDR; i++) *ptr++ = OLED_HDR_CMD[i];
+  OLED_ptr[3]  = scroll << 3;             // display offset
+  OLED_ptr[5] |= p;                       // page
+  OLED_ptr[7] |= x0 & 0x0F;               // start column
+  OLED_ptr[9] |= x0 >> 4;
+  for(i=c0; i<=c1; i++) {
+    uint8_t  ch  = OLED_text[p][i];
+    uint8_t  inv = (ch & 0x80) ? 0xFF : 0x00;
+    uint16_t fptr = (ch & 0x7F) - 32;     // character pointer
+    fptr += fptr << 2;                    // -> fptr = (ch - 32) * 5;
+    *ptr++ = inv;                         // write space between characters
+    for(uint8_t j=5; j; j--) *ptr++ = OLED_FONT[fptr++] ^ inv; // write character
+  }
+  if(c1 == OLED_COLS - 1) {
+    *ptr++ = 0x00; *ptr++ = 0x00;         // clear remaining columns of the page
+  }
   I2C_start(OLED_ADDR);                   // start transmission to OLED
-  I2C_write(OLED_DAT_MODE);               // set data mode
-  for(i=128; i; i--) I2C_write(0x00);     // clear the line
-  I2C_stop();                             // stop transmission
+  I2C_writeBuffer(OLED_ptr, ptr - OLED_ptr); // send buffer and stop
+  OLED_sent = OLED_ptr;
+  OLED_from[p] = 0xFF;
+  OLED_to[p]   = 0;
+}
+
+// OLED send all pending changes, one transaction per changed page
+void OLED_flush(void) {
+  if(!OLED_pending) return;
+  OLED_pending = 0;
+  for(uint8_t r=OLED_ROWS; r; r--) {      // bottom row first (scrolled in)
+    uint8_t p = OLED_page(r - 1);
+    if(OLED_from[p] <= OLED_to[p]) OLED_sendPage(p);
+  }
+}
+
+// OLED send pending changes if they are older than OLED_FLUSH_MS
+void OLED_update(void) {
+  if(OLED_pending && ((OLED_ticks() - OLED_stamp) >= OLED_FLUSH_MS * DLY_MS_TIME))
+    OLED_flush();
 }
 
+// ===================================================================================
+// OLED Control Functions
+// ===================================================================================
+
 // OLED clear screen
 void OLED_clear(void) {
-  uint8_t i;
-  for(i=0; i<8; i++) OLED_clearline(i);
-  line = scroll;
+  for(uint8_t r=0; r<OLED_ROWS; r++) OLED_erase(r, 0, OLED_COLS - 1);
+  line = 0;
   column = 0;
-  OLED_setline((line + scroll) & 0x07);
+  OLED_flush();
 }
 
-// OLED clear the top line, then scroll the display up by one line
-void OLED_scrollDisplay(void) {
-  OLED_clearline(scroll);                 // clear line
-  scroll = (scroll + 1) & 0x07;           // set next line
-  I2C_start(OLED_ADDR);                   // start transmission to OLED
-  I2C_write(OLED_CMD_MODE);               // set command mode
-  I2C_write(OLED_OFFSET);                 // set display offset:
-  I2C_write(scroll << 3);                 // scroll up
-  I2C_stop();                             // stop transmission
+// OLED reset terminal
+void OLED_reset(void) {
+  OLED_top    = 0;
+  OLED_bottom = OLED_ROWS - 1;
+  OLED_attr   = 0;
+  OLED_state  = OLED_NORMAL;
+  OLED_saved[0] = 0; OLED_saved[1] = 0;
+  OLED_clear();
 }
 
 // OLED init function
@@ -119,44 +249,146 @@ void OLED_init(void) {
     I2C_write(OLED_INIT_CMD[i]);          // send the command bytes
   I2C_stop();                             // stop transmission
   scroll = 0;                             // start with zero scroll
-  OLED_clear();                           // clear screen
+  for(i=0; i<OLED_ROWS; i++) OLED_from[i] = 0xFF;
+  OLED_reset();                           // reset terminal and clear screen
 }
 
-// OLED plot a single character
-void OLED_plotChar(char c) {
-  uint8_t i;
-  uint16_t ptr = c - 32;                  // character pointer
-  ptr += ptr << 2;                        // -> ptr = (ch - 32) * 5;
-  I2C_start(OLED_ADDR);                   // start transmission to OLED
-  I2C_write(OLED_DAT_MODE);               // set data mode
-  I2C_write(0x00);                        // write space between characters
-  for(i=5; i; i--) I2C_write(OLED_FONT[ptr++]); // write character
-  I2C_stop();                             // stop transmission
+// ===================================================================================
+// OLED Terminal Functions
+// ===================================================================================
+
+// OLED execute escape sequence (CSI)
+void OLED_escape(char c) {
+  uint8_t n  = OLED_par[0];
+  uint8_t r  = line;
+  uint8_t cl = (column < OLED_COLS) ? column : OLED_COLS - 1;
+  if(!n) n = 1;
+  switch(c) {
+    case 'A':                             // cursor up
+      line = (n > line) ? 0 : line - n;
+      column = cl;
+      break;
+    case 'B':                             // cursor down
+      line = (line + n > OLED_ROWS - 1) ? OLED_ROWS - 1 : line + n;
+      column = cl;
+      break;
+    case 'C':                             // cursor forward
+      column = (cl + n > OLED_COLS - 1) ? OLED_COLS - 1 : cl + n;
+      break;
+    case 'D':                             // cursor back
+      column = (n > cl) ? 0 : cl - n;
+      break;
+    case 'H':                             // cursor position (row;column)
+    case 'f':
+      line   = OLED_par[0] ? OLED_par[0] - 1 : 0;
+      column = OLED_par[1] ? OLED_par[1] - 1 : 0;
+      if(line   > OLED_ROWS - 1) line   = OLED_ROWS - 1;
+      if(column > OLED_COLS - 1) column = OLED_COLS - 1;
+      break;
+    case 'J':                             // erase display
+      n = OLED_par[0];
+      if(n != 1) {                        // 0: from cursor to end, 2: all
+        OLED_erase(r, (n == 2) ? 0 : cl, OLED_COLS - 1);
+        for(r++; r<OLED_ROWS; r++) OLED_erase(r, 0, OLED_COLS - 1);
+        r = line;
+      }
+      if(n) {                             // 1: from start to cursor, 2: all
+        OLED_erase(r, 0, (n == 2) ? OLED_COLS - 1 : cl);
+        while(r--) OLED_erase(r, 0, OLED_COLS - 1);
+      }
+      break;
+    case 'K':                             // erase line
+      n = OLED_par[0];
+      OLED_erase(r, n ? 0 : cl, (n == 1) ? cl : OLED_COLS - 1);
+      break;
+    case 'm':                             // select graphic rendition
+      for(r=0; r<=OLED_npar; r++) {
+        if(OLED_par[r] == 7) OLED_attr = 0x80;  // reverse video
+        else if((OLED_par[r] == 0) || (OLED_par[r] == 27)) OLED_attr = 0;
+      }
+      break;
+    case 'r':                             // set scroll region (top;bottom)
+      r = OLED_par[0] ? OLED_par[0] - 1 : 0;
+      n = OLED_par[1] ? OLED_par[1] - 1 : OLED_ROWS - 1;
+      if((r < n) && (n < OLED_ROWS)) {
+        OLED_top = r; OLED_bottom = n;
+        line = 0; column = 0;
+      }
+      break;
+    case 's':                             // save cursor position
+      OLED_saved[0] = line; OLED_saved[1] = column;
+      break;
+    case 'u':                             // restore cursor position
+      line = OLED_saved[0]; column = OLED_saved[1];
+      break;
+    default:
+      break;
+  }
 }
 
-// OLED write a character or handle control characters
+// OLED write a character or handle control characters and escape sequences
 void OLED_write(char c) {
-  c &= 0x7f;                              // ignore top bit
+  c = c & 0x7F;                           // ignore top bit
+
+  // escape sequences
+  if(OLED_state == OLED_ESC) {
+    OLED_state = OLED_NORMAL;
+    if(c == '[') {                        // control sequence introducer
+      OLED_par[0] = 0; OLED_par[1] = 0; OLED_npar = 0;
+      OLED_state = OLED_CSI;
+    }
+    else if(c == 'c') OLED_reset();       // reset terminal
+    else if(c == '7') { OLED_saved[0] = line; OLED_saved[1] = column; }
+    else if(c == '8') { line = OLED_saved[0]; column = OLED_saved[1]; }
+    return;
+  }
+  if(OLED_state == OLED_CSI) {
+    if((c >= '0') && (c <= '9')) {        // parameter digit
+      uint8_t n = OLED_par[OLED_npar];
+      OLED_par[OLED_npar] = (n < 25) ? (n << 3) + (n << 1) + c - '0' : 255;
+    }
+    else if(c == ';') {                   // parameter separator
+      if(OLED_npar < 1) OLED_npar++;
+    }
+    else if(c >= 0x40) {                  // final byte
+      OLED_state = OLED_NORMAL;
+      OLED_escape(c);
+    }
+    else if(c < 0x20) OLED_state = OLED_NORMAL; // abort sequence
+    return;
+  }
+
   // normal character
   if(c >= 32) {
-    OLED_plotChar(c);
-    if(++column > 20) {
+    if(column >= OLED_COLS) {             // wrap if line is full
       column = 0;
-      if(line == 7) OLED_scrollDisplay();
-      else line++;
-      OLED_setline((line + scroll) & 0x07);
+      OLED_lineFeed();
     }
+    uint8_t p = OLED_page(line);
+    OLED_text[p][column] = c | OLED_attr;
+    OLED_markPage(p, column, column);
+    column++;
+    return;
   }
-  // new line
-  else if(c == '\n') {
-    column = 0;
-    if(line == 7) OLED_scrollDisplay();
-    else line++;
-    OLED_setline((line + scroll) & 0x07);
-  }
-  // carriage return
-  else if(c == '\r') {
-    column = 0;
-    OLED_setline((line + scroll) & 0x07);
+
+  // control characters
+  switch(c) {
+    case '\n':                            // new line
+      column = 0;
+      OLED_lineFeed();
+      if(!OLED_busy()) OLED_flush();      // send changes if OLED is idle
+      break;
+    case '\r':                            // carriage return
+      column = 0;
+      break;
+    case '\b':                            // backspace
+      if(column >= OLED_COLS) column = OLED_COLS - 1;
+      if(column) column--;
+      break;
+    case 0x1B:                            // escape
+      OLED_state = OLED_ESC;
+      break;
+    default:
+      break;
   }
 }
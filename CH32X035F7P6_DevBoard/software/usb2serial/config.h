@@ -11,9 +11,17 @@
 // - Connect the board via USB to your PC. It should be detected as a CDC device.
 // - Open a serial monitor and select the correct serial port.
 // - Serial port:  DTR: PA0, RTS: PA1, TXD: PA2, RXD: PA3
+// - In bridge mode, RTS is also released (high) while the serial RX buffer is
+//   filling up, so a sender with hardware flow control pauses. Transfer counters
+//   can be read via a vendor control request, e.g. with pyusb:
+//   dev.ctrl_transfer(0xC0, 0x01, 0, 0, 16)
 
 #pragma once
 
+// Bridge mode
+#define BRIDGE_DMA          1         // 0: byte-wise copy, 1: DMA bridge with block copies
+#define BRIDGE_LATENCY_US   1000      // max time in us received serial data is held back
+
 // Pin definitions
 #define PIN_DTR             PA0       // DTR pin (UART)
 #define PIN_RTS             PA1       // RTS pin (UART)
@@ -30,6 +30,14 @@
 // - Connect the board via USB to your PC. It should be detected as a CDC device.
 // - Open a serial monitor and select the correct serial port.
 // - Serial port:  DTR: PA0, RTS: PA1, TXD: PA2, RXD: PA3
+//
+// In DMA bridge mode (BRIDGE_DMA = 1 in config.h), USART2 TX DMA reads directly
+// from the USB receive FIFO (zero-copy), while USART2 RX DMA buffer blocks are copied
+// into the USB transmit FIFO. Received serial data is sent to the host when a full
+// packet is ready, when the RX line gets idle or after BRIDGE_LATENCY_US. RTS is
+// released while the serial RX buffer is more than 3/4 full and asserted again
+// below 1/4. The BRIDGE_STATS block can be read via a vendor control request
+// (bmRequestType 0xC0, bRequest 0x01) and cleared with bRequest 0x02 (0x40).
 
 
 // ===================================================================================
@@ -41,6 +49,26 @@
 #include "usb_cdc.h"                // USB CDC serial functions
 #include "uart2_dma.h"              // USART2 with DMA functions
 
+// Bridge statistics (read by host via vendor request)
+typedef struct {
+  uint32_t toUART;                  // bytes transferred from USB to serial
+  uint32_t toUSB;                   // bytes transferred from serial to USB
+  uint16_t overruns;                // serial RX buffer overruns (data lost)
+  uint16_t throttles;               // number of times RTS was released
+  uint16_t latency;                 // last serial to USB latency in us
+  uint16_t latencyMax;              // max  serial to USB latency in us
+} BRIDGE_STATS;
+
+#if BRIDGE_DMA > 0
+BRIDGE_STATS stats;
+volatile uint8_t BRIDGE_idle = 0;   // serial RX line got idle
+
+// Serial RX line idle callback
+void BRIDGE_setIdle(void) {
+  BRIDGE_idle = 1;
+}
+#endif
+
 // ===================================================================================
 // Main Function
 // ===================================================================================
@@ -59,19 +87,89 @@ int main(void) {
   CDC_init();                       // init USB CDC
   UART2_init();                     // init UART
 
+  // Setup bridge
+  #if BRIDGE_DMA > 0
+  const uint8_t* txptr;             // start of current USB to serial DMA transfer
+  uint16_t txlen = 0;               // length of current USB to serial DMA transfer
+  const char* rxptr;                // received serial data
+  uint16_t rxlen;
+  uint32_t rxstart = 0;             // time of first received byte not yet flushed
+  uint8_t  pending = 0;             // received serial data waiting for flush
+  uint8_t  throttle = 0;            // RTS released because RX buffer is filling
+  uint8_t  idle;
+  UART2_RX_setCallback(BRIDGE_setIdle);
+  CDC_setStats(&stats, sizeof(stats));
+  #endif
+
   // Loop
   while(1) {
 
     // Handle data transmission
+    #if BRIDGE_DMA > 0
+    // USB to serial: send received USB data directly from the CDC buffer via DMA
+    if(!UART2_TX_busy()) {
+      if(txlen) {
+        CDC_consume(txlen);         // release the bytes just sent
+        stats.toUART += txlen;
+      }
+      CDC_peekSpan(&txptr, &txlen);
+      if(txlen) UART2_writeDMA(txptr, txlen);
+    }
+
+    // Serial to USB: copy DMA RX buffer blocks into the CDC transmit buffer (the IN
+    // endpoint is loaded from there, so this path copies twice and is not zero-copy)
+    idle = BRIDGE_idle;
+    BRIDGE_idle = 0;
+    if(CDC_getDTR()) {
+      UART2_peekSpan(&rxptr, &rxlen);
+      if(rxlen > CDC_free()) rxlen = CDC_free();
+      if(rxlen) {
+        if(!pending) rxstart = STK->CNTL;
+        CDC_writeBuffer((const uint8_t*)rxptr, rxlen);
+        UART2_consume(rxlen);
+        stats.toUSB += rxlen;
+        pending = 1;
+      }
+      if(pending && (idle || ((STK->CNTL - rxstart) >= BRIDGE_LATENCY_US * DLY_US_TIME))) {
+        uint32_t us = (STK->CNTL - rxstart) / DLY_US_TIME;
+        if(us > 0xFFFF) us = 0xFFFF;
+        stats.latency = us;
+        if(us > stats.latencyMax) stats.latencyMax = us;
+        CDC_flush();                // send partial packet to host
+        pending = 0;
+      }
+    }
+
+    // Flow control: release RTS while the serial RX buffer is filling up
+    rxlen = UART2_available();
+    if(!throttle && (rxlen >= UART2_RX_BUF_SIZE * 3 / 4)) {
+      throttle = 1;
+      stats.throttles++;
+    }
+    else if(throttle && (rxlen <= UART2_RX_BUF_SIZE / 4)) throttle = 0;
+
+    // Collect serial RX buffer overruns
+    if(UART2_RX_overruns) {
+      INT_ATOMIC_BLOCK {
+        stats.overruns += UART2_RX_overruns;
+        UART2_RX_overruns = 0;
+      }
+    }
+    #else
     if(CDC_available() && UART2_ready()) UART2_write(CDC_read());
     if(UART2_available() && CDC_getDTR()) {
       while(UART2_available()) CDC_write(UART2_read());
       CDC_flush();
     }
+    #endif
 
     // Handle control line state
     PIN_write(PIN_LED, !CDC_getRTS());
+    #if BRIDGE_DMA > 0
+    PIN_write(PIN_RTS, !CDC_getRTS() || throttle);
+    #else
     PIN_write(PIN_RTS, !CDC_getRTS());
+    #endif
     PIN_write(PIN_DTR, !CDC_getDTR());
 
     // Handle line coding - BAUD rate
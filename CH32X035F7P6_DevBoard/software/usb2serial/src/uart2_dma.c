@@ -1,5 +1,5 @@
 // ===================================================================================
-// USART2 with DMA RX Buffer for CH32X035/X034/X033                           * v1.0 *
+// USART2 with DMA RX Buffer for CH32X035/X034/X033                           * v1.2 *
 // ===================================================================================
 // 2023 by Stefan Wagner:   https://github.com/wagiminator
 
@@ -7,9 +7,35 @@
 
 // Circular RX buffer
 char UART2_RX_buffer[UART2_RX_BUF_SIZE];
-uint8_t UART2_RX_tptr = 0;
+volatile uint16_t UART2_RX_tptr = 0;
 #define UART2_RX_hptr (UART2_RX_BUF_SIZE - DMA1_Channel6->CNTR)
 
+// RX notifications
+#if UART2_RX_NOTIFY > 0
+uint16_t UART2_RX_last;                     // DMA write position at last event
+uint16_t UART2_RX_hcnt;                     // bytes received (free-running, by ISR)
+volatile uint16_t UART2_RX_tcnt;            // bytes read (free-running, by reader)
+volatile uint8_t  UART2_RX_drop;            // 1: overrun, reader drops unread data
+uint16_t UART2_RX_dropPtr, UART2_RX_dropCnt; // read position and count after drop
+volatile uint16_t UART2_RX_overruns;        // number of RX buffer overruns
+void (*UART2_RX_callback)(void);            // idle line callback function
+
+// Drop unread data after an overrun (only the reader writes UART2_RX_tptr)
+static inline void UART2_RX_check(void) {
+  if(UART2_RX_drop) {
+    INT_ATOMIC_BLOCK {
+      UART2_RX_drop = 0;
+      UART2_RX_tptr = UART2_RX_dropPtr;     // continue with data after the overrun
+      UART2_RX_tcnt = UART2_RX_dropCnt;
+    }
+  }
+}
+  #define UART2_RX_count(n) UART2_RX_tcnt += (n)
+#else
+  #define UART2_RX_check()
+  #define UART2_RX_count(n)
+#endif
+
 // ===================================================================================
 // UART2
 // ===================================================================================
@@ -62,7 +88,7 @@ void UART2_init(void) {
   // Setup and start UART (8N1, RX/TX, default BAUD rate)
   RCC->APB1PCENR |= RCC_USART2EN;
   USART2->BRR     = ((2 * F_CPU / UART2_BAUD) + 1) / 2;
-  USART2->CTLR3  |= USART_CTLR3_DMAR;
+  USART2->CTLR3  |= USART_CTLR3_DMAR | USART_CTLR3_DMAT;
   USART2->CTLR1   = USART_CTLR1_RE | USART_CTLR1_TE | USART_CTLR1_UE;
 
   // Setup DMA Channel 6
@@ -72,25 +98,121 @@ void UART2_init(void) {
   DMA1_Channel6->PADDR = (uint32_t)&USART2->DATAR;
   DMA1_Channel6->CFGR  = DMA_CFGR1_MINC       // increment memory address
                        | DMA_CFGR1_CIRC       // circular mode
+                       #if UART2_RX_NOTIFY > 0
+                       | DMA_CFGR1_HTIE       // half transfer interrupt enable
+                       | DMA_CFGR1_TCIE       // transfer complete interrupt enable
+                       #endif
                        | DMA_CFGR1_EN;        // enable
+
+  // Setup RX notifications (idle line and DMA half/full transfer)
+  #if UART2_RX_NOTIFY > 0
+  UART2_RX_tptr = 0; UART2_RX_last = 0; UART2_RX_hcnt = 0; UART2_RX_tcnt = 0;
+  UART2_RX_drop = 0; UART2_RX_overruns = 0; UART2_RX_callback = 0;
+  DMA1->INTFCR   = DMA_CGIF6;                 // clear interrupt flags
+  USART2->CTLR1 |= USART_CTLR1_IDLEIE;        // enable idle line interrupt
+  NVIC_EnableIRQ(DMA1_Channel6_IRQn);         // enable the DMA IRQ
+  NVIC_EnableIRQ(USART2_IRQn);                // enable the USART IRQ
+  #endif
+
+  // Setup DMA Channel 7 (TX)
+  DMA1_Channel7->CNTR  = 0;
+  DMA1_Channel7->PADDR = (uint32_t)&USART2->DATAR;
+  DMA1_Channel7->CFGR  = DMA_CFGR1_MINC       // increment memory address
+                       | DMA_CFGR1_DIR;       // memory to UART
 }
 
-// Check if something is in the RX buffer
-uint8_t UART2_available(void) {
-  return(UART2_RX_hptr != UART2_RX_tptr);
+// Get number of unread bytes in the RX buffer
+uint16_t UART2_available(void) {
+  UART2_RX_check();
+  int16_t len = UART2_RX_hptr - UART2_RX_tptr;
+  if(len < 0) len += UART2_RX_BUF_SIZE;
+  return len;
 }
 
 // Read from UART buffer
 char UART2_read(void) {
   char result;
+  uint16_t tptr;
   while(!UART2_available());
-  result = UART2_RX_buffer[UART2_RX_tptr++];
-  if(UART2_RX_tptr >= UART2_RX_BUF_SIZE) UART2_RX_tptr = 0;
+  tptr = UART2_RX_tptr;
+  result = UART2_RX_buffer[tptr++];
+  if(tptr >= UART2_RX_BUF_SIZE) tptr = 0;
+  UART2_RX_tptr = tptr;
+  UART2_RX_count(1);
   return result;
 }
 
+// Get pointer to and length of contiguous unread data in RX buffer (zero-copy)
+void UART2_peekSpan(const char** ptr, uint16_t* len) {
+  UART2_RX_check();
+  uint16_t hptr = UART2_RX_hptr;
+  uint16_t tptr = UART2_RX_tptr;
+  *ptr = &UART2_RX_buffer[tptr];
+  *len = (hptr >= tptr) ? (hptr - tptr) : (UART2_RX_BUF_SIZE - tptr);
+}
+
+// Mark n bytes in RX buffer as read
+void UART2_consume(uint16_t n) {
+  uint16_t tptr = UART2_RX_tptr + n;
+  if(tptr >= UART2_RX_BUF_SIZE) tptr -= UART2_RX_BUF_SIZE;
+  UART2_RX_tptr = tptr;
+  UART2_RX_count(n);
+}
+
 // Send byte via UART
 void UART2_write(const char c) {
-  while(!UART2_ready());
+  while(UART2_TX_busy() || !UART2_ready());
   USART2->DATAR = c;
 }
+
+// Send buffer via TX DMA
+void UART2_writeDMA(const void* buf, uint16_t len) {
+  while(UART2_TX_busy());                     // wait for previous transfer
+  DMA1_Channel7->CFGR &= ~DMA_CFGR1_EN;       // disable channel
+  DMA1_Channel7->MADDR = (uint32_t)buf;       // set source address
+  DMA1_Channel7->CNTR  = len;                 // set number of bytes
+  DMA1_Channel7->CFGR |=  DMA_CFGR1_EN;       // start transfer
+}
+
+#if UART2_RX_NOTIFY > 0
+
+// Set idle line callback function
+void UART2_RX_setCallback(void (*callback)(void)) {
+  UART2_RX_callback = callback;
+}
+
+// Update DMA write position and check for overrun (called by interrupts)
+// (half/full transfer interrupts keep the bytes received between two events below
+// the buffer size, so the free-running counters give the exact number of unread bytes)
+static void UART2_RX_update(void) {
+  uint16_t hptr  = UART2_RX_hptr;
+  int16_t  delta = hptr - UART2_RX_last;      // bytes received since last event
+  if(delta < 0) delta += UART2_RX_BUF_SIZE;
+  UART2_RX_hcnt += delta;
+  UART2_RX_last  = hptr;
+  if((uint16_t)(UART2_RX_hcnt - UART2_RX_tcnt) >= UART2_RX_BUF_SIZE) { // passed tptr?
+    UART2_RX_overruns++;                      // -> count overrun
+    UART2_RX_dropPtr = hptr;                  // -> reader discards buffer content
+    UART2_RX_dropCnt = UART2_RX_hcnt;
+    UART2_RX_drop    = 1;
+  }
+}
+
+// DMA channel 6 (RX) interrupt service routine (half and full transfer)
+void DMA1_Channel6_IRQHandler(void) __attribute__((interrupt));
+void DMA1_Channel6_IRQHandler(void) {
+  DMA1->INTFCR = DMA_CGIF6;                   // clear interrupt flags
+  UART2_RX_update();
+}
+
+// USART2 interrupt service routine (idle line detected)
+void USART2_IRQHandler(void) __attribute__((interrupt));
+void USART2_IRQHandler(void) {
+  if(USART2->STATR & USART_STATR_IDLE) {
+    (void)USART2->DATAR;                      // clear idle flag
+    UART2_RX_update();
+    if(UART2_RX_callback) UART2_RX_callback(); // line is idle
+  }
+}
+
+#endif
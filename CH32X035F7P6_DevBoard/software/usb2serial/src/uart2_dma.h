@@ -1,5 +1,5 @@
 // ===================================================================================
-// USART2 with DMA RX Buffer for CH32X035/X034/X033                           * v1.0 *
+// USART2 with DMA RX Buffer for CH32X035/X034/X033                           * v1.2 *
 // ===================================================================================
 //
 // Functions available:
@@ -17,6 +17,13 @@
 //
 // UART2_read()             Read character via UART
 // UART2_write(c)           Send character via UART
+// UART2_peekSpan(&p,&l)    Get pointer (p) and length (l) of contiguous unread RX data
+// UART2_consume(n)         Mark n bytes of RX data as read (after UART2_peekSpan)
+// UART2_writeDMA(buf,len)  Send len bytes from buf via TX DMA (returns immediately)
+// UART2_TX_busy()          Check if TX DMA transfer is in progress
+//
+// UART2_RX_setCallback(f)  Set function (f) to be called when the RX line gets idle
+// UART2_RX_overruns        Number of RX buffer overruns (unread data overwritten)
 //
 // UART2_enable()           Enable UART
 // UART2_disable()          Disable UART
@@ -47,6 +54,18 @@
 // CK-pin        PA4   PA23  PA22  PB20  PA22  (*)
 // (*) not used
 //
+// Notes:
+// ------
+// - UART2_available() returns the number of unread bytes in the RX buffer.
+// - If UART2_RX_NOTIFY > 0, the DMA half/full transfer and the idle line interrupts
+//   check the RX buffer for overruns. On an overrun UART2_RX_overruns is incremented
+//   and the next read access discards the unread data. The callback is executed in interrupt
+//   context when the line gets idle after reception.
+// - UART2_peekSpan() gives direct access to the RX buffer. Because the buffer is
+//   circular, call it again after UART2_consume() to get data wrapped to the start.
+// - The buffer passed to UART2_writeDMA() must not be changed until UART2_TX_busy()
+//   returns false.
+//
 // 2023 by Stefan Wagner:   https://github.com/wagiminator
 
 #pragma once
@@ -63,13 +82,19 @@ extern "C" {
 #define UART2_PRINT           0         // 1: include print functions (needs print.h)
 #define UART2_REMAP           0         // UART2 pin remapping (see above)
 #define UART2_BAUD            115200    // default UART2 baud rate
-#define UART2_RX_BUF_SIZE     64        // UART RX buffer size
+#define UART2_RX_BUF_SIZE     512       // UART RX buffer size
+#define UART2_RX_NOTIFY       1         // 1: idle line and DMA interrupts for RX
+
+#if UART2_RX_NOTIFY > 0 && SYS_USE_VECTORS == 0
+  #error Interrupt vector table must be enabled (SYS_USE_VECTORS in system.h)!
+#endif
 
 // ===================================================================================
 // UART2 Macros
 // ===================================================================================
 #define UART2_ready()         (USART2->STATR & USART_STATR_TXE)   // ready to write
 #define UART2_completed()     (USART2->STATR & USART_STATR_TC)    // transmission completed
+#define UART2_TX_busy()       (DMA1_Channel7->CNTR)               // TX DMA in progress
 
 #define UART2_enable()        USART2->CTLR1 |=  USART_CTLR1_UE    // enable USART
 #define UART2_disable()       USART2->CTLR1 &= ~USART_CTLR1_UE    // disable USART
@@ -91,7 +116,15 @@ extern "C" {
 void UART2_init(void);                    // init UART with default BAUD rate
 char UART2_read(void);                    // read character via UART
 void UART2_write(const char c);           // send character via UART
-uint8_t UART2_available(void);            // check if there is something to read
+uint16_t UART2_available(void);           // get number of unread bytes
+void UART2_peekSpan(const char** ptr, uint16_t* len); // get contiguous unread RX data
+void UART2_consume(uint16_t n);           // mark n bytes of RX data as read
+void UART2_writeDMA(const void* buf, uint16_t len);   // send buffer via TX DMA
+
+#if UART2_RX_NOTIFY > 0
+void UART2_RX_setCallback(void (*callback)(void));    // set idle line callback
+extern volatile uint16_t UART2_RX_overruns;
+#endif
 
 // ===================================================================================
 // Additional Print Functions (if activated, see above)
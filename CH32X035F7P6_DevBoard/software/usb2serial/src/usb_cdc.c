@@ -1,5 +1,5 @@
 // ===================================================================================
-// Basic USB CDC Functions for CH32X035/X034/X033                             * v1.0 *
+// Basic USB CDC Functions for CH32X035/X034/X033                             * v1.4 *
 // ===================================================================================
 
 #include "usb_cdc.h"
@@ -17,11 +17,35 @@ CDC_LINE_CODING_TYPE CDC_lineCoding = {
 };
 
 // Variables
-volatile uint8_t CDC_controlLineState = 0;  // control line state
-volatile uint8_t CDC_readByteCount = 0;     // number of data bytes in IN buffer
-volatile uint8_t CDC_readPointer   = 0;     // data pointer for fetching
-volatile uint8_t CDC_writePointer  = 0;     // data pointer for writing
-volatile uint8_t CDC_writeBusyFlag = 0;     // flag of whether upload pointer is busy
+volatile uint8_t  CDC_controlLineState = 0; // control line state
+uint8_t  CDC_RX_buffer[CDC_RX_BUF_SIZE];    // receive FIFO (host to device)
+uint8_t  CDC_TX_buffer[CDC_TX_BUF_SIZE];    // transmit FIFO (device to host)
+volatile uint16_t CDC_RX_hptr = 0;          // RX head pointer (written by EP2 OUT)
+volatile uint16_t CDC_RX_tptr = 0;          // RX tail pointer (read by main code)
+volatile uint16_t CDC_TX_hptr = 0;          // TX head pointer (written by main code)
+volatile uint16_t CDC_TX_tptr = 0;          // TX tail pointer (read by EP2 IN)
+volatile uint8_t  CDC_RX_stalled = 0;       // flag of whether OUT endpoint is NAKed
+volatile uint8_t  CDC_TX_busy    = 0;       // number of packets in IN buffers (0..2)
+volatile uint8_t  CDC_TX_flushed = 0;       // flag of whether partial packets are sent
+
+uint8_t* CDC_statsBlock = 0;                // statistics block for vendor requests
+uint8_t  CDC_statsLen   = 0;                // size of statistics block
+
+// FIFO pointers are free running, the buffer sizes must be a power of 2
+#if (CDC_RX_BUF_SIZE & (CDC_RX_BUF_SIZE - 1)) || (CDC_RX_BUF_SIZE < 2 * EP2_SIZE)
+  #error CDC_RX_BUF_SIZE must be a power of 2 and at least 2 * EP2_SIZE
+#endif
+#if (CDC_TX_BUF_SIZE & (CDC_TX_BUF_SIZE - 1)) || (CDC_TX_BUF_SIZE < EP2_SIZE)
+  #error CDC_TX_BUF_SIZE must be a power of 2 and at least EP2_SIZE
+#endif
+
+#define CDC_RX_level()  ((uint16_t)(CDC_RX_hptr - CDC_RX_tptr))
+#define CDC_TX_level()  ((uint16_t)(CDC_TX_hptr - CDC_TX_tptr))
+
+// EP2 buffer layout in double buffer mode (selected by the data toggle bit):
+// OUT0 (+0), OUT1 (+64), IN0 (+128), IN1 (+192)
+#define CDC_EP_RX(tog)  (EP2_buffer + ((tog) ? EP2_SIZE : 0))
+#define CDC_EP_TX(tog)  (EP2_buffer + ((tog) ? 3 * EP2_SIZE : 2 * EP2_SIZE))
 
 // CDC class requests
 #define SET_LINE_CODING           0x20      // host configures line coding
@@ -38,42 +62,138 @@ void CDC_init(void) {
 }
 
 // Check number of bytes in the IN buffer
-uint8_t CDC_available(void) {
-  return CDC_readByteCount;
+uint16_t CDC_available(void) {
+  return CDC_RX_level();
 }
 
 // Check if OUT buffer is ready to be written
 uint8_t CDC_ready(void) {
-  return(!CDC_writeBusyFlag);
+  return(CDC_TX_level() < CDC_TX_BUF_SIZE);
+}
+
+// Check number of free bytes in the OUT buffer
+uint16_t CDC_free(void) {
+  return(CDC_TX_BUF_SIZE - CDC_TX_level());
+}
+
+// Load packets from TX FIFO into both IN endpoint buffers (interrupts must be disabled)
+// (the toggle bit selects the buffer half in flight, the other half is preloaded;
+// both halves share UEP2_TX_LEN, so only full packets are preloaded)
+static void CDC_TX_send(void) {
+  while(CDC_TX_busy < 2) {
+    uint16_t len = CDC_TX_level();
+    uint16_t ptr = CDC_TX_tptr;
+    uint8_t  tog = (USBFSD->UEP2_CTRL_H & USBFS_UEP_T_TOG) ? 1 : 0;
+    uint8_t* dst;
+    if(len > EP2_SIZE) len = EP2_SIZE;
+    if(!len || ((len < EP2_SIZE) && !CDC_TX_flushed)) return; // no packet to send
+    if(CDC_TX_busy) {                                   // packet in flight?
+      if((len < EP2_SIZE) || (USBFSD->UEP2_TX_LEN < EP2_SIZE)) return;
+      tog ^= 1;                                         // -> preload other half
+    }
+    dst = CDC_EP_TX(tog);
+    USBFSD->UEP2_TX_LEN = len;                          // number of bytes to send
+    while(len--) *dst++ = CDC_TX_buffer[ptr++ & (CDC_TX_BUF_SIZE - 1)];
+    CDC_TX_tptr = ptr;                                  // update tail pointer
+    if(ptr == CDC_TX_hptr) CDC_TX_flushed = 0;          // flush completed
+    if(!CDC_TX_busy++)                                  // endpoint was idle?
+      USBFSD->UEP2_CTRL_H = (USBFSD->UEP2_CTRL_H & ~USBFS_UEP_T_RES_MASK) | USBFS_UEP_T_RES_ACK;
+  }
+}
+
+// Load IN endpoint buffers if one is free and a complete packet is available
+static inline void CDC_TX_kick(void) {
+  if((CDC_TX_busy < 2) && ((CDC_TX_level() >= EP2_SIZE) || CDC_TX_flushed)) {
+    INT_ATOMIC_BLOCK {
+      CDC_TX_send();
+    }
+  }
+}
+
+// Release OUT endpoint if there is enough space in the RX FIFO again
+static inline void CDC_RX_resume(void) {
+  if(CDC_RX_stalled && (CDC_RX_BUF_SIZE - CDC_RX_level() >= 2 * EP2_SIZE)) {
+    INT_ATOMIC_BLOCK {
+      CDC_RX_stalled = 0;
+      USBFSD->UEP2_CTRL_H = (USBFSD->UEP2_CTRL_H & ~USBFS_UEP_R_RES_MASK) | USBFS_UEP_R_RES_ACK;
+    }
+  }
 }
 
 // Flush the OUT buffer
 void CDC_flush(void) {
-  if(!CDC_writeBusyFlag && CDC_writePointer > 0) {      // not busy and buffer not empty?
-    USBFSD->UEP2_TX_LEN = CDC_writePointer;             // number of bytes in OUT buffer
-    USBFSD->UEP2_CTRL_H = (USBFSD->UEP2_CTRL_H & ~USBFS_UEP_T_RES_MASK) | USBFS_UEP_T_RES_ACK;
-    CDC_writeBusyFlag = 1;                              // busy for now
-    CDC_writePointer  = 0;                              // reset write pointer
+  if(CDC_TX_level()) {                                  // buffer not empty?
+    CDC_TX_flushed = 1;                                 // send partial packet, too
+    CDC_TX_kick();                                      // start transfer if idle
   }
 }
 
 // Write single character to OUT buffer
 void CDC_write(char c) {
-  while(CDC_writeBusyFlag);                             // wait for ready to write
-  EP2_buffer[64 + CDC_writePointer++] = c;              // write character
-  if(CDC_writePointer == EP2_SIZE) CDC_flush();         // flush if buffer full
+  while(CDC_TX_level() >= CDC_TX_BUF_SIZE);             // wait for ready to write
+  CDC_TX_buffer[CDC_TX_hptr & (CDC_TX_BUF_SIZE - 1)] = c; // write character
+  CDC_TX_hptr++;                                        // increase head pointer
+  CDC_TX_kick();                                        // send if packet is complete
+}
+
+// Write len bytes to OUT buffer
+void CDC_writeBuffer(const uint8_t* buf, uint16_t len) {
+  uint16_t ptr = CDC_TX_hptr;
+  uint16_t cnt;
+  while(len) {
+    while(CDC_TX_level() >= CDC_TX_BUF_SIZE);           // wait for free space
+    cnt = CDC_TX_BUF_SIZE - CDC_TX_level();             // number of free bytes
+    if(cnt > len) cnt = len;
+    len -= cnt;
+    while(cnt--) CDC_TX_buffer[ptr++ & (CDC_TX_BUF_SIZE - 1)] = *buf++;
+    CDC_TX_hptr = ptr;                                  // update head pointer
+    CDC_TX_kick();                                      // send complete packets
+  }
 }
 
 // Read single character from IN buffer
 char CDC_read(void) {
   char data;
-  while(!CDC_readByteCount);                            // wait for data
-  data = EP2_buffer[CDC_readPointer++];                 // get character
-  if(--CDC_readByteCount == 0)                          // dec number of bytes in buffer
-    USBFSD->UEP2_CTRL_H = (USBFSD->UEP2_CTRL_H & ~USBFS_UEP_R_RES_MASK) | USBFS_UEP_R_RES_ACK;
+  while(!CDC_RX_level());                               // wait for data
+  data = CDC_RX_buffer[CDC_RX_tptr & (CDC_RX_BUF_SIZE - 1)]; // get character
+  CDC_RX_tptr++;                                        // increase tail pointer
+  CDC_RX_resume();                                      // accept packets again
   return data;
 }
 
+// Read up to len bytes from IN buffer, returns number of bytes read
+uint16_t CDC_readBuffer(uint8_t* buf, uint16_t len) {
+  uint16_t ptr = CDC_RX_tptr;
+  uint16_t cnt = CDC_RX_level();
+  if(cnt > len) cnt = len;
+  len = cnt;
+  while(cnt--) *buf++ = CDC_RX_buffer[ptr++ & (CDC_RX_BUF_SIZE - 1)];
+  CDC_RX_tptr = ptr;                                    // update tail pointer
+  CDC_RX_resume();                                      // accept packets again
+  return len;
+}
+
+// Get pointer to and length of contiguous data in IN buffer (zero-copy)
+void CDC_peekSpan(const uint8_t** ptr, uint16_t* len) {
+  uint16_t tptr = CDC_RX_tptr & (CDC_RX_BUF_SIZE - 1);
+  uint16_t cnt  = CDC_RX_level();
+  *ptr = &CDC_RX_buffer[tptr];
+  if(cnt > CDC_RX_BUF_SIZE - tptr) cnt = CDC_RX_BUF_SIZE - tptr;
+  *len = cnt;
+}
+
+// Mark n bytes in IN buffer as read
+void CDC_consume(uint16_t n) {
+  CDC_RX_tptr += n;                                     // increase tail pointer
+  CDC_RX_resume();                                      // accept packets again
+}
+
+// Set statistics block for vendor requests
+void CDC_setStats(void* block, uint8_t len) {
+  CDC_statsBlock = (uint8_t*)block;
+  CDC_statsLen   = len;
+}
+
 // ===================================================================================
 // CDC-Specific USB Handler Functions
 // ===================================================================================
@@ -84,7 +204,8 @@ void CDC_EP_init(void) {
   USBFSD->UEP2_DMA    = (uint32_t)EP2_buffer;   // EP2 data transfer buffer address
   USBFSD->UEP4_1_MOD  = USBFS_UEP1_TX_EN;       // EP1 TX enable
   USBFSD->UEP2_3_MOD  = USBFS_UEP2_RX_EN        // EP2 RX enable
-                      | USBFS_UEP2_TX_EN;       // EP2 TX enable
+                      | USBFS_UEP2_TX_EN        // EP2 TX enable
+                      | USBFS_UEP2_BUF_MOD;     // EP2 double buffer (ping-pong)
   USBFSD->UEP1_CTRL_H = USBFS_UEP_AUTO_TOG      // EP1 Auto flip sync flag
                       | USBFS_UEP_T_RES_NAK;    // EP1 IN transaction returns NAK
   USBFSD->UEP2_CTRL_H = USBFS_UEP_AUTO_TOG      // EP2 Auto flip sync flag
@@ -93,8 +214,13 @@ void CDC_EP_init(void) {
   USBFSD->UEP1_TX_LEN = 0;                      // Nothing to send
   USBFSD->UEP2_TX_LEN = 0;                      // Nothing to send
 
-  CDC_readByteCount   = 0;                      // reset received bytes counter
-  CDC_writeBusyFlag   = 0;                      // reset write busy flag
+  CDC_RX_hptr    = 0;                           // reset RX FIFO
+  CDC_RX_tptr    = 0;
+  CDC_TX_hptr    = 0;                           // reset TX FIFO
+  CDC_TX_tptr    = 0;
+  CDC_RX_stalled = 0;                           // reset OUT stall flag
+  CDC_TX_busy    = 0;                           // reset write busy flag
+  CDC_TX_flushed = 0;                           // reset flush flag
 }
 
 // Handle class setup requests
@@ -115,6 +241,37 @@ uint8_t CDC_control(void) {
   }
 }
 
+// Handle vendor setup requests
+uint8_t CDC_vendor(void) {
+  uint8_t i;
+  switch(USB_SetupReq) {
+    case CDC_VENDOR_GET_STATS:              // 0x01  read statistics block
+      USB_pDescr = CDC_statsBlock;
+      if(USB_SetupLen > CDC_statsLen) USB_SetupLen = CDC_statsLen;
+      i = USB_SetupLen >= EP0_SIZE ? EP0_SIZE : USB_SetupLen;
+      USB_EP0_copyDescr(i);
+      return i;
+    case CDC_VENDOR_CLR_STATS:              // 0x02  clear statistics block
+      for(i=0; i<CDC_statsLen; i++) CDC_statsBlock[i] = 0;
+      return 0;
+    default:
+      return 0xff;                          // command not supported
+  }
+}
+
+// Endpoint 0 VENDOR IN handler (send remaining part of statistics block)
+void CDC_EP0_IN(void) {
+  uint8_t len = USB_SetupLen >= EP0_SIZE ? EP0_SIZE : USB_SetupLen;
+  if(USB_SetupReq != CDC_VENDOR_GET_STATS) {
+    USBFSD->UEP0_CTRL_H = USBFS_UEP_T_RES_NAK | USBFS_UEP_R_TOG | USBFS_UEP_R_RES_ACK;
+    return;
+  }
+  USB_EP0_copyDescr(len);
+  USB_SetupLen -= len;
+  USBFSD->UEP0_TX_LEN = len;
+  USBFSD->UEP0_CTRL_H ^= USBFS_UEP_T_TOG;
+}
+
 // Endpoint 0 CLASS OUT handler
 void CDC_EP0_OUT(void) {
   uint8_t i, len;
@@ -131,17 +288,31 @@ void CDC_EP0_OUT(void) {
 // No handling is actually necessary here, the auto-NAK is sufficient.
 
 // Endpoint 2 IN handler (bulk data transfer to host)
+// The toggle bit has flipped, a preloaded packet in the other half goes out next.
 void CDC_EP2_IN(void) {
-  CDC_writeBusyFlag = 0;                                // clear busy flag
-  USBFSD->UEP2_CTRL_H = (USBFSD->UEP2_CTRL_H & ~USBFS_UEP_T_RES_MASK) | USBFS_UEP_T_RES_NAK;
+  if(CDC_TX_busy) CDC_TX_busy--;                        // one packet sent
+  if(!CDC_TX_busy)                                      // nothing preloaded?
+    USBFSD->UEP2_CTRL_H = (USBFSD->UEP2_CTRL_H & ~USBFS_UEP_T_RES_MASK) | USBFS_UEP_T_RES_NAK;
+  CDC_TX_send();                                        // load next packets if available
 }
 
 // Endpoint 2 OUT handler (bulk data transfer from host)
 void CDC_EP2_OUT(void) {
-  if((USBFSD->INT_FG & USBFS_U_TOG_OK) && USBFSD->RX_LEN) {
-    // respond NAK after a packet. Let main code change response after handling.
-    USBFSD->UEP2_CTRL_H = (USBFSD->UEP2_CTRL_H & ~USBFS_UEP_R_RES_MASK) | USBFS_UEP_R_RES_NAK;
-    CDC_readByteCount   = USBFSD->RX_LEN;             // set number of received data bytes
-    CDC_readPointer     = 0;                          // reset read pointer for fetching
+  uint8_t  len;
+  uint8_t* src;
+  uint16_t ptr;
+  if((USBFSD->INT_FG & USBFS_U_TOG_OK) && (len = USBFSD->RX_LEN)) {
+    // Toggle bit has already flipped, the packet is in the other buffer half.
+    // The endpoint keeps ACKing, so the next packet goes into the free half.
+    src = CDC_EP_RX(!(USBFSD->UEP2_CTRL_H & USBFS_UEP_R_TOG));
+    ptr = CDC_RX_hptr;
+    while(len--) CDC_RX_buffer[ptr++ & (CDC_RX_BUF_SIZE - 1)] = *src++;
+    CDC_RX_hptr = ptr;                                  // update head pointer
+    // respond NAK if there is no space for two more packets (one may be in flight).
+    // Main code changes response after reading from the FIFO.
+    if(CDC_RX_BUF_SIZE - CDC_RX_level() < 2 * EP2_SIZE) {
+      USBFSD->UEP2_CTRL_H = (USBFSD->UEP2_CTRL_H & ~USBFS_UEP_R_RES_MASK) | USBFS_UEP_R_RES_NAK;
+      CDC_RX_stalled = 1;
+    }
   }
 }
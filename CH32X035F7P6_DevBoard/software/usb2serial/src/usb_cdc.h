@@ -1,5 +1,5 @@
 // ===================================================================================
-// Basic USB CDC Functions for CH32X035/X034/X033                             * v1.0 *
+// Basic USB CDC Functions for CH32X035/X034/X033                             * v1.4 *
 // ===================================================================================
 //
 // Functions available:
@@ -10,9 +10,15 @@
 // CDC_flush()              flush transmit buffer
 // CDC_writeflush(c)        write & flush character
 // CDC_newline()            newline and flush
+// CDC_readBuffer(buf,len)  read up to len bytes from receive buffer, returns count
+// CDC_writeBuffer(buf,len) write len bytes to transmit buffer
+// CDC_peekSpan(&p,&l)      get pointer (p) and length (l) of contiguous received data
+// CDC_consume(n)           mark n bytes of received data as read (after CDC_peekSpan)
 //
 // CDC_available()          check number of bytes in the receive buffer
 // CDC_ready()              check if transmit buffer is ready to be written
+// CDC_free()               check number of free bytes in the transmit buffer
+// CDC_setStats(p,len)      set memory block for vendor statistics requests
 //
 // CDC_getDTR()             get DTR flag
 // CDC_getRTS()             get RTS flag
@@ -32,6 +38,19 @@
 // CDC_print(s)             print string (alias)
 // CDC_println(s)           print string with newline and flush
 //
+// Bulk data is transferred via ping-pong endpoint buffers (EP2 in double buffer
+// mode) and a software FIFO in each direction. The EP2 handlers move complete
+// packets between endpoint buffers and FIFOs, so the host can send and fetch
+// back-to-back packets without waiting for the main code. While one IN packet is
+// in flight, the next full packet is preloaded into the other buffer half. Partial
+// packets are only sent on CDC_flush().
+//
+// Vendor control requests give the host access to a statistics block provided
+// by the application via CDC_setStats():
+// - bmRequestType 0xC0, bRequest 0x01 (CDC_VENDOR_GET_STATS): read block
+// - bmRequestType 0x40, bRequest 0x02 (CDC_VENDOR_CLR_STATS): clear block
+// Example with pyusb: dev.ctrl_transfer(0xC0, 0x01, 0, 0, 64)
+//
 // 2023 by Stefan Wagner:   https://github.com/wagiminator
 
 #pragma once
@@ -48,6 +67,8 @@ extern "C" {
 // CDC Parameters
 // ===================================================================================
 #define CDC_PRINT       0         // 1: include print functions (needs print.h)
+#define CDC_RX_BUF_SIZE 512       // receive FIFO size in bytes (2^n, >= 128)
+#define CDC_TX_BUF_SIZE 512       // transmit FIFO size in bytes (2^n, >= 64)
 
 // ===================================================================================
 // CDC Functions
@@ -56,8 +77,17 @@ void CDC_init(void);              // setup USB-CDC
 void CDC_flush(void);             // flush OUT buffer
 char CDC_read(void);              // read single character from IN buffer
 void CDC_write(char c);           // write single character to OUT buffer
-uint8_t CDC_available(void);      // check number of bytes in the IN buffer
+uint16_t CDC_readBuffer(uint8_t* buf, uint16_t len);        // read up to len bytes
+void CDC_writeBuffer(const uint8_t* buf, uint16_t len);     // write len bytes
+void CDC_peekSpan(const uint8_t** ptr, uint16_t* len);      // get contiguous IN data
+void CDC_consume(uint16_t n);     // mark n bytes of IN data as read
+uint16_t CDC_available(void);     // check number of bytes in the IN buffer
 uint8_t CDC_ready(void);          // check if OUT buffer is ready to be written
+uint16_t CDC_free(void);          // check number of free bytes in the OUT buffer
+
+#define CDC_VENDOR_GET_STATS      0x01    // vendor request: read statistics block
+#define CDC_VENDOR_CLR_STATS      0x02    // vendor request: clear statistics block
+void CDC_setStats(void* block, uint8_t len);                // set statistics block
 
 #define CDC_writeflush(c)         {CDC_write(c);CDC_flush();}     // write & flush char
 #define CDC_newline()             {CDC_write('\n'); CDC_flush();} // newline and flush
@@ -25,6 +25,8 @@ extern "C" {
 uint8_t CDC_control(void);
 void CDC_EP_init(void);
 void CDC_EP0_OUT(void);
+uint8_t CDC_vendor(void);
+void CDC_EP0_IN(void);
 void CDC_EP2_IN(void);
 void CDC_EP2_OUT(void);
 
@@ -35,6 +37,8 @@ void CDC_EP2_OUT(void);
 #define USB_INIT_endpoints        CDC_EP_init   // custom USB EP init handler
 #define USB_CLASS_SETUP_handler   CDC_control   // handle custom class requests
 #define USB_CLASS_OUT_handler     CDC_EP0_OUT   // handle class out
+#define USB_VENDOR_SETUP_handler  CDC_vendor    // handle vendor requests
+#define USB_VENDOR_IN_handler     CDC_EP0_IN    // handle vendor in
 
 // Endpoint callback functions
 #define EP0_SETUP_callback        USB_EP0_SETUP